@@ -14,17 +14,20 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
                                100%
 *//*___________________________________________________________________________-*/
 #include "AssetsManager.h"
+#include "AtlasPacker.h"
 #include "stb_image.h"
 #include "fmod.hpp"
 #include "GlobalCoordinator.h"
+#include "GLStateCache.h"
 
+#include <algorithm>
 #include <filesystem>
 
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 
-AssetsManager::AssetsManager() : audSystem(nullptr), m_textureWidth(0), m_textureHeight(0), nrChannels(0), hasAssetsListChanged(false)
+AssetsManager::AssetsManager() : audSystem(nullptr), m_AtlasBuilt(false), m_textureWidth(0), m_textureHeight(0), nrChannels(0), hasAssetsListChanged(false)
 {
     m_AssetList = new std::vector<std::string>();
 }
@@ -44,7 +47,7 @@ void AssetsManager::initialise()
 		m_Audio = new std::map<std::string, FMOD::Sound*>();
 
 	if (!m_Fonts)
-		m_Fonts = new std::map<std::string, std::map<char, Character>>();
+		m_Fonts = new std::map<std::string, FontAtlas>();
 
     if(!m_FontPaths)
 		m_FontPaths = new std::map<std::string, std::string>();
@@ -53,6 +56,7 @@ void AssetsManager::initialise()
     LoadTextureAssets();
     LoadFontAssets();
     LoadAudioAssets();
+    LoadAnimationClips();
 }
 
 void AssetsManager::update(){}
@@ -65,6 +69,7 @@ void AssetsManager::cleanup()
     ClearShaders();
     ClearFonts();
     ClearAudio();
+    ClearAnimationClips();
 
     delete audSystem;
     audSystem = nullptr;
@@ -97,6 +102,8 @@ void AssetsManager::LoadTextureAssets() const {
         std::string textureFilePath = FilePathManager::GetExecutablePath() + "\\" + relativePath;
         assetsManager.LoadTexture(textureName, textureFilePath);
     }
+
+    assetsManager.BuildSpriteAtlas();
 }
 
 void AssetsManager::LoadTexture(const std::string& texName, const std::string& texPath) {
@@ -105,18 +112,17 @@ void AssetsManager::LoadTexture(const std::string& texName, const std::string& t
 		return;
 	}
 
-    //int width, height, nrChannels;
+    //nrChannels keeps the file's channel count, but the pixels are always
+    //expanded to RGBA: grey goes to RGB and a second channel becomes alpha
     stbi_set_flip_vertically_on_load(true);
-    unsigned char* data = stbi_load(texPath.c_str(), &m_textureWidth, &m_textureHeight, &nrChannels, 0);
+    unsigned char* data = stbi_load(texPath.c_str(), &m_textureWidth, &m_textureHeight, &nrChannels, 4);
 
     if (data) {
-        GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-
         // Load texture into OpenGL
         GLuint texID;
         glGenTextures(1, &texID);
-        glBindTexture(GL_TEXTURE_2D, texID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, m_textureWidth, m_textureHeight, 0, format, GL_UNSIGNED_BYTE, data);
+        GLStateCache::BindTexture(texID);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_textureWidth, m_textureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
 
         // Set texture parameters to prevent bleeding
@@ -125,6 +131,14 @@ void AssetsManager::LoadTexture(const std::string& texName, const std::string& t
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST); // Use nearest filtering
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST); // Use nearest filtering
 
+        //Keep a copy of sprites that can share an atlas page until it is built,
+        //sprites loaded after that keep their own texture
+        if (!m_AtlasBuilt && m_textureWidth <= atlasMaxSpriteSize && m_textureHeight <= atlasMaxSpriteSize) {
+            AtlasImage image{ m_textureWidth, m_textureHeight, {} };
+            image.pixels.assign(data, data + static_cast<size_t>(m_textureWidth) * m_textureHeight * 4);
+            m_AtlasImages[texName] = std::move(image);
+        }
+
         stbi_image_free(data);
 
         m_Textures->operator[](texName) = texID;
@@ -152,8 +166,10 @@ GLuint AssetsManager::GetTexture(const std::string& texName) const {
 void AssetsManager::UnloadTexture(const std::string& texName) {
     auto iterator = m_Textures->find(texName);
     if (iterator != m_Textures->end()) {
-		glDeleteTextures(1, &iterator->second);
+		GLStateCache::DeleteTextures(1, &iterator->second);
 		m_Textures->erase(iterator);
+        m_Sprites.erase(texName);
+        m_AtlasImages.erase(texName);
         std::cout << "Texture unloaded successfully!" << std::endl;
 	}
     else {
@@ -162,14 +178,82 @@ void AssetsManager::UnloadTexture(const std::string& texName) {
 }
 
 void AssetsManager::ClearTextures() {
+    ClearSpriteAtlas();
+    m_AtlasImages.clear();
     for (auto& texture : *m_Textures) {
-		glDeleteTextures(1, &texture.second);
+		GLStateCache::DeleteTextures(1, &texture.second);
 	}
 	delete m_Textures;
 	m_Textures = nullptr;
 	std::cout << "All textures cleared!" << std::endl;
 }
 
+//Packs every sprite loaded so far into atlas pages, so sprites drawn with
+//GetSprite share a few textures instead of one each. Sprites that are too
+//large, or loaded after the build, are drawn from their own texture. The
+//pixel copies are freed once they are on the pages
+void AssetsManager::BuildSpriteAtlas() {
+    ClearSpriteAtlas();
+
+    AtlasPacker packer(atlasPageSize, atlasPageSize, atlasPadding);
+    for (const auto& image : m_AtlasImages) {
+        packer.Add(image.first, image.second.width, image.second.height);
+    }
+    packer.Pack();
+
+    std::vector<std::vector<unsigned char>> pages(packer.GetPageCount(),
+        std::vector<unsigned char>(static_cast<size_t>(atlasPageSize) * atlasPageSize * 4, 0));
+
+    for (const auto& rect : packer.GetRects()) {
+        const AtlasImage& image = m_AtlasImages[rect.first];
+        AtlasPacker::Blit(pages[rect.second.page], atlasPageSize, atlasPageSize, image.pixels.data(), rect.second, atlasPadding);
+    }
+
+    for (const auto& page : pages) {
+        GLuint texID;
+        glGenTextures(1, &texID);
+        GLStateCache::BindTexture(texID);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlasPageSize, atlasPageSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, page.data());
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        m_AtlasPages.push_back(texID);
+    }
+    GLStateCache::BindTexture(0);
+
+    float pageSize = static_cast<float>(atlasPageSize);
+    for (const auto& rect : packer.GetRects()) {
+        const AtlasRect& r = rect.second;
+        m_Sprites[rect.first] = { m_AtlasPages[r.page], r.x / pageSize, r.y / pageSize,
+                                  (r.x + r.width) / pageSize, (r.y + r.height) / pageSize };
+    }
+
+    packer.PrintReport(std::cout);
+
+    m_AtlasImages.clear();
+    m_AtlasBuilt = true;
+}
+
+AtlasSprite AssetsManager::GetSprite(const std::string& name) const {
+    auto iterator = m_Sprites.find(name);
+    if (iterator != m_Sprites.end()) {
+        return iterator->second;
+    }
+
+    return { GetTexture(name), 0.f, 0.f, 1.f, 1.f };
+}
+
+void AssetsManager::ClearSpriteAtlas() {
+    if (!m_AtlasPages.empty()) {
+        GLStateCache::DeleteTextures(static_cast<GLsizei>(m_AtlasPages.size()), m_AtlasPages.data());
+    }
+    m_AtlasPages.clear();
+    m_Sprites.clear();
+    m_AtlasBuilt = false;
+}
+
 int AssetsManager::texWidthGet() {
     return m_textureWidth;
 }
@@ -216,6 +300,13 @@ void AssetsManager::LoadShader(const std::string& name, const std::string& fileP
 		return;
     }
     else {
+        auto handle = m_ShaderHandles.find(name);
+        if (handle == m_ShaderHandles.end()) {
+            handle = m_ShaderHandles.emplace(name, static_cast<ShaderHandle>(m_ShaderSlots.size())).first;
+            m_ShaderSlots.push_back(nullptr);
+        }
+        m_ShaderSlots[handle->second] = shader.get();
+
         m_Shaders->operator[](name) = std::move(shader);
         m_AssetList->push_back(name);
         std::cout << "Shader loaded successfully!" << std::endl;
@@ -234,9 +325,28 @@ Shader* AssetsManager::GetShader(const std::string& name) const {
 	}
 }
 
+ShaderHandle AssetsManager::GetShaderHandle(const std::string& name) const {
+    auto iterator = m_ShaderHandles.find(name);
+    if (iterator != m_ShaderHandles.end()) {
+        return iterator->second;
+    }
+    else {
+        std::cerr << "Shader not found!" << std::endl;
+        return invalidShaderHandle;
+    }
+}
+
+Shader* AssetsManager::GetShader(ShaderHandle handle) const {
+    if (handle < 0 || handle >= static_cast<ShaderHandle>(m_ShaderSlots.size())) {
+        return nullptr;
+    }
+    return m_ShaderSlots[handle];
+}
+
 void AssetsManager::UnloadShader(const std::string& name) {
     auto iterator = m_Shaders->find(name);
     if (iterator != m_Shaders->end()) {
+        m_ShaderSlots[m_ShaderHandles[name]] = nullptr;
 		m_Shaders->erase(iterator);
 		std::cout << "Shader unloaded successfully!" << std::endl;
 	}
@@ -246,6 +356,7 @@ void AssetsManager::UnloadShader(const std::string& name) {
 }
 
 void AssetsManager::ClearShaders() {
+    std::fill(m_ShaderSlots.begin(), m_ShaderSlots.end(), nullptr);
 	delete m_Shaders;
 	m_Shaders = nullptr;
 	std::cout << "All shaders cleared!" << std::endl;
@@ -390,60 +501,133 @@ void AssetsManager::LoadFont(const std::string& fontName, const std::string& fon
     }
 
     FT_Set_Pixel_Sizes(face, 0, fontSize);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     bool fontLoaded = true;
-    std::map<char, Character> tempCharacters;
+    FontAtlas font{};
+    std::vector<std::vector<unsigned char>> bitmaps(font.Characters.size());
+    int glyphCount = 0;
+
+    //Rasterise every glyph first, the atlas is sized once all of them are known
+    for (int c = 0; c < static_cast<int>(font.Characters.size()); c++) {
+        //Past ASCII, only keep the characters the font has its own glyph for
+        if (c >= 128 && FT_Get_Char_Index(face, c) == 0) {
+            continue;
+        }
 
-    for (unsigned char c = 0; c < 128; c++) {
         if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
             std::cerr << "ERROR::FREETYPE: Failed to load Glyph for character: " << c << std::endl;
-            fontLoaded = false;
+            if (c < 128) {
+                fontLoaded = false;
+            }
             continue;
         }
 
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        Character& character = font.Characters[c];
+        character.Size = glm::ivec2(bitmap.width, bitmap.rows);
+        character.Bearing = glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top);
+        character.Advance = static_cast<unsigned int>(face->glyph->advance.x);
+        character.Loaded = true;
+        glyphCount++;
+
+        //Rows can be padded, so copy them one at a time
+        std::vector<unsigned char>& pixels = bitmaps[c];
+        pixels.resize(static_cast<size_t>(bitmap.width) * bitmap.rows);
+        for (unsigned int row = 0; row < bitmap.rows; row++) {
+            std::copy_n(bitmap.buffer + row * bitmap.pitch, bitmap.width, pixels.begin() + row * bitmap.width);
+        }
+    }
+    FT_Done_Face(face);
+    FT_Done_FreeType(ft);
 
-        // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    if (!fontLoaded) {
+        std::cerr << "ERROR: Not all glyphs were loaded for font: " << fontPath << std::endl;
+        return;
+    }
 
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            static_cast<unsigned int>(face->glyph->advance.x)
-        };
+    //Start from a small square page and double it until every glyph fits on one
+    AtlasPacker packer(fontAtlasMinSize, fontAtlasMinSize, fontAtlasPadding);
+    for (int pageSize = fontAtlasMinSize; pageSize <= fontAtlasMaxSize; pageSize *= 2) {
+        packer = AtlasPacker(pageSize, pageSize, fontAtlasPadding);
+        for (int c = 0; c < static_cast<int>(font.Characters.size()); c++) {
+            if (!bitmaps[c].empty()) {
+                packer.Add(std::to_string(c), font.Characters[c].Size.x, font.Characters[c].Size.y);
+            }
+        }
+        packer.Pack();
 
-        tempCharacters.insert(std::pair<char, Character>(c, character));
+        AtlasPacker::Report report = packer.GetReport();
+        if (report.pageCount <= 1 && report.rejectedCount == 0) {
+            break;
+        }
     }
 
-    if (fontLoaded) {
-       
-        m_Fonts->operator[](fontName) = std::move(tempCharacters);
-        m_FontPaths->operator[](fontName) = fontPath;
-        m_AssetList->push_back(fontName);
+    AtlasPacker::Report report = packer.GetReport();
+    if (report.pageCount > 1 || report.rejectedCount > 0) {
+        std::cerr << "ERROR: Glyphs of font " << fontPath << " do not fit in a " << fontAtlasMaxSize << " atlas" << std::endl;
+        return;
+    }
+
+    font.AtlasWidth = packer.GetPageWidth();
+    font.AtlasHeight = packer.GetPageHeight();
+
+    //The padding stays empty, glyph bitmaps already fade out at their edges
+    std::vector<unsigned char> page(static_cast<size_t>(font.AtlasWidth) * font.AtlasHeight, 0);
+    for (int c = 0; c < static_cast<int>(font.Characters.size()); c++) {
+        AtlasRect rect;
+        if (bitmaps[c].empty() || !packer.GetRect(std::to_string(c), rect)) {
+            continue;
+        }
+
+        for (int row = 0; row < rect.height; row++) {
+            std::copy_n(bitmaps[c].begin() + row * rect.width, rect.width,
+                page.begin() + (rect.y + row) * font.AtlasWidth + rect.x);
+        }
+
+        Character& character = font.Characters[c];
+        character.UVMin = glm::vec2(static_cast<float>(rect.x) / font.AtlasWidth, static_cast<float>(rect.y) / font.AtlasHeight);
+        character.UVMax = glm::vec2(static_cast<float>(rect.x + rect.width) / font.AtlasWidth, static_cast<float>(rect.y + rect.height) / font.AtlasHeight);
+    }
+
+    glGenTextures(1, &font.AtlasTexture);
+    GLStateCache::BindTexture(font.AtlasTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, font.AtlasWidth, font.AtlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, page.data());
+
+    // Set texture parameters
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    //Sample as white with the coverage in alpha, so the sprite batch tint gives the text colour
+    const GLint swizzle[] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+
+    //Reloading a font replaces its old atlas, and the new version tells text
+    //layouts made with the old glyphs to redo themselves
+    auto existing = m_Fonts->find(fontName);
+    if (existing != m_Fonts->end()) {
+        GLStateCache::DeleteTextures(1, &existing->second.AtlasTexture);
+        font.Version = existing->second.Version + 1;
     }
     else {
-        std::cerr << "ERROR: Not all glyphs were loaded for font: " << fontPath << std::endl;
+        m_AssetList->push_back(fontName);
     }
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-    std::cout << "Font loaded successfully: " << fontPath << " with total glyphs loaded: " << m_Fonts->operator[](fontName).size() << std::endl;
+
+    m_Fonts->operator[](fontName) = font;
+    m_FontPaths->operator[](fontName) = fontPath;
+    std::cout << "Font loaded successfully: " << fontPath << " with total glyphs loaded: " << glyphCount
+        << " in a " << font.AtlasWidth << "x" << font.AtlasHeight << " atlas" << std::endl;
 }
 
-std::map<char, Character> AssetsManager::GetFont(const std::string& fontPath) const {
+const FontAtlas* AssetsManager::GetFont(const std::string& fontPath) const {
 	auto iterator = m_Fonts->find(fontPath);
     if (iterator != m_Fonts->end()) {
-		return iterator->second;
+		return &iterator->second;
 	}
     else {
 		std::cerr << "Font not found!" << std::endl;
-		return std::map<char, Character>();
+		return nullptr;
 	}
 }
 
@@ -461,9 +645,7 @@ std::string AssetsManager::GetFontPath(const std::string& fontName) const {
 void AssetsManager::UnloadFont(const std::string& fontPath) {
 	auto iterator = m_Fonts->find(fontPath);
     if (iterator != m_Fonts->end()) {
-        for (auto& character : iterator->second) {
-			glDeleteTextures(1, &character.second.TextureID);
-		}
+		GLStateCache::DeleteTextures(1, &iterator->second.AtlasTexture);
 		m_Fonts->erase(iterator);
 		std::cout << "Font unloaded successfully!" << std::endl;
 	}
@@ -474,9 +656,7 @@ void AssetsManager::UnloadFont(const std::string& fontPath) {
 
 void AssetsManager::ClearFonts() {
     for (auto& font : *m_Fonts) {
-        for (auto& character : font.second) {
-			glDeleteTextures(1, &character.second.TextureID);
-		}
+		GLStateCache::DeleteTextures(1, &font.second.AtlasTexture);
 	}
     delete m_Fonts;
 	m_Fonts = nullptr;
@@ -486,6 +666,52 @@ void AssetsManager::ClearFonts() {
 }
 
 
+//-----------------------------ANIMATION CLIPS----------------------------------//
+//The sprite sheets of the mossball, goldfish and pump bubbles are 4 x 6 frames
+//and loop through all 24 of them
+void AssetsManager::LoadAnimationClips() {
+    AddAnimationClip(defaultAnimationClip, AnimationClip(4, 6, 0, 24, 0.3f));
+}
+
+//Adding a clip under a name that is already taken replaces it, and entities
+//playing it keep their handle
+AnimationClipHandle AssetsManager::AddAnimationClip(const std::string& name, const AnimationClip& clip) {
+    auto handle = m_AnimationClipHandles.find(name);
+    if (handle != m_AnimationClipHandles.end()) {
+        m_AnimationClips[handle->second] = clip;
+        return handle->second;
+    }
+
+    AnimationClipHandle newHandle = static_cast<AnimationClipHandle>(m_AnimationClips.size());
+    m_AnimationClips.push_back(clip);
+    m_AnimationClipHandles.emplace(name, newHandle);
+    return newHandle;
+}
+
+AnimationClipHandle AssetsManager::GetAnimationClipHandle(const std::string& name) const {
+    auto iterator = m_AnimationClipHandles.find(name);
+    if (iterator != m_AnimationClipHandles.end()) {
+        return iterator->second;
+    }
+    else {
+        std::cerr << "Animation clip not found!" << std::endl;
+        return invalidAnimationClipHandle;
+    }
+}
+
+const AnimationClip* AssetsManager::GetAnimationClip(AnimationClipHandle handle) const {
+    if (handle < 0 || handle >= static_cast<AnimationClipHandle>(m_AnimationClips.size())) {
+        return nullptr;
+    }
+    return &m_AnimationClips[handle];
+}
+
+void AssetsManager::ClearAnimationClips() {
+    std::vector<AnimationClip>().swap(m_AnimationClips);
+    std::map<std::string, AnimationClipHandle>().swap(m_AnimationClipHandles);
+}
+
+
 //-----------------------------ASSET MANAGEMENT----------------------------------//
 void AssetsManager::handleDropFile(std::string filePath) {
     std::filesystem::path path(filePath);
@@ -564,7 +790,7 @@ const std::map<std::string, FMOD::Sound*>& AssetsManager::getAudioList() const {
 	return *m_Audio;
 }
 
-const std::map<std::string, std::map<char, Character>>& AssetsManager::getFontList() const {
+const std::map<std::string, FontAtlas>& AssetsManager::getFontList() const {
 	return *m_Fonts;
 }
 
@@ -5,7 +5,8 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 @course: CSD2401
 @file:   AssetsManager.h
 @brief:  This header file includes all the declaration of the AssetsManager class.
-		 Currently AssetsManager only handles fonts, shaders, textures and audio assets
+		 Currently AssetsManager only handles fonts, shaders, textures and audio assets,
+		 and the animation clips shared by every entity that plays them
 
 		 Joel Chu (c.weiyuan): Declared all the functions in AssetsManager class.
 							   100%
@@ -17,6 +18,8 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include <string>
 #include "fmod.hpp"
 #include "GraphicsSystem.h"
+#include "AtlasSprite.h"
+#include "AnimationData.h"
 
 #include "FontSystem.h"
 
@@ -40,6 +43,11 @@ public:
 	void UnloadTexture(const std::string& name);
 	void ClearTextures();
 
+	//For packing the loaded sprites into atlas pages
+	void BuildSpriteAtlas();
+	AtlasSprite GetSprite(const std::string& name) const;
+	void ClearSpriteAtlas();
+
 	int texWidthGet();
 	int texHeightGet();
 	int nrChannelsGet();
@@ -48,6 +56,9 @@ public:
 	void LoadShaderAssets() const;
 	void LoadShader(const std::string& name, const std::string& filePath);
 	Shader* GetShader(const std::string& name) const;
+	//Look a shader up by name once and keep the handle, a reload reuses it
+	ShaderHandle GetShaderHandle(const std::string& name) const;
+	Shader* GetShader(ShaderHandle handle) const;
 	void UnloadShader(const std::string& name);
 	void ClearShaders();
 
@@ -64,12 +75,21 @@ public:
 	//For loading fonts
 	void LoadFontAssets() const;
 	void LoadFont(const std::string& fontName, const std::string& fontPath, unsigned int fontSize);
-	std::map<char, Character> GetFont(const std::string& fontName) const;
+	const FontAtlas* GetFont(const std::string& fontName) const;
 	std::string GetFontPath(const std::string& fontName) const;
 	void UnloadFont(const std::string& fontPath);
 	void ClearFonts();
 	std::map<std::string, std::string>* m_FontPaths;
-	std::map<std::string, std::map<char, Character>>* m_Fonts;
+	std::map<std::string, FontAtlas>* m_Fonts;
+
+	//For animation clips, shared between entities. Each entity's playback
+	//state is in its AnimationComponent
+	static constexpr const char* defaultAnimationClip = "default";
+	void LoadAnimationClips();
+	AnimationClipHandle AddAnimationClip(const std::string& name, const AnimationClip& clip);
+	AnimationClipHandle GetAnimationClipHandle(const std::string& name) const;
+	const AnimationClip* GetAnimationClip(AnimationClipHandle handle) const;
+	void ClearAnimationClips();
 
 	//For Drag and Drop files from file explorer
 	void handleDropFile(std::string filePath);
@@ -86,7 +106,7 @@ public:
 	const std::map<std::string, GLuint>& getTextureList() const;
 	const std::map<std::string, std::unique_ptr<Shader>>& getShaderList() const;
 	const std::map<std::string, FMOD::Sound*>& getAudioList() const;
-	const std::map<std::string, std::map<char, Character>>& getFontList() const;
+	const std::map<std::string, FontAtlas>& getFontList() const;
 
 
 
@@ -96,9 +116,31 @@ private:
 	std::map<std::string, GLuint>* m_Textures;
 	std::map<std::string, std::unique_ptr<Shader>>* m_Shaders;
 	std::map<std::string, FMOD::Sound*>* m_Audio;
+	std::vector<Shader*> m_ShaderSlots;
+	std::map<std::string, ShaderHandle> m_ShaderHandles;
+	std::vector<AnimationClip> m_AnimationClips;
+	std::map<std::string, AnimationClipHandle> m_AnimationClipHandles;
 
 	std::vector<std::string> *m_AssetList;
 
+	//RGBA pixels of the sprites small enough for the atlas, kept until it is built
+	struct AtlasImage
+	{
+		int width, height;
+		std::vector<unsigned char> pixels;
+	};
+	std::map<std::string, AtlasImage> m_AtlasImages;
+	bool m_AtlasBuilt;
+	std::vector<GLuint> m_AtlasPages;
+	std::map<std::string, AtlasSprite> m_Sprites;
+
+	static constexpr int atlasPageSize = 2048;
+	static constexpr int atlasPadding = 2;
+	static constexpr int atlasMaxSpriteSize = 1024;
+	static constexpr int fontAtlasMinSize = 128;
+	static constexpr int fontAtlasMaxSize = 4096;
+	static constexpr int fontAtlasPadding = 1;
+
 	int m_textureWidth, m_textureHeight, nrChannels;
 
 	bool hasAssetsListChanged;
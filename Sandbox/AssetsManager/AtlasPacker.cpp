@@ -0,0 +1,203 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Joel Chu (c.weiyuan)
+@team:   MonkeHood
+@course: CSD2401
+@file:   AtlasPacker.cpp
+@brief:  This source file includes the implementation of the AtlasPacker class.
+		 Each page keeps a skyline, the top edge of everything placed so far,
+		 and a sprite goes at the lowest point of the skyline it fits on.
+
+		 Joel Chu (c.weiyuan): Implemented the functions of the AtlasPacker class.
+							   100%
+*//*___________________________________________________________________________-*/
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+
+AtlasPacker::AtlasPacker(int pageWidth, int pageHeight, int padding)
+	: m_PageWidth(pageWidth), m_PageHeight(pageHeight), m_Padding(padding), m_Rejected(0) {}
+
+void AtlasPacker::Add(const std::string& name, int width, int height)
+{
+	m_Pending.push_back({ name, width, height });
+}
+
+void AtlasPacker::Pack()
+{
+	m_Pages.clear();
+	m_Rects.clear();
+	m_Rejected = 0;
+
+	std::vector<PendingSprite> sprites = m_Pending;
+	std::sort(sprites.begin(), sprites.end(), [](const PendingSprite& lhs, const PendingSprite& rhs) {
+		if (lhs.height != rhs.height) return lhs.height > rhs.height;
+		if (lhs.width != rhs.width) return lhs.width > rhs.width;
+		return lhs.name < rhs.name;
+	});
+
+	for (const auto& sprite : sprites)
+	{
+		int paddedWidth = sprite.width + m_Padding * 2;
+		int paddedHeight = sprite.height + m_Padding * 2;
+
+		if (paddedWidth > m_PageWidth || paddedHeight > m_PageHeight)
+		{
+			m_Rejected++;
+			continue;
+		}
+
+		//Try the pages already open before starting a new one
+		int page = 0, index = -1, x = 0, y = 0;
+		for (; page < static_cast<int>(m_Pages.size()); page++)
+		{
+			index = findPosition(m_Pages[page], paddedWidth, paddedHeight, x, y);
+			if (index != -1)
+				break;
+		}
+
+		if (index == -1)
+		{
+			m_Pages.push_back({ { 0, 0, m_PageWidth } });
+			page = static_cast<int>(m_Pages.size()) - 1;
+			index = findPosition(m_Pages[page], paddedWidth, paddedHeight, x, y);
+		}
+
+		addLevel(m_Pages[page], index, x, y, paddedWidth, paddedHeight);
+		m_Rects[sprite.name] = { page, x + m_Padding, y + m_Padding, sprite.width, sprite.height };
+	}
+}
+
+bool AtlasPacker::GetRect(const std::string& name, AtlasRect& rect) const
+{
+	auto iterator = m_Rects.find(name);
+	if (iterator == m_Rects.end())
+		return false;
+
+	rect = iterator->second;
+	return true;
+}
+
+AtlasPacker::Report AtlasPacker::GetReport() const
+{
+	Report report{};
+	report.pageCount = GetPageCount();
+	report.packedCount = static_cast<int>(m_Rects.size());
+	report.rejectedCount = m_Rejected;
+
+	for (const auto& rect : m_Rects)
+		report.usedArea += static_cast<uint64_t>(rect.second.width) * rect.second.height;
+
+	report.pageArea = static_cast<uint64_t>(m_PageWidth) * m_PageHeight * report.pageCount;
+	report.efficiency = report.pageArea ? static_cast<float>(report.usedArea) / report.pageArea : 0.f;
+	return report;
+}
+
+void AtlasPacker::PrintReport(std::ostream& os) const
+{
+	Report report = GetReport();
+	os << "Atlas: " << report.packedCount << " sprites on " << report.pageCount << " page(s) of "
+		<< m_PageWidth << "x" << m_PageHeight << ", " << std::fixed << std::setprecision(1)
+		<< report.efficiency * 100.f << "% used";
+	if (report.rejectedCount)
+		os << ", " << report.rejectedCount << " too large for a page";
+	os << std::endl;
+}
+
+void AtlasPacker::Blit(std::vector<unsigned char>& page, int pageWidth, int pageHeight,
+	const unsigned char* pixels, const AtlasRect& rect, int padding)
+{
+	//Rows and columns past the sprite's edge repeat the nearest edge pixel
+	for (int row = -padding; row < rect.height + padding; row++)
+	{
+		int pageY = rect.y + row;
+		if (pageY < 0 || pageY >= pageHeight)
+			continue;
+
+		int sourceY = std::clamp(row, 0, rect.height - 1);
+		for (int column = -padding; column < rect.width + padding; column++)
+		{
+			int pageX = rect.x + column;
+			if (pageX < 0 || pageX >= pageWidth)
+				continue;
+
+			int sourceX = std::clamp(column, 0, rect.width - 1);
+			std::memcpy(&page[(static_cast<size_t>(pageY) * pageWidth + pageX) * 4],
+				&pixels[(static_cast<size_t>(sourceY) * rect.width + sourceX) * 4], 4);
+		}
+	}
+}
+
+int AtlasPacker::findPosition(const std::vector<SkylineNode>& skyline, int width, int height, int& x, int& y) const
+{
+	int bestIndex = -1, bestX = 0, bestY = m_PageHeight;
+
+	for (int i = 0; i < static_cast<int>(skyline.size()); i++)
+	{
+		int left = skyline[i].x;
+		if (left + width > m_PageWidth)
+			break;
+
+		//The box rests on the highest node it spans
+		int top = 0;
+		int widthLeft = width;
+		bool fits = true;
+		for (int j = i; widthLeft > 0; j++)
+		{
+			top = std::max(top, skyline[j].y);
+			if (top + height > m_PageHeight)
+			{
+				fits = false;
+				break;
+			}
+			widthLeft -= skyline[j].width;
+		}
+
+		if (fits && top < bestY)
+		{
+			bestIndex = i;
+			bestX = left;
+			bestY = top;
+		}
+	}
+
+	x = bestX;
+	y = bestY;
+	return bestIndex;
+}
+
+void AtlasPacker::addLevel(std::vector<SkylineNode>& skyline, int index, int x, int y, int width, int height)
+{
+	skyline.insert(skyline.begin() + index, { x, y + height, width });
+
+	//Cut the nodes the new one covers
+	for (size_t i = index + 1; i < skyline.size();)
+	{
+		int coveredTo = skyline[i - 1].x + skyline[i - 1].width;
+		if (skyline[i].x >= coveredTo)
+			break;
+
+		int shrink = coveredTo - skyline[i].x;
+		skyline[i].x += shrink;
+		skyline[i].width -= shrink;
+		if (skyline[i].width > 0)
+			break;
+
+		skyline.erase(skyline.begin() + i);
+	}
+
+	//Join neighbours at the same height
+	for (size_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
@@ -0,0 +1,88 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Joel Chu (c.weiyuan)
+@team:   MonkeHood
+@course: CSD2401
+@file:   AtlasPacker.h
+@brief:  This header file includes the declaration of the AtlasPacker class, which
+		 packs sprite rectangles into fixed size atlas pages with a skyline
+		 bottom left packer. Packing only works on sizes and pixels in memory,
+		 so it does not need OpenGL at all.
+
+		 Joel Chu (c.weiyuan): Declared the AtlasPacker class.
+							   100%
+*//*___________________________________________________________________________-*/
+#pragma once
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Where a sprite was placed, in pixels of its page, padding excluded
+struct AtlasRect
+{
+	int page;
+	int x, y;
+	int width, height;
+};
+
+class AtlasPacker
+{
+public:
+	struct Report
+	{
+		int pageCount;
+		int packedCount;
+		int rejectedCount;		// larger than a page, left out of the atlas
+		uint64_t usedArea;		// pixels covered by sprites
+		uint64_t pageArea;		// pixels of all pages
+		float efficiency;		// usedArea / pageArea
+	};
+
+	AtlasPacker(int pageWidth, int pageHeight, int padding);
+
+	//Queue a sprite for the next Pack
+	void Add(const std::string& name, int width, int height);
+
+	//Place every queued sprite. Taller sprites go first and pages are opened
+	//as needed, so the same input always gives the same layout
+	void Pack();
+
+	bool GetRect(const std::string& name, AtlasRect& rect) const;
+	const std::map<std::string, AtlasRect>& GetRects() const { return m_Rects; }
+
+	int GetPageCount() const { return static_cast<int>(m_Pages.size()); }
+	int GetPageWidth() const { return m_PageWidth; }
+	int GetPageHeight() const { return m_PageHeight; }
+
+	Report GetReport() const;
+	void PrintReport(std::ostream& os) const;
+
+	//Copy RGBA pixels into a page at the rect, repeating the edge pixels into
+	//the padding so filtering never samples a neighbouring sprite
+	static void Blit(std::vector<unsigned char>& page, int pageWidth, int pageHeight,
+		const unsigned char* pixels, const AtlasRect& rect, int padding);
+
+private:
+	struct SkylineNode
+	{
+		int x, y, width;
+	};
+
+	struct PendingSprite
+	{
+		std::string name;
+		int width, height;
+	};
+
+	//Lowest spot on the skyline where a width x height box fits, -1 if none
+	int findPosition(const std::vector<SkylineNode>& skyline, int width, int height, int& x, int& y) const;
+	void addLevel(std::vector<SkylineNode>& skyline, int index, int x, int y, int width, int height);
+
+	int m_PageWidth, m_PageHeight, m_Padding;
+	std::vector<PendingSprite> m_Pending;
+	std::vector<std::vector<SkylineNode>> m_Pages;
+	std::map<std::string, AtlasRect> m_Rects;
+	int m_Rejected;
+};
@@ -0,0 +1,23 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Joel Chu (c.weiyuan)
+@team:   MonkeHood
+@course: CSD2401
+@file:   AtlasSprite.h
+@brief:  This header file includes the declaration of the AtlasSprite struct handed
+		 out by the AssetsManager, kept apart from the AtlasPacker so the packer
+		 builds without OpenGL.
+
+		 Joel Chu (c.weiyuan): Declared AtlasSprite.
+							   100%
+*//*___________________________________________________________________________-*/
+#pragma once
+#include <GL/glew.h>
+
+// A texture and the part of it a sprite uses. Sprites outside any atlas use
+// their own texture with the full 0 to 1 range
+struct AtlasSprite
+{
+	GLuint texture;
+	float u0, v0, u1, v1;
+};
@@ -6,15 +6,26 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 @file:   AnimationComponent.h
 @brief:  This header file includes the Animation Component to be used by ECS
 		 and physics and collision System to handle the logic of the game objects.
+		 It holds the entity's own playback of a shared animation clip.
 
 		 Joel Chu (c.weiyuan): declared the struct component
 							   100%
 *//*___________________________________________________________________________-*/
 #pragma once
+#include "AnimationData.h"
 
 struct AnimationComponent
 {
 	bool isAnimated;
 
-	AnimationComponent() : isAnimated(false) {}
-};
\ No newline at end of file
+	//Playback state, advanced once a frame by AnimationSystemECS. The clip
+	//itself is shared through the assets manager
+	AnimationClipHandle clip;
+	int currentFrame;
+	float timeAccumulator;
+	bool isPlaying;				//whether the entity animates this frame
+	AnimationFrameUV frameUV;	//current frame, handed to the sprite batch
+
+	AnimationComponent() : isAnimated(false), clip(invalidAnimationClipHandle), currentFrame(0),
+		timeAccumulator(0.0f), isPlaying(false), frameUV{ 0.0f, 0.0f, 1.0f, 1.0f } {}
+};
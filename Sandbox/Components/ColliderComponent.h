@@ -0,0 +1,98 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   ColliderComponent.h
+@brief:  This header file includes the Collider Component used by ECS to give an
+		 entity an explicit collision shape. The shape's dimensions are stored
+		 in the component instead of being worked out from the transform scale
+		 on every query; the transform only places and rotates it. Entities
+		 without a collider are treated as the OBB of their transform.
+		 Circles of round sprites can instead follow the transform's width,
+		 so growing or shrinking the sprite resizes its collider with it.
+
+		 Lee Jing Wen (jingwen.lee): declared the struct component
+									 100%
+*//*___________________________________________________________________________-*/
+#pragma once
+#include "vector2D.h"
+#include <cmath>
+
+enum class ColliderShape
+{
+	CIRCLE,
+	OBB,
+	CAPSULE,
+	POLYGON,
+	COUNT
+};
+
+constexpr int MAX_POLYGON_VERTICES = 8;
+
+struct ColliderComponent
+{
+	ColliderShape shape;
+
+	// Local offset from the transform position, rotated with the entity
+	myMath::Vector2D offset;
+
+	// Circle and capsule radius
+	float radius;
+
+	// Circle whose radius is half the transform's width instead of radius
+	bool fitToScale;
+
+	// OBB half width and half height
+	myMath::Vector2D halfExtents;
+
+	// Half the length of the capsule's core segment, along the local y axis
+	float halfLength;
+
+	// Convex polygon in local space, counter clockwise
+	int vertexCount;
+	myMath::Vector2D vertices[MAX_POLYGON_VERTICES];
+
+	ColliderComponent() : shape(ColliderShape::OBB), offset(0.f, 0.f), radius(0.f), fitToScale(false), halfExtents(0.f, 0.f),
+		halfLength(0.f), vertexCount(0) {}
+
+	// Radius of the circle or capsule for an entity of the given scale
+	float GetRadius(const myMath::Vector2D& scale) const
+	{
+		return fitToScale ? std::fabs(scale.GetX()) * 0.5f : radius;
+	}
+
+	static ColliderComponent Circle(float radius)
+	{
+		ColliderComponent collider;
+		collider.shape = ColliderShape::CIRCLE;
+		collider.radius = radius;
+		return collider;
+	}
+
+	// Circle that fits the width of a round sprite, whatever its scale is later
+	static ColliderComponent FittedCircle()
+	{
+		ColliderComponent collider;
+		collider.shape = ColliderShape::CIRCLE;
+		collider.fitToScale = true;
+		return collider;
+	}
+
+	static ColliderComponent Box(const myMath::Vector2D& halfExtents)
+	{
+		ColliderComponent collider;
+		collider.shape = ColliderShape::OBB;
+		collider.halfExtents = halfExtents;
+		return collider;
+	}
+
+	static ColliderComponent Capsule(float radius, float halfLength)
+	{
+		ColliderComponent collider;
+		collider.shape = ColliderShape::CAPSULE;
+		collider.radius = radius;
+		collider.halfLength = halfLength;
+		return collider;
+	}
+};
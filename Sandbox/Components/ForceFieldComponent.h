@@ -0,0 +1,97 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   ForceFieldComponent.h
+@brief:  This header file includes the Force Field Component used by ECS to push
+		 dynamic bodies inside an area, such as the air from a pump. The
+		 physics system evaluates every field each fixed step. Each field
+		 has a mask of the kinds of body it pushes, only the player by
+		 default like the pump did.
+		 Directional fields cover the entity's OBB and push along a direction
+		 that turns with the entity. Radial and vortex fields cover a circle
+		 around the entity; radial fields push away from the center (pull with
+		 a negative strength) and vortex fields push counter clockwise around it.
+
+		 Lee Jing Wen (jingwen.lee): declared the struct component
+									 100%
+*//*___________________________________________________________________________-*/
+#pragma once
+#include "vector2D.h"
+#include <cstdint>
+
+enum class ForceFieldType
+{
+	DIRECTIONAL,
+	RADIAL,
+	VORTEX
+};
+
+// How the strength fades from the field's source to the edge of its area
+enum class ForceFieldFalloff
+{
+	NONE,
+	LINEAR,
+	QUADRATIC
+};
+
+// Kinds of dynamic body a field pushes, combined into a mask
+enum ForceFieldAffects : uint8_t
+{
+	FIELD_AFFECTS_PLAYER = 1 << 0,
+	FIELD_AFFECTS_ENEMY = 1 << 1,
+	FIELD_AFFECTS_OTHER = 1 << 2,	// bodies that are neither
+	FIELD_AFFECTS_ALL = FIELD_AFFECTS_PLAYER | FIELD_AFFECTS_ENEMY | FIELD_AFFECTS_OTHER
+};
+
+struct ForceFieldComponent
+{
+	ForceFieldType type;
+	ForceFieldFalloff falloff;
+
+	// Acceleration at the source, in units per second squared, so heavy and
+	// light bodies are pushed alike
+	float strength;
+
+	// Reach of radial and vortex fields
+	float radius;
+
+	// Push direction of directional fields at 0 degrees, unit length
+	myMath::Vector2D direction;
+
+	bool enabled;
+
+	// ForceFieldAffects flags of the bodies pushed
+	uint8_t affects;
+
+	ForceFieldComponent() : type(ForceFieldType::DIRECTIONAL), falloff(ForceFieldFalloff::NONE), strength(0.f), radius(0.f),
+		direction(0.f, 1.f), enabled(true), affects(FIELD_AFFECTS_PLAYER) {}
+
+	static ForceFieldComponent Directional(float strength, const myMath::Vector2D& direction)
+	{
+		ForceFieldComponent field;
+		field.type = ForceFieldType::DIRECTIONAL;
+		field.strength = strength;
+		field.direction = direction;
+		return field;
+	}
+
+	static ForceFieldComponent Radial(float strength, float radius)
+	{
+		ForceFieldComponent field;
+		field.type = ForceFieldType::RADIAL;
+		field.strength = strength;
+		field.radius = radius;
+		return field;
+	}
+
+	static ForceFieldComponent Vortex(float strength, float radius)
+	{
+		ForceFieldComponent field;
+		field.type = ForceFieldType::VORTEX;
+		field.strength = strength;
+		field.radius = radius;
+		return field;
+	}
+};
@@ -30,9 +30,16 @@ struct PhysicsComponent
 	float targetForce;
 	Force force;
 
+	// Velocity a steered body is pushed towards on every physics step, set by its behaviour
+	myMath::Vector2D desiredVelocity;
+
+	// Sleep state, managed by the physics system per island
+	bool isSleeping;
+	int idleSteps;
+
 	ForceManager forceManager;
 	PhysicsComponent() : velocity(0.0f, 0.0f), gravityScale(0.0f, 0.0f), acceleration(0.0f, 0.0f),
 		accumulatedForce(0.0f, 0.0f), jump(0.0f), dampening(0.0f), mass(1.0f),
 		maxVelocity(0.0f), maxAccumulatedForce(0.0f), prevForce(0.0f), targetForce(0.0f),
-		force(myMath::Vector2D(0.f, 0.f), 0.0f) {}
+		force(myMath::Vector2D(0.f, 0.f), 0.0f), desiredVelocity(0.0f, 0.0f), isSleeping(false), idleSteps(0) {}
 };
\ No newline at end of file
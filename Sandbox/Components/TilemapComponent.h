@@ -0,0 +1,61 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   TilemapComponent.h
+@brief:  This header file includes the Tilemap Component used by ECS to hold a
+		 whole grid of level tiles on one entity. Tiles are stored in square
+		 chunks that are only allocated where the level has tiles, each tile
+		 keeping its tileset index and collision flags. The entity's transform
+		 position is the bottom left corner of tile (0, 0); tilemaps are not
+		 rotated or scaled.
+
+		 Lee Jing Wen (jingwen.lee): declared the struct component
+									 100%
+*//*___________________________________________________________________________-*/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+constexpr int TILEMAP_CHUNK_SIZE = 32;
+constexpr int TILEMAP_CHUNK_TILES = TILEMAP_CHUNK_SIZE * TILEMAP_CHUNK_SIZE;
+
+enum TileFlags : uint8_t
+{
+	TILE_SOLID = 1 << 0
+};
+
+struct TileChunk
+{
+	int chunkX;
+	int chunkY;
+
+	// Tileset index + 1 per tile, row by row from the bottom, 0 is empty
+	uint16_t tiles[TILEMAP_CHUNK_TILES];
+	uint8_t flags[TILEMAP_CHUNK_TILES];
+
+	// Changes whenever a tile in the chunk does, never repeats across chunks
+	uint64_t revision;
+};
+
+struct TilemapComponent
+{
+	float tileSize;
+
+	// Texture in the assets manager, cut into a grid of equally sized tiles
+	std::string tileset;
+	int tilesetColumns;
+	int tilesetRows;
+
+	std::vector<TileChunk> chunks;
+	std::unordered_map<uint64_t, size_t> chunkIndex;
+
+	// Hash of the solid tiles, worked out again only after a tile changes
+	uint64_t collisionHash;
+	bool collisionHashValid;
+
+	TilemapComponent() : tileSize(32.f), tilesetColumns(1), tilesetRows(1), collisionHash(0), collisionHashValid(false) {}
+};
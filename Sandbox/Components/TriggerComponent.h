@@ -0,0 +1,30 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   TriggerComponent.h
+@brief:  This header file includes the Trigger Component used by ECS to mark an
+		 entity as a trigger volume. The physics system tests trigger volumes
+		 against the moving bodies once per frame and sends enter, stay and
+		 exit events to the behaviour of the trigger entity, so behaviours do
+		 not have to poll for collisions themselves.
+
+		 Lee Jing Wen (jingwen.lee): declared the struct component
+									 100%
+*//*___________________________________________________________________________-*/
+#pragma once
+
+enum class TriggerEvent
+{
+	ENTER,
+	STAY,
+	EXIT
+};
+
+struct TriggerComponent
+{
+	bool isTrigger;
+
+	TriggerComponent() : isTrigger(true) {}
+};
@@ -41,6 +41,7 @@ File Contributions: Lew Zong Han Owen (80%)
 #include "GUIHierarchyList.h"
 #include "GUIObjectCreation.h"
 #include "GUIInspector.h"
+#include "GLStateCache.h"
 #include <cmath>
 
 
@@ -134,6 +135,8 @@ void DebugSystem::initialise() {
 
 //Handle rendering of the debug and level editor features
 void DebugSystem::update() {
+	graphicsSystem.EndScene(); //Game scene is done, the editor draws into the window
+
 	if (GLFWFunctions::debug_flag) { //1 key to open imgui GUI
 		mouseWorldPos = GameViewWindow::GetMouseWorldPosition();
 
@@ -174,6 +177,11 @@ void DebugSystem::update() {
 		ImVec2 outerSize = ImVec2(0.0f, ImGui::CalcTextSize("A").x); //To calculate the size of table
 
 		ImGui::Text("FPS: %.1f", GLFWFunctions::fps); //Display FPS
+		GLStateCache::Stats glStats = GLStateCache::GetLastFrameStats();
+		ImGui::Text("GL binds: %u, redundant skipped: %u", glStats.requested - glStats.skipped, glStats.skipped); //Display state changes of the last frame
+		SpriteCuller::Stats cullStats = graphicsSystem.GetSpriteCuller().getStats();
+		ImGui::Text("Sprites in view: %zu of %zu", cullStats.visible, cullStats.indexed); //Display sprites left after culling
+		ImGui::Text("Debug lines: %zu", graphicsSystem.GetDebugDraw().getLastLineCount()); //Display lines in the last debug draw
 
 		ImGui::SeparatorText("Performance Viewer");
 		ImGui::Text("Number of Systems: %d", systemCount);
@@ -41,6 +41,7 @@ File Contributions: Lew Zong Han Owen (60%)
 #include "BackgroundComponent.h"
 #include "PlatformBehaviour.h"
 #include "UIComponent.h"
+#include "AnimationSystemECS.h"
 
 //Variables for GameViewWindow
 int GameViewWindow::viewportHeight;
@@ -107,7 +108,8 @@ void GameViewWindow::Initialise() {
 bool GameViewWindow::isPaused = false;
 //Handle viewport setup, processing and rendering
 void GameViewWindow::Update() {
-	SetupViewportTexture();
+	viewportWidth = GLFWFunctions::windowWidth;
+	viewportHeight = GLFWFunctions::windowHeight;
 
 	aspectSize = GetLargestSizeForViewport();
 	windowSize = ImGui::GetContentRegionAvail();
@@ -441,7 +443,7 @@ void GameViewWindow::Update() {
 		cameraSystem.setCameraZoom(currentZoom);
 	}
 
-	CaptureMainWindow();
+	SizeSceneToViewport();
 
 
 	ImGui::SetCursorPos(renderPos);
@@ -473,38 +475,17 @@ void GameViewWindow::Update() {
 }
 //Clean up resources
 void GameViewWindow::Cleanup() {
-	// Then cleanup viewport texture
-	if (viewportTexture != 0) {
-		glDeleteTextures(1, &viewportTexture);
-		viewportTexture = 0;
-	}
+	// The viewport texture belongs to the graphics system's scene framebuffer
+	viewportTexture = 0;
 }
-//Set up Opengl texture to store game scene
-void GameViewWindow::SetupViewportTexture() {
-		if (viewportTexture != 0) {
-		glDeleteTextures(1, &viewportTexture);
-	}
-
-	glGenTextures(1, &viewportTexture);
-	viewportWidth = GLFWFunctions::windowWidth;
-	viewportHeight = GLFWFunctions::windowHeight;
-	glBindTexture(GL_TEXTURE_2D, viewportTexture);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, GLFWFunctions::windowWidth, GLFWFunctions::windowHeight, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D, 0);
-}
-
-void GameViewWindow::CaptureMainWindow() {
-
-	glBindTexture(GL_TEXTURE_2D, viewportTexture);
-
-	GLint previousBuffer;
-	glGetIntegerv(GL_READ_BUFFER, &previousBuffer);
-
-	glReadBuffer(GL_BACK);
-	glCopyTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 0, 0, GLFWFunctions::windowWidth, GLFWFunctions::windowHeight, 0);
-	glBindTexture(GL_TEXTURE_2D, 0);
+//The game scene is drawn straight into the scene framebuffer's texture, so there is
+//nothing to copy. The texture follows the panel's size from the next frame on, and
+//stays at the window's resolution at most
+void GameViewWindow::SizeSceneToViewport() {
+	int renderWidth = 0, renderHeight = 0;
+	SceneFramebuffer::FitToPanel(aspectSize.x, aspectSize.y, GLFWFunctions::windowWidth, GLFWFunctions::windowHeight, renderWidth, renderHeight);
+	graphicsSystem.GetSceneFramebuffer().setSize(renderWidth, renderHeight);
+	viewportTexture = graphicsSystem.GetSceneFramebuffer().getTexture();
 }
 
 //Function scale real time game scene to the size of the game viewport window
@@ -675,6 +656,7 @@ void GameViewWindow::createDropEntity(const char* assetName, Specifier specifier
 		break;
 	}
 
+	AnimationSystemECS::attachAnimation(dropEntity);
 	ecsCoordinator.setEntityID(dropEntity, assetName);
 }
 
@@ -868,6 +850,91 @@ nlohmann::ordered_json GameViewWindow::AddNewEntityToJSON(TransformComponent& tr
 		entityJSON["collectable"] = { {"isCollectable", collectable.isCollectable} };
 	}
 
+	if (ecs.hasComponent<ColliderComponent>(entity)) {
+		auto& collider = ecs.getComponent<ColliderComponent>(entity);
+		const char* shapeNames[] = { "circle", "obb", "capsule", "polygon" };
+
+		nlohmann::ordered_json colliderJSON{
+			{"shape", shapeNames[static_cast<int>(collider.shape)]},
+			{"offset", {
+				{"x", collider.offset.GetX()},
+				{"y", collider.offset.GetY()}
+			}}
+		};
+
+		switch (collider.shape) {
+		case ColliderShape::CIRCLE:
+			if (collider.fitToScale) {
+				colliderJSON["fitToScale"] = true;
+			}
+			else {
+				colliderJSON["radius"] = collider.radius;
+			}
+			break;
+		case ColliderShape::CAPSULE:
+			colliderJSON["radius"] = collider.radius;
+			colliderJSON["halfLength"] = collider.halfLength;
+			break;
+		case ColliderShape::POLYGON:
+			colliderJSON["vertices"] = nlohmann::ordered_json::array();
+			for (int i = 0; i < collider.vertexCount; i++) {
+				colliderJSON["vertices"].push_back({ {"x", collider.vertices[i].GetX()}, {"y", collider.vertices[i].GetY()} });
+			}
+			break;
+		default:
+			colliderJSON["halfExtents"] = { {"x", collider.halfExtents.GetX()}, {"y", collider.halfExtents.GetY()} };
+			break;
+		}
+
+		entityJSON["collider"] = colliderJSON;
+	}
+
+	if (ecs.hasComponent<ForceFieldComponent>(entity)) {
+		auto& field = ecs.getComponent<ForceFieldComponent>(entity);
+		const char* typeNames[] = { "directional", "radial", "vortex" };
+		const char* falloffNames[] = { "none", "linear", "quadratic" };
+
+		nlohmann::ordered_json affects = nlohmann::ordered_json::array();
+		if (field.affects & FIELD_AFFECTS_PLAYER) affects.push_back("player");
+		if (field.affects & FIELD_AFFECTS_ENEMY) affects.push_back("enemy");
+		if (field.affects & FIELD_AFFECTS_OTHER) affects.push_back("other");
+
+		entityJSON["forceField"] = nlohmann::ordered_json{
+			{"type", typeNames[static_cast<int>(field.type)]},
+			{"falloff", falloffNames[static_cast<int>(field.falloff)]},
+			{"strength", field.strength},
+			{"radius", field.radius},
+			{"direction", {
+				{"x", field.direction.GetX()},
+				{"y", field.direction.GetY()}
+			}},
+			{"affects", affects}
+		};
+	}
+
+	if (ecs.hasComponent<TilemapComponent>(entity)) {
+		auto& tilemap = ecs.getComponent<TilemapComponent>(entity);
+
+		nlohmann::ordered_json tilemapJSON{
+			{"tileSize", tilemap.tileSize},
+			{"tileset", tilemap.tileset},
+			{"tilesetColumns", tilemap.tilesetColumns},
+			{"tilesetRows", tilemap.tilesetRows},
+			{"chunks", nlohmann::ordered_json::array()}
+		};
+
+		for (const auto& chunk : tilemap.chunks) {
+			tilemapJSON["chunks"].push_back({
+				{"x", chunk.chunkX},
+				{"y", chunk.chunkY},
+				{"tiles", std::vector<uint16_t>(std::begin(chunk.tiles), std::end(chunk.tiles))},
+				{"flags", std::vector<uint8_t>(std::begin(chunk.flags), std::end(chunk.flags))}
+			});
+		}
+
+		entityJSON["tilemap"] = tilemapJSON;
+	}
+
 	if (ecs.hasComponent<UIComponent>(entity)) {
 		auto& UI = ecs.getComponent<UIComponent>(entity);
 		UI.isUI = true;
@@ -104,9 +104,7 @@ public:
 
 	static ImVec2 GetCenteredPosForViewport(ImVec2 size); //Center viewport within available space
 
-	static void SetupViewportTexture(); //Set up Opengl texture to store game scene
-
-	static void CaptureMainWindow(); //Capture rendered game scene
+	static void SizeSceneToViewport(); //Size the texture the game scene is drawn into to the viewport
 
 private:
 	static int saveNum;
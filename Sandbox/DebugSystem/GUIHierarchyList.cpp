@@ -13,6 +13,7 @@ File Contributions: Lew Zong Han Owen (100%)
 
 /*_______________________________________________________________________________________________________________*/
 #include "GUIHierarchyList.h"
+#include "PhyColliSystemECS.h"
 
 float HierarchyList::objAttributeSliderMaxLength;
 char HierarchyList::textBuffer[MAXTEXTSIZE];
@@ -133,6 +134,7 @@ void HierarchyList::Update() {
 			{ //Remaining object's data modification features
 				auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
 				auto signature = ecsCoordinator.getEntityID(entity);
+				bool transformEdited = false;
 
 				ImGui::PushID(entity);
 
@@ -142,17 +144,25 @@ void HierarchyList::Update() {
 					if (ImGui::DragFloat2("Position", pos, 5.f)) {
 						transform.position.SetX(pos[0]);
 						transform.position.SetY(pos[1]);
+						transformEdited = true;
 					}
 
 					float scale[2] = { transform.scale.GetX(), transform.scale.GetY() };
 					if (ImGui::DragFloat2("Scale", scale, 1.f)) {
 						transform.scale.SetX(scale[0]);
 						transform.scale.SetY(scale[1]);
+						transformEdited = true;
 					}
 
 					float rotation[1] = { transform.orientation.GetX() };
 					if (ImGui::DragFloat("Rotation", rotation, 1.f)) {
 						transform.orientation.SetX(rotation[0]);
+						transformEdited = true;
+					}
+
+					//Platforms and tilemaps are baked into the static collision
+					if (transformEdited) {
+						ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->NotifyTransformEdited(entity);
 					}
 
 					if (ImGui::Button("Remove")) {
@@ -25,10 +25,12 @@ File Contributions: Lew Zong Han Owen (100%)
 #include "EffectPumpBehaviour.h"
 #include "ExitBehaviour.h"
 #include "PlatformBehaviour.h"
+#include "PhyColliSystemECS.h"
 #include <memory>
 
 std::vector<std::pair<int, std::string>>* Inspector::overlappingEntities;
 float Inspector::objAttributeSliderMaxLength;
+float Inspector::screenPickMargin = 500.f;
 char Inspector::textBuffer[MAXTEXTSIZE];
 ImVec2 Inspector::mouseWorldPos;
 glm::mat4 projectionMatrix(1.0f);
@@ -158,12 +160,30 @@ void Inspector::Update() {
 		overlappingEntities->clear();
 
 		// Get all entities and check for collision
-		for (auto entity : ecsCoordinator.getAllLiveEntities()) {
+		// Only look at entities near the cursor. Game objects are picked in world
+		// space by their OBB; buttons, UI and text are kept in the screen grid and
+		// picked with their own padded boxes, so a wider region around the cursor
+		// is searched
+		auto physicsSystem = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
+
+		std::vector<Entity> worldCandidates;
+		physicsSystem->QueryPoint(myMath::Vector2D(mouseWorldPos.x, mouseWorldPos.y), worldCandidates);
+
+		myMath::Vector2D cursor(centeredMouse.x, centeredMouse.y);
+		myMath::Vector2D margin(screenPickMargin, screenPickMargin);
+		std::vector<Entity> screenCandidates;
+		physicsSystem->QueryScreenRegion(cursor - margin, cursor + margin, screenCandidates);
+
+		for (auto entity : worldCandidates) {
 			if (ecsCoordinator.getEntityID(entity) != "placeholderentity") {
-				float distSq;
-				if (isMouseOverEntity(entity, distSq)) {
-					overlappingEntities->push_back({ entity, ecsCoordinator.getEntityID(entity) });
-				}
+				overlappingEntities->push_back({ entity, ecsCoordinator.getEntityID(entity) });
+			}
+		}
+
+		for (auto entity : screenCandidates) {
+			float distSq;
+			if (isMouseOverEntity(entity, distSq)) {
+				overlappingEntities->push_back({ entity, ecsCoordinator.getEntityID(entity) });
 			}
 		}
 
@@ -226,6 +246,7 @@ void Inspector::Update() {
 				transform.position.SetX(mouseWorldPos.x);
 				transform.position.SetY(mouseWorldPos.y);
 			}
+			ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->NotifyTransformEdited(draggedEntityID);
 		}
 		else if (!ImGui::IsMouseDown(ImGuiMouseButton_Left)) {
 			initiatedByDoubleClick = false;
@@ -281,7 +302,7 @@ void Inspector::Update() {
 					transform.scale.SetY(newScaleY);
 				}
 			}
-			
+			ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->NotifyTransformEdited(selectedEntityID);
 		}
 	}
 
@@ -442,6 +463,7 @@ void Inspector::RenderInspectorWindow(ECSCoordinator& ecs, int selectedEntityID)
 		{ //Remaining object's data modification features
 			auto& transform = ecsCoordinator.getComponent<TransformComponent>(selectedEntityID);
 			auto signature = ecsCoordinator.getEntityID(selectedEntityID);
+			bool transformEdited = false;
 
 			ImGui::PushID(selectedEntityID);
 
@@ -450,17 +472,25 @@ void Inspector::RenderInspectorWindow(ECSCoordinator& ecs, int selectedEntityID)
 			if (ImGui::DragFloat2("Position", pos, 5.f)) {
 				transform.position.SetX(pos[0]);
 				transform.position.SetY(pos[1]);
+				transformEdited = true;
 			}
 
 			float scale[2] = { transform.scale.GetX(), transform.scale.GetY() };
 			if (ImGui::DragFloat2("Scale", scale, 1.f)) {
 				transform.scale.SetX(scale[0]);
 				transform.scale.SetY(scale[1]);
+				transformEdited = true;
 			}
 
 			float rotation[1] = { transform.orientation.GetX() };
 			if (ImGui::DragFloat("Rotation", rotation, 1.f)) {
 				transform.orientation.SetX(rotation[0]);
+				transformEdited = true;
+			}
+
+			//Platforms and tilemaps are baked into the static collision
+			if (transformEdited) {
+				ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->NotifyTransformEdited(selectedEntityID);
 			}
 
 			if (ImGui::Button("Remove")) {
@@ -637,6 +667,7 @@ void Inspector::LoadInspectorFromJSON(std::string const& filename)
 
 	serializer.ReadCharArray(textBuffer, MAXTEXTSIZE, "Inspector.textBuffer");
 	serializer.ReadFloat(objAttributeSliderMaxLength, "Inspector.objAttributeSliderMaxLength");
+	serializer.ReadFloat(screenPickMargin, "Inspector.screenPickMargin");
 }
 
 void Inspector::Cleanup() {
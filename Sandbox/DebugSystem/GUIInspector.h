@@ -43,6 +43,7 @@ public:
 	static void LoadInspectorFromJSON(std::string const& filename);
 private:
 	static float objAttributeSliderMaxLength;
+	static float screenPickMargin;		// reach around the cursor searched for buttons and text
 	static char textBuffer[MAXTEXTSIZE];
 	static ImVec2 mouseWorldPos;
 	static std::vector<std::pair<int, std::string>>* overlappingEntities;
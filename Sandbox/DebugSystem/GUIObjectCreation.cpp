@@ -20,9 +20,11 @@ File Contributions: Lew Zong Han Owen (100%)
 #include "EnemyBehaviour.h"
 #include "CollectableBehaviour.h"
 #include "EffectPumpBehaviour.h"
+#include "PhyColliSystemECS.h"
 #include "ExitBehaviour.h"
 #include "BehaviourComponent.h"
 #include "BackgroundComponent.h"
+#include "AnimationSystemECS.h"
 
 int ObjectCreation::objCount;
 float ObjectCreation::objAttributeSliderMaxLength;
@@ -184,6 +186,7 @@ void ObjectCreation::Update() {
 				ecsCoordinator.addComponent(entityObj, transform);
 				ecsCoordinator.setEntityID(entityObj, entityId);
 				ObjectCreationCondition(items, currentItem, entityObj, entityId);
+				AnimationSystemECS::attachAnimation(entityObj);
 				DebugSystem::newEntities->push_back(entityObj);
 			}
 		}
@@ -221,6 +224,7 @@ void ObjectCreation::Update() {
 			ecsCoordinator.setEntityID(entityObj, entityId);
 
 			ObjectCreationCondition(items, currentItem, entityObj, entityId);
+			AnimationSystemECS::attachAnimation(entityObj);
 			DebugSystem::newEntities->push_back(entityObj);
 
 
@@ -380,6 +384,7 @@ void ObjectCreation::ObjectCreationCondition(const char* items[], int itemIndex,
 
 		ecsCoordinator.addComponent(entityObj, closestPlatform);
 		ecsCoordinator.addComponent(entityObj, pump);
+		ecsCoordinator.addComponent(entityObj, ForceFieldComponent::Directional(pump.pumpForce / PhysicsSystemECS::GetFixedDeltaTime(), myMath::Vector2D(0.f, 1.f)));
 		ecsCoordinator.addComponent(entityObj, behaviour);
 
 	}
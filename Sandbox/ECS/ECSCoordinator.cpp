@@ -19,6 +19,7 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "ECSCoordinator.h"
 
 #include "GraphicSystemECS.h"
+#include "AnimationSystemECS.h"
 #include "PhyColliSystemECS.h"
 #include "LogicSystemECS.h"
 #include "FontSystemECS.h"
@@ -34,6 +35,7 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "BackgroundComponent.h"
 #include "UIComponent.h"
 #include "PlatformBehaviour.h"
+#include "Tilemap.h"
 
 #include <Windows.h>
 
@@ -97,6 +99,9 @@ Entity ECSCoordinator::createEntity()
 void ECSCoordinator::destroyEntity(Entity entity)
 {	
 
+	//tilemap chunk meshes are kept by entity, free them before the id is reused
+	graphicsSystem.ReleaseTilemapMeshes(entity);
+
 	//remove entity from all systems
 	entityManager->destroyEntity(entity);
 	componentManager->entityRemoved(entity);
@@ -104,6 +109,28 @@ void ECSCoordinator::destroyEntity(Entity entity)
 
 }
 
+namespace
+{
+	// a stored chunk needs integer coordinates and a full set of tiles and flags,
+	// anything else is skipped instead of throwing out of the scene load
+	bool isValidTileChunk(const nlohmann::json& chunkData)
+	{
+		if (!chunkData.is_object()) return false;
+		if (!chunkData.contains("x") || !chunkData["x"].is_number_integer()) return false;
+		if (!chunkData.contains("y") || !chunkData["y"].is_number_integer()) return false;
+
+		for (const char* key : { "tiles", "flags" })
+		{
+			if (!chunkData.contains(key) || !chunkData[key].is_array() || chunkData[key].size() != TILEMAP_CHUNK_TILES) return false;
+			for (const auto& value : chunkData[key])
+			{
+				if (!value.is_number_unsigned()) return false;
+			}
+		}
+		return true;
+	}
+}
+
 // this is the definition of the function that loads the data from JSON file to the entity
 // open the JSON file and initialize the entity data based on the values read
 void ECSCoordinator::LoadEntityFromJSON(ECSCoordinator& ecs, std::string const& filename)
@@ -344,9 +371,129 @@ void ECSCoordinator::LoadEntityFromJSON(ECSCoordinator& ecs, std::string const&
 			ecs.addComponent(entityObj, behaviour);
 		}
 
+		// collision shape, only the fields of the chosen shape need to be present
+		if (entityData.contains("collider"))
+		{
+			const nlohmann::json& colliderData = entityData["collider"];
+			ColliderComponent collider{};
+			std::string shape = colliderData.value("shape", std::string("obb"));
+
+			if (shape == "circle") collider.shape = ColliderShape::CIRCLE;
+			else if (shape == "capsule") collider.shape = ColliderShape::CAPSULE;
+			else if (shape == "polygon") collider.shape = ColliderShape::POLYGON;
+			else collider.shape = ColliderShape::OBB;
+
+			if (colliderData.contains("offset")) serializer.ReadObject(collider.offset, entityId, "entities.collider.offset");
+			if (colliderData.contains("radius")) serializer.ReadObject(collider.radius, entityId, "entities.collider.radius");
+			if (colliderData.contains("fitToScale")) serializer.ReadObject(collider.fitToScale, entityId, "entities.collider.fitToScale");
+			if (colliderData.contains("halfExtents")) serializer.ReadObject(collider.halfExtents, entityId, "entities.collider.halfExtents");
+			if (colliderData.contains("halfLength")) serializer.ReadObject(collider.halfLength, entityId, "entities.collider.halfLength");
+
+			if (colliderData.contains("vertices"))
+			{
+				for (const auto& vertex : colliderData["vertices"])
+				{
+					if (collider.vertexCount == MAX_POLYGON_VERTICES)
+					{
+						std::cout << "Warning: " << entityId << " has more than " << MAX_POLYGON_VERTICES << " collider vertices" << std::endl;
+						break;
+					}
+					collider.vertices[collider.vertexCount++] = myMath::Vector2D(vertex["x"].get<float>(), vertex["y"].get<float>());
+				}
+			}
+
+			ecs.addComponent(entityObj, collider);
+		}
+		else if (entityData.contains("player") || entityData.contains("enemy") || entityData.contains("collectable"))
+		{
+			// round sprites collide as the circle that fits their width, and
+			// keep fitting it when they are scaled later
+			ecs.addComponent(entityObj, ColliderComponent::FittedCircle());
+		}
+
+		// area that pushes dynamic bodies, pumps without one blow along their up axis
+		if (entityData.contains("forceField"))
+		{
+			const nlohmann::json& fieldData = entityData["forceField"];
+			ForceFieldComponent field{};
+			std::string type = fieldData.value("type", std::string("directional"));
+			std::string falloff = fieldData.value("falloff", std::string("none"));
+
+			if (type == "radial") field.type = ForceFieldType::RADIAL;
+			else if (type == "vortex") field.type = ForceFieldType::VORTEX;
+			else field.type = ForceFieldType::DIRECTIONAL;
+
+			if (falloff == "linear") field.falloff = ForceFieldFalloff::LINEAR;
+			else if (falloff == "quadratic") field.falloff = ForceFieldFalloff::QUADRATIC;
+			else field.falloff = ForceFieldFalloff::NONE;
+
+			field.strength = fieldData.value("strength", field.strength);
+			field.radius = fieldData.value("radius", field.radius);
+			if (fieldData.contains("direction")) serializer.ReadObject(field.direction, entityId, "entities.forceField.direction");
+
+			// kinds of body pushed, only the player when not listed
+			if (fieldData.contains("affects") && fieldData["affects"].is_array())
+			{
+				field.affects = 0;
+				for (const auto& kind : fieldData["affects"])
+				{
+					std::string name = kind.is_string() ? kind.get<std::string>() : std::string{};
+					if (name == "player") field.affects |= FIELD_AFFECTS_PLAYER;
+					else if (name == "enemy") field.affects |= FIELD_AFFECTS_ENEMY;
+					else if (name == "other") field.affects |= FIELD_AFFECTS_OTHER;
+				}
+			}
+
+			ecs.addComponent(entityObj, field);
+		}
+		else if (entityData.contains("pump"))
+		{
+			// pumpForce was the push given every fixed step
+			float pumpForce = ecs.getComponent<PumpComponent>(entityObj).pumpForce;
+			ecs.addComponent(entityObj, ForceFieldComponent::Directional(pumpForce / PhysicsSystemECS::GetFixedDeltaTime(), myMath::Vector2D(0.f, 1.f)));
+		}
+
+		// tile grid, only the chunks that have tiles are stored
+		if (entityData.contains("tilemap"))
+		{
+			const nlohmann::json& tilemapData = entityData["tilemap"];
+			TilemapComponent tilemap{};
+			tilemap.tileSize = tilemapData.value("tileSize", tilemap.tileSize);
+			tilemap.tileset = tilemapData.value("tileset", std::string{});
+			tilemap.tilesetColumns = tilemapData.value("tilesetColumns", tilemap.tilesetColumns);
+			tilemap.tilesetRows = tilemapData.value("tilesetRows", tilemap.tilesetRows);
+
+			for (const auto& chunkData : tilemapData.value("chunks", nlohmann::json::array()))
+			{
+				if (!isValidTileChunk(chunkData))
+				{
+					std::cout << "Warning: " << entityId << " has a malformed tilemap chunk, it needs x, y and "
+						<< TILEMAP_CHUNK_TILES << " tiles and flags" << std::endl;
+					continue;
+				}
+
+				const nlohmann::json& tiles = chunkData["tiles"];
+				const nlohmann::json& flags = chunkData["flags"];
+				TileChunk& chunk = Tilemap::GetOrCreateChunk(tilemap, chunkData["x"].get<int>(), chunkData["y"].get<int>());
+				for (int slot = 0; slot < TILEMAP_CHUNK_TILES; slot++)
+				{
+					chunk.tiles[slot] = tiles[slot].get<uint16_t>();
+					chunk.flags[slot] = flags[slot].get<uint8_t>();
+				}
+			}
+
+			ecs.addComponent(entityObj, tilemap);
+		}
+
+		// entities saved without an animation component still animate
+		AnimationSystemECS::attachAnimation(entityObj);
+
 		// set the entityId for the current entity
 		ecs.entityManager->setEntityId(entityObj, entityId);
 	}
+
+	// bake the level's platforms into static collision, cached next to the scene
+	ecs.getSpecificSystem<PhysicsSystemECS>()->LoadStaticCollision(filename);
 }
 
 // this function will save the entity's data to the JSON file
@@ -500,9 +647,8 @@ void ECSCoordinator::test5() {
 }
 
 
-//Initialises all required components and systems for the ECS system
-void ECSCoordinator::initialiseSystemsAndComponents() {
-	std::cout << "Register Everything" << std::endl;
+//Registers every component type used by the game
+void ECSCoordinator::registerAllComponents() {
 	//registerComponent<GraphicsComponent>();
 	registerComponent<TransformComponent>();
 	registerComponent<AABBComponent>();
@@ -520,11 +666,20 @@ void ECSCoordinator::initialiseSystemsAndComponents() {
 	registerComponent<BehaviourComponent>();
 	registerComponent<BackgroundComponent>();
 	registerComponent<UIComponent>();
+	registerComponent<TriggerComponent>();
+	registerComponent<ColliderComponent>();
+	registerComponent<TilemapComponent>();
+	registerComponent<ForceFieldComponent>();
+}
+
+//Initialises all required components and systems for the ECS system
+void ECSCoordinator::initialiseSystemsAndComponents() {
+	std::cout << "Register Everything" << std::endl;
+	registerAllComponents();
 
 	//LOGIC MUST COME FIRST BEFORE PHYSICS FOLLOWED BY RENDERING
 
-	auto logicSystem = std::make_shared<LogicSystemECS>();
-	registerSystem<LogicSystemECS>();
+	auto logicSystem = registerSystem<LogicSystemECS>();
 	{
 		ComponentSig logicSystemSig;
 		logicSystemSig.set(getComponentType<TransformComponent>(), true);
@@ -532,8 +687,8 @@ void ECSCoordinator::initialiseSystemsAndComponents() {
 
 	logicSystem->initialise();
 
-	auto physicsSystem = std::make_shared<PhysicsSystemECS>();
-	registerSystem<PhysicsSystemECS>();
+	//the physics config, including the worker threads, is loaded into the registered instance
+	auto physicsSystem = registerSystem<PhysicsSystemECS>();
 	{
 		ComponentSig physicsSystemSig;
 		physicsSystemSig.set(getComponentType<TransformComponent>(), true);
@@ -545,8 +700,19 @@ void ECSCoordinator::initialiseSystemsAndComponents() {
 
 	physicsSystem->initialise();
 
-	auto graphicSystem = std::make_shared<GraphicSystemECS>();
-	registerSystem<GraphicSystemECS>();
+	//Animations are advanced before the sprites are drawn
+	auto animationSystem = registerSystem<AnimationSystemECS>();
+	{
+		ComponentSig animationSystemSig;
+		animationSystemSig.set(getComponentType<TransformComponent>(), true);
+		animationSystemSig.set(getComponentType<AnimationComponent>(), true);
+		setSystemSignature<AnimationSystemECS>(animationSystemSig);
+	}
+
+	animationSystem->initialise();
+
+	//initialised on the registered instance, it starts the sprite recording threads
+	auto graphicSystem = registerSystem<GraphicSystemECS>();
 	{
 		ComponentSig graphicSystemSig;
 		graphicSystemSig.set(getComponentType<TransformComponent>(), true);
@@ -557,9 +723,7 @@ void ECSCoordinator::initialiseSystemsAndComponents() {
 
 	graphicSystem->initialise();
 
-	auto fontSystemECS = std::make_shared<FontSystemECS>();
-
-	registerSystem<FontSystemECS>();
+	auto fontSystemECS = registerSystem<FontSystemECS>();
 	{
 		ComponentSig fontSystemSig;
 		fontSystemSig.set(getComponentType<TransformComponent>(), true);
@@ -571,6 +735,15 @@ void ECSCoordinator::initialiseSystemsAndComponents() {
 	test5();
 }
 
+//Initialises the ECS with only logic and physics, for running the simulation
+//without a window, graphics or audio. No scene is loaded
+void ECSCoordinator::initialiseHeadless() {
+	registerAllComponents();
+
+	registerSystem<LogicSystemECS>()->initialise();
+	registerSystem<PhysicsSystemECS>()->initialise();
+}
+
 
 //Helper function to get random value for the cloning object
 float ECSCoordinator::getRandomVal(float min = -100.0f, float max = 100.0f) {
@@ -596,6 +769,10 @@ void ECSCoordinator::setEntityID(Entity entity, std::string ID) {
 	entityManager->setEntityId(entity, ID);
 }
 
+bool ECSCoordinator::resetEntityIDs() {
+	return entityManager->resetAvailableEnt();
+}
+
 ComponentSig ECSCoordinator::getEntitySignature(Entity entity) {
 	return entityManager->getSignature(entity);
 }
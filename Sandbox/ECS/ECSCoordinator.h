@@ -46,6 +46,10 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "CollectableComponent.h"
 #include "PumpComponent.h"
 #include "ExitComponent.h"
+#include "TriggerComponent.h"
+#include "ColliderComponent.h"
+#include "TilemapComponent.h"
+#include "ForceFieldComponent.h"
 
 #include <iostream>
 #include <fstream>
@@ -112,6 +116,8 @@ public:
 	std::string getEntityID(Entity entity);
 	Entity getEntityFromID(std::string ID);
 	void setEntityID(Entity entity, std::string ID);
+	//Start entity ids from 0 again, once every entity is destroyed
+	bool resetEntityIDs();
 
 	void LoadEntityFromJSON(ECSCoordinator& ecs, std::string const& filename);
 	// save the entity's data to JSON file
@@ -133,8 +139,11 @@ public:
 
 	void test5();
 	void initialiseSystemsAndComponents();
+	void initialiseHeadless();
 
 private:
+	void registerAllComponents();
+
 	std::unique_ptr<EntityManager> entityManager;
 	std::unique_ptr<ComponentManager> componentManager;
 	std::unique_ptr<SystemManager> systemManager;
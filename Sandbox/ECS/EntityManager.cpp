@@ -118,12 +118,10 @@ void EntityManager::setEntityId(Entity entity, std::string const& id)
 // retrieve the entity Id
 std::string EntityManager::getEntityId(Entity entity)
 {
-	for (const auto& pair : entityIds)
+	auto it = entityIds.find(entity);
+	if (it != entityIds.end())
 	{
-		if (pair.first == entity)
-		{
-			return pair.second;
-		}
+		return it->second;
 	}
 
 	return "";
@@ -147,6 +145,20 @@ std::unordered_map<Entity, std::string> EntityManager::getEntityMap() const
 	return entityIds;
 }
 
+//Reset the queue so the next entities get the same ids a fresh start would.
+//Fails while any entity is still alive since its id could be handed out twice
+bool EntityManager::resetAvailableEnt() {
+	if (liveEntCount != 0) {
+		return false;
+	}
+
+	availableEnt = std::queue<Entity>();
+	for (Entity ids = 0; ids < MAX_ENTITIES; ids++) {
+		availableEnt.push(ids);
+	}
+	return true;
+}
+
 //Cleanup the entity manager by resetting the available entities and live entity count
 void EntityManager::cleanup() {
 	availableEnt = std::queue<Entity>();
@@ -44,6 +44,9 @@ public:
 
 	std::unordered_map<Entity, std::string> getEntityMap() const;
 
+	//Hand out ids from 0 again, only once every entity has been destroyed
+	bool resetAvailableEnt();
+
 	void cleanup();
 
 private:
@@ -17,12 +17,14 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "GlobalCoordinator.h"
 #include "GUIGameViewport.h"
 #include "WindowSystem.h"
+#include "InputReplay.h"
 
 void SystemManager::entityRemoved(Entity entity) {
 	//erase entity from all systems
 	for (auto const& pair : Systems) {
 		auto const& system = pair.second;
 		system->entities.erase(entity);
+		system->entityChanged(entity);
 	}
 }
 
@@ -40,14 +42,22 @@ void SystemManager::entitySigChange(Entity entity, ComponentSig entitySig) {
 		else {
 			system->entities.erase(entity);
 		}
+		system->entityChanged(entity);
 	}
 }
 
 void SystemManager::update() {
-	for (auto const& pair : Systems) {
+	bool simulationPaused = GameViewWindow::getPaused() || WindowSystem::GetAltTab() || WindowSystem::GetCtrlAltDel();
 
-		auto const& system = pair.second;
-		if (GameViewWindow::getPaused() || WindowSystem::GetAltTab() || WindowSystem::GetCtrlAltDel() ) {
+	//a tick only counts for recording and replay when logic and physics run
+	if (!simulationPaused) {
+		InputReplay::beginTick();
+	}
+
+	for (auto const& typeName : systemOrder) {
+
+		auto const& system = Systems[typeName];
+		if (simulationPaused) {
 			if (system->getSystemECS() == "LogicSystemECS" || system->getSystemECS() == "PhysicsColliSystemECS") {
 				continue;
 			}
@@ -87,6 +97,7 @@ void SystemManager::update() {
 void SystemManager::cleanup() {
 	Systems.clear();
 	std::unordered_map<std::string, std::shared_ptr<System>>().swap(Systems);
+	systemOrder.clear();
 	systemSignatures.clear();
 	std::unordered_map<std::string, ComponentSig>().swap(systemSignatures);
 }
\ No newline at end of file
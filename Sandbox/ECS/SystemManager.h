@@ -24,6 +24,7 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include <cassert>
 #include <iostream>
 #include <set>
+#include <vector>
 
 class System {
 public:
@@ -34,6 +35,10 @@ public:
 	virtual void update(float dt) = 0;
 	virtual void cleanup() = 0;
 	virtual std::string getSystemECS() = 0;
+
+	//Called when an entity is added, removed or changes components, for
+	//systems that keep their own lists on top of the entity set
+	virtual void entityChanged(Entity entity) { (void)entity; }
 };
 
 class SystemManager
@@ -63,6 +68,8 @@ public:
 private:
 	std::unordered_map<std::string, ComponentSig> systemSignatures;
 	std::unordered_map<std::string, std::shared_ptr<System>> Systems;
+	//Systems update in the order they were registered, not hash map order
+	std::vector<std::string> systemOrder;
 };
 
 template <typename T>
@@ -72,6 +79,7 @@ std::shared_ptr<T> SystemManager::registerSystem() {
 	assert(Systems.find(typeName) == Systems.end() && "Registering system more than once.");
 	auto system = std::make_shared<T>();
 	Systems.insert({ typeName, system });
+	systemOrder.push_back(typeName);
 	return system;
 }
 
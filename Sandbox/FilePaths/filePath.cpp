@@ -186,5 +186,38 @@ std::string FilePathManager::GetSceneJSONPath()
 
     std::string jsonPathString = jsonPath.string();
 
+    return jsonPathString;
+}
+
+// this function retrieves the input replay JSON file
+std::string FilePathManager::GetReplayJSONPath()
+{
+    std::filesystem::path execPath = GetExecutablePath();
+    std::filesystem::path jsonPath = execPath.parent_path() / "Sandbox" / "assets" / "json" / "replay.json";
+
+    std::string jsonPathString = jsonPath.string();
+
+    return jsonPathString;
+}
+
+// this function retrieves the physics benchmark results JSON file
+std::string FilePathManager::GetPhysicsBenchmarkJSONPath()
+{
+    std::filesystem::path execPath = GetExecutablePath();
+    std::filesystem::path jsonPath = execPath.parent_path() / "Sandbox" / "assets" / "json" / "physicsBenchmark.json";
+
+    std::string jsonPathString = jsonPath.string();
+
+    return jsonPathString;
+}
+
+// this function retrieves the culling benchmark results JSON file
+std::string FilePathManager::GetCullingBenchmarkJSONPath()
+{
+    std::filesystem::path execPath = GetExecutablePath();
+    std::filesystem::path jsonPath = execPath.parent_path() / "Sandbox" / "assets" / "json" / "cullingBenchmark.json";
+
+    std::string jsonPathString = jsonPath.string();
+
     return jsonPathString;
 }
\ No newline at end of file
@@ -40,4 +40,7 @@ public:
 	static std::string GetPhysicsPath();
 	static std::string GetSaveJSONPath(int& saveCount);
 	static std::string GetSceneJSONPath();
+	static std::string GetReplayJSONPath();
+	static std::string GetPhysicsBenchmarkJSONPath();
+	static std::string GetCullingBenchmarkJSONPath();
 };
\ No newline at end of file
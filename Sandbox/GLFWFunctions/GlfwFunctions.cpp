@@ -20,6 +20,8 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "GUIGameViewport.h"
 #include "GlobalCoordinator.h"
 #include "LogicSystemECS.h"
+#include "PhyColliSystemECS.h"
+#include "InputReplay.h"
 #include <algorithm>
 #include <iostream>
 #include <Windows.h>
@@ -27,6 +29,7 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 GLFWwindow* GLFWFunctions::pWindow = nullptr;
 double GLFWFunctions::fps = 0.0;
 float GLFWFunctions::delta_time = 0.0;
+unsigned long long GLFWFunctions::frameNumber = 0;
 
 
 bool GLFWFunctions::allow_camera_movement = false;
@@ -250,6 +253,15 @@ void GLFWFunctions::keyboardEvent(GLFWwindow* window, int key, int scancode, int
     }
     if (action == GLFW_PRESS) {
 
+        // Input recording and headless replay
+        if (mappedKey == Key::F5) {
+            InputReplay::toggleRecording();
+        }
+
+        if (mappedKey == Key::F6) {
+            InputReplay::requestReplay();
+        }
+
         // Cheat codes
         if ((*keyState)[Key::G] && (*keyState)[Key::O] && (*keyState)[Key::D]) {
             godMode = ~godMode;
@@ -391,6 +403,12 @@ void GLFWFunctions::getFps() {
     GLFWFunctions::delta_time = static_cast<float>(currTime) - static_cast<float>(prevTime);
     prevTime = currTime;
 
+    // Deterministic runs advance the game by exactly one physics step a frame
+    if (PhysicsSystemECS::IsDeterministic()) {
+        GLFWFunctions::delta_time = PhysicsSystemECS::GetFixedDeltaTime();
+    }
+    GLFWFunctions::frameNumber++;
+
     static double frameCount = 0;
     static double startTime = glfwGetTime();
     double elapsedTime = currTime - startTime;
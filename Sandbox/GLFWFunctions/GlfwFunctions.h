@@ -69,6 +69,7 @@ struct GLFWFunctions {
 	static GLFWwindow* pWindow;
 	static double fps;
 	static float delta_time;
+	static unsigned long long frameNumber; //Counts frames, lets systems cache work per frame
 
 
 	static bool debug_flag;
@@ -4,80 +4,59 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 @team   :  MonkeHood
 @course :  CSD2401
 @file   :  AnimationData.h
-@brief  :  This file contains the declaration of the AnimationData class, which
-           is responsible for managing the animation data of a game object.
+@brief  :  This file contains the declaration of the AnimationClip class, which
+           describes the frames of a sprite sheet animation. Clips are shared by
+           every entity playing them, the playback state of each entity is kept
+           in its AnimationComponent.
 *
 * Javier Chua (javierjunliang.chua) :
 *       - Implemented the AnimationData class, which is responsible for managing the
           animation data of a game object.
+*       - Split it into the shared AnimationClip and per entity playback state.
 *
 * File Contributions: Javier Chua (100%)
 *
 /*_ _ _ _ ________________________________________________________________________________-\*/
 #pragma once
 
-#include <vector>
-#include <glm/vec2.hpp>
-#include <string>
-#include <map>
-#include <iostream>
-
-enum class Direction {
-    Left,
-    Right
+// UV rectangle of one frame inside the sprite sheet, (0, 0) is the bottom left
+struct AnimationFrameUV {
+    float u0, v0;
+    float u1, v1;
 };
-class AnimationData {
+
+// Index of a clip in the assets manager, stays valid when the clip is replaced
+using AnimationClipHandle = int;
+constexpr AnimationClipHandle invalidAnimationClipHandle = -1;
+
+class AnimationClip {
 public:
-	// Constructor
-    AnimationData(int totalFrames, float frameDuration, int columns, int rows);
-    ~AnimationData();
-	// Update function
-    void Update(float deltaTime);
-	// Update UV coordinates
-    void UpdateUVCoordinates();
-	// Get current UVs
-    inline const std::vector<glm::vec2>& GetCurrentUVs() const {
-        return *currentUVs;
+    // The sheet is columns x rows frames, read left to right from the top row.
+    // The clip plays frameCount of them starting at firstFrame
+    AnimationClip(int columns, int rows, int firstFrame, int frameCount, float frameDuration, bool looping = true);
+
+    // Moves a playback state on by deltaTime. Looping clips wrap around,
+    // others stop on their last frame
+    void Advance(int& currentFrame, float& timeAccumulator, float deltaTime) const;
+
+    // UV rectangle of a frame of the clip, counted from the clip's first frame
+    AnimationFrameUV GetFrameUV(int frame) const;
+
+    inline int GetFrameCount() const {
+        return frameCount;
     }
-	// Get current frame
-    inline int GetCurrentFrame() const {
-        return currentFrame;
+    inline float GetFrameDuration() const {
+        return frameDuration;
     }
-	// Get current action
-    inline int GetCurrentAction() const {
-        return currentAction;
+    inline bool IsLooping() const {
+        return looping;
     }
-	// Set current action
-    void ResetAnimation();
-	// Set current action
-    void SetFrameDuration(float duration);
-	// Set current action
-    void SetSpeedMultiplier(float multiplier);
-	// Set current action
-    void SetLooping(bool shouldLoop);
-	// Set current action
-    void AddFrameEvent(int frame, const std::string& eventName);
-	// Set current action
-    void TriggerFrameEvents();
 
 private:
-
-    int totalFrames;
     int columns;
     int rows;
-    int framesPerAction;
-    int currentFrame;
-    int currentAction;
-    float timeAccumulator;
+    int firstFrame;
+    int frameCount;
     float frameDuration;
-    float speedMultiplier;
     bool looping;
-    bool uvDirty;
-
-    float frameWidth;
-    float frameHeight;
-    Direction lastDirection;
-    std::vector<glm::vec2> *currentUVs;
-    std::map<int, std::vector<std::string>> frameEvents;
-
 };
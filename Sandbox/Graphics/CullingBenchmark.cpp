@@ -0,0 +1,238 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  CullingBenchmark.cpp
+@brief  :  This file contains the implementation of the CullingBenchmark class,
+           the level generator and the JSON report.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Implemented the benchmark runs with and without culling.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#include "CullingBenchmark.h"
+#include "GlobalCoordinator.h"
+#include "SpriteBatch.h"
+#include "SpriteCuller.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+
+namespace
+{
+    const unsigned int levelSeed = 12345u;
+    const int benchmarkWidth = 1600;
+    const int benchmarkHeight = 900;
+
+    struct Sprite {
+        myMath::Vector2D position;
+        myMath::Vector2D scale;
+        myMath::Vector2D orientation;
+        GLuint texture;
+        SpriteLayer layer;
+    };
+
+    // Platforms, props and characters in the proportions of a level, a fifth
+    // of them rotated. Texture names only have to differ, nothing is bound
+    std::vector<Sprite> generateLevel(const CullingBenchmark::Config& config) {
+        std::mt19937 rng(levelSeed);
+        auto random = [&rng](float min, float max) {
+            return std::uniform_real_distribution<float>(min, max)(rng);
+        };
+
+        std::vector<Sprite> sprites;
+        for (int i = 0; i < config.spriteCount; i++) {
+            Sprite sprite{};
+            sprite.position = myMath::Vector2D(random(0.f, config.levelSize), random(0.f, config.levelSize));
+            sprite.orientation = myMath::Vector2D(i % 5 == 0 ? random(0.f, 360.f) : 0.f, 0.f);
+
+            int kind = i % 10;
+            if (kind < 6) {
+                sprite.scale = myMath::Vector2D(random(100.f, 400.f), random(50.f, 150.f));
+                sprite.texture = 1;
+                sprite.layer = SpriteLayer::LEVEL;
+            }
+            else if (kind < 9) {
+                sprite.scale = myMath::Vector2D(random(50.f, 150.f), random(50.f, 150.f));
+                sprite.texture = kind == 6 ? 2 : 3;
+                sprite.layer = SpriteLayer::PROPS;
+            }
+            else {
+                sprite.scale = myMath::Vector2D(100.f, 100.f);
+                sprite.texture = 4;
+                sprite.layer = SpriteLayer::CHARACTERS;
+            }
+            sprites.push_back(sprite);
+        }
+        return sprites;
+    }
+
+    // Whether any part of the transformed unit quad lands inside NDC
+    bool isOnScreen(const myMath::Matrix3x3& xform) {
+        glm::mat3 matrix = myMath::Matrix3x3::ConvertToGLMMat3(xform);
+        glm::vec2 min(0.f), max(0.f);
+        const float corners[4][2] = { { 0.5f, 0.5f }, { 0.5f, -0.5f }, { -0.5f, -0.5f }, { -0.5f, 0.5f } };
+
+        for (int corner = 0; corner < 4; corner++) {
+            glm::vec3 point = matrix * glm::vec3(corners[corner][0], corners[corner][1], 1.f);
+            min = corner == 0 ? glm::vec2(point) : glm::min(min, glm::vec2(point));
+            max = corner == 0 ? glm::vec2(point) : glm::max(max, glm::vec2(point));
+        }
+        return min.x <= 1.f && max.x >= -1.f && min.y <= 1.f && max.y >= -1.f;
+    }
+}
+
+std::vector<CullingBenchmark::Config> CullingBenchmark::getDefaultSuite() {
+    return {
+        { "small_level", 1000, 20000.f, 0.2f, 300 },
+        { "large_level", 4500, 100000.f, 0.2f, 300 },
+        { "large_level_zoomed_in", 4500, 100000.f, 0.5f, 300 },
+        { "dense_level", 4500, 16000.f, 0.2f, 300 },
+
+        // Everything stays in view, so this is what culling costs when it saves nothing
+        { "level_in_view", 1000, 4000.f, 0.2f, 300 }
+    };
+}
+
+// The camera pans diagonally across the level. Each frame runs the same
+// transform and submit work as GraphicSystemECS, once for every sprite and
+// once for the sprites the culler hands back
+CullingBenchmark::Result CullingBenchmark::run(const Config& config) {
+    Result result{};
+    result.name = config.name;
+    result.spriteCount = config.spriteCount;
+    result.frames = config.frames;
+
+    if (config.spriteCount > static_cast<int>(MAX_ENTITIES)) {
+        std::cout << "Error: " << config.name << " needs more than " << MAX_ENTITIES << " entities, skipped" << std::endl;
+        return result;
+    }
+
+    int windowWidth = GLFWFunctions::windowWidth;
+    int windowHeight = GLFWFunctions::windowHeight;
+    GLFWFunctions::windowWidth = benchmarkWidth;
+    GLFWFunctions::windowHeight = benchmarkHeight;
+
+    std::vector<Sprite> sprites = generateLevel(config);
+
+    CameraSystem2D camera;
+    camera.initialise();
+    camera.setCameraZoom(config.cameraZoom);
+
+    SpriteBatch batch;
+    SpriteCuller culler;
+    RecordingBackend recorder;
+    std::vector<Entity> visible;
+    std::vector<bool> isVisible(sprites.size());
+
+    uint64_t submittedWithout = 0, submittedWith = 0;
+    uint64_t drawCallsWithout = 0, drawCallsWith = 0;
+    std::chrono::steady_clock::duration timeWithout{}, timeWith{};
+
+    for (int frame = 0; frame < config.frames; frame++) {
+        float t = config.frames > 1 ? static_cast<float>(frame) / (config.frames - 1) : 0.f;
+        float along = config.levelSize * (0.1f + 0.8f * t);
+        camera.setCameraPosition(myMath::Vector2D(along, along));
+        camera.update();
+        myMath::Matrix3x3 viewMatrix = camera.getViewMatrix();
+
+        // With culling first, so the on screen check below can look up its result
+        auto start = std::chrono::steady_clock::now();
+        culler.beginFrame();
+        for (size_t i = 0; i < sprites.size(); i++) {
+            culler.update(static_cast<Entity>(i), SpriteCuller::GetSpriteBounds(sprites[i].position, sprites[i].scale, sprites[i].orientation));
+        }
+        culler.queryVisible(SpriteCuller::GetViewBounds(viewMatrix, static_cast<float>(benchmarkWidth), static_cast<float>(benchmarkHeight)), visible);
+        for (auto entity : visible) {
+            const Sprite& sprite = sprites[entity];
+            batch.submit(sprite.texture, graphicsSystem.UpdateObject(sprite.position, sprite.scale, sprite.orientation, viewMatrix), static_cast<int>(sprite.layer));
+        }
+        submittedWith += batch.getQuadCount();
+        batch.flush(recorder);
+        timeWith += std::chrono::steady_clock::now() - start;
+        drawCallsWith += recorder.getDrawCalls();
+        recorder.reset();
+
+        std::fill(isVisible.begin(), isVisible.end(), false);
+        for (auto entity : visible) {
+            isVisible[entity] = true;
+        }
+
+        start = std::chrono::steady_clock::now();
+        for (const Sprite& sprite : sprites) {
+            batch.submit(sprite.texture, graphicsSystem.UpdateObject(sprite.position, sprite.scale, sprite.orientation, viewMatrix), static_cast<int>(sprite.layer));
+        }
+        submittedWithout += batch.getQuadCount();
+        batch.flush(recorder);
+        timeWithout += std::chrono::steady_clock::now() - start;
+        drawCallsWithout += recorder.getDrawCalls();
+        recorder.reset();
+
+        for (size_t i = 0; i < sprites.size(); i++) {
+            const Sprite& sprite = sprites[i];
+            if (!isVisible[i] && isOnScreen(graphicsSystem.UpdateObject(sprite.position, sprite.scale, sprite.orientation, viewMatrix))) {
+                result.missedOnScreen++;
+            }
+        }
+    }
+
+    GLFWFunctions::windowWidth = windowWidth;
+    GLFWFunctions::windowHeight = windowHeight;
+
+    double frames = static_cast<double>(std::max(config.frames, 1));
+    result.submittedWithout = submittedWithout / frames;
+    result.submittedWith = submittedWith / frames;
+    result.drawCallsWithout = drawCallsWithout / frames;
+    result.drawCallsWith = drawCallsWith / frames;
+    result.nsPerFrameWithout = std::chrono::duration<double, std::nano>(timeWithout).count() / frames;
+    result.nsPerFrameWith = std::chrono::duration<double, std::nano>(timeWith).count() / frames;
+    return result;
+}
+
+bool CullingBenchmark::runSuite(const std::vector<Config>& suite, std::string const& outputPath) {
+    nlohmann::json results = nlohmann::json::array();
+
+    for (auto const& config : suite) {
+        Result result = run(config);
+
+        std::cout << result.name << " (" << result.spriteCount << " sprites): "
+                  << result.submittedWith << " of " << result.submittedWithout << " sprites submitted per frame, "
+                  << result.drawCallsWith << " draw calls instead of " << result.drawCallsWithout << ", "
+                  << result.nsPerFrameWith << " ns/frame instead of " << result.nsPerFrameWithout << std::endl;
+
+        if (result.missedOnScreen > 0) {
+            std::cout << "Error: " << result.name << " culled " << result.missedOnScreen << " sprites that were on screen" << std::endl;
+        }
+
+        results.push_back({
+            { "name", result.name },
+            { "sprites", result.spriteCount },
+            { "frames", result.frames },
+            { "submittedWithout", result.submittedWithout },
+            { "submittedWith", result.submittedWith },
+            { "drawCallsWithout", result.drawCallsWithout },
+            { "drawCallsWith", result.drawCallsWith },
+            { "nsPerFrameWithout", result.nsPerFrameWithout },
+            { "nsPerFrameWith", result.nsPerFrameWith },
+            { "missedOnScreen", result.missedOnScreen } });
+    }
+
+    nlohmann::json jsonObj;
+    jsonObj["benchmark"]["window"] = { benchmarkWidth, benchmarkHeight };
+    jsonObj["benchmark"]["results"] = results;
+
+    std::ofstream outputFile(outputPath);
+    if (!outputFile.is_open()) {
+        std::cout << "Error: could not save to file " << outputPath << std::endl;
+        return false;
+    }
+
+    outputFile << jsonObj.dump(2);
+    return true;
+}
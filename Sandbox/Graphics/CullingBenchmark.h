@@ -0,0 +1,55 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  CullingBenchmark.h
+@brief  :  This file contains the declaration of the CullingBenchmark class. It
+           generates large levels of sprites, pans a camera across them and
+           counts the sprites and draw calls submitted to the sprite batch with
+           and without culling, without a window or OpenGL context.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Declared the CullingBenchmark class.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#pragma once
+#include <string>
+#include <vector>
+
+class CullingBenchmark
+{
+public:
+    struct Config {
+        std::string name;
+        int spriteCount;
+        float levelSize;        // sprites are spread over a square this wide
+        float cameraZoom;
+        int frames;
+    };
+
+    struct Result {
+        std::string name;
+        int spriteCount;
+        int frames;
+        double submittedWithout;    // sprites per frame
+        double submittedWith;
+        double drawCallsWithout;    // per frame
+        double drawCallsWith;
+        double nsPerFrameWithout;
+        double nsPerFrameWith;
+        size_t missedOnScreen;      // sprites on screen that culling left out, must stay 0
+    };
+
+    // The scenarios run by default
+    static std::vector<Config> getDefaultSuite();
+
+    // Run every scenario and write the results as JSON. Returns false if the
+    // file could not be written
+    static bool runSuite(const std::vector<Config>& suite, std::string const& outputPath);
+
+    static Result run(const Config& config);
+};
@@ -0,0 +1,22 @@
+#shader vertex
+#version 330 core
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec4 color;
+
+out vec4 Color;
+
+// Debug lines are already in NDC, transformed on the CPU
+void main() {
+    gl_Position = vec4(position, 0.0, 1.0);
+    Color = color;
+}
+
+#shader fragment
+#version 330 core
+out vec4 FragColor;
+
+in vec4 Color;
+
+void main() {
+    FragColor = Color;
+}
@@ -0,0 +1,157 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  DebugDraw.cpp
+@brief  :  This file contains the implementation of the DebugDraw class, the
+           shape transforms and the streamed line draw.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Implemented the box and circle outlines, moved over from the
+*         immediate mode debug functions in GraphicsSystem.
+*       - Implemented the streamed vertex buffer and the line draw.
+*       - Moved the line shader out into Debug.shader, loaded by the assets manager.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#include "DebugDraw.h"
+#include "Shader.h"
+#include "GLStateCache.h"
+#include "GlfwFunctions.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+
+namespace
+{
+    // Corners of the unit box, going round so each one joins the next
+    const float boxCorners[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+}
+
+DebugDraw::DebugDraw()
+    : vao(0), vbo(0), bufferVertices(0), lastLineCount(0) {
+}
+
+DebugDraw::~DebugDraw() {
+    cleanup();
+}
+
+void DebugDraw::initialise() {
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+
+    GLStateCache::BindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, r));
+    glEnableVertexAttribArray(1);
+    GLStateCache::BindVertexArray(0);
+
+    bufferVertices = 0;
+}
+
+void DebugDraw::cleanup() {
+    if (vao) {
+        glDeleteBuffers(1, &vbo);
+        GLStateCache::DeleteVertexArrays(1, &vao);
+        vao = vbo = 0;
+    }
+    bufferVertices = 0;
+}
+
+// Same result as projection * view * translation * rotation * scale, with the
+// projection being the window sized orthographic one
+glm::mat3 DebugDraw::MakeShapeToNDC(myMath::Vector2D position, myMath::Vector2D size, float rotation, const myMath::Matrix3x3& viewMatrix) {
+    float angle = glm::radians(rotation);
+    float cosine = std::cos(angle);
+    float sine = std::sin(angle);
+
+    glm::mat3 model(cosine * size.GetX(), sine * size.GetX(), 0.f,
+                    -sine * size.GetY(), cosine * size.GetY(), 0.f,
+                    position.GetX(), position.GetY(), 1.f);
+
+    glm::mat3 projection(2.f / GLFWFunctions::windowWidth, 0.f, 0.f,
+                         0.f, 2.f / GLFWFunctions::windowHeight, 0.f,
+                         0.f, 0.f, 1.f);
+
+    return projection * myMath::Matrix3x3::ConvertToGLMMat3(viewMatrix) * model;
+}
+
+void DebugDraw::addLine(const glm::vec2& from, const glm::vec2& to, const Color& color) {
+    vertices.push_back({ from.x, from.y, color.r, color.g, color.b, color.a });
+    vertices.push_back({ to.x, to.y, color.r, color.g, color.b, color.a });
+}
+
+void DebugDraw::addBox(myMath::Vector2D position, myMath::Vector2D size, float rotation, const myMath::Matrix3x3& viewMatrix, const Color& color) {
+    glm::mat3 xform = MakeShapeToNDC(position, size, rotation, viewMatrix);
+
+    glm::vec2 corners[4];
+    for (int corner = 0; corner < 4; corner++) {
+        corners[corner] = glm::vec2(xform * glm::vec3(boxCorners[corner][0], boxCorners[corner][1], 1.f));
+    }
+    for (int corner = 0; corner < 4; corner++) {
+        addLine(corners[corner], corners[(corner + 1) % 4], color);
+    }
+}
+
+void DebugDraw::addCircle(myMath::Vector2D position, float radius, float rotation, const myMath::Matrix3x3& viewMatrix,
+                          const Color& color, int segments) {
+    if (segments < 3) {
+        return;
+    }
+
+    glm::mat3 xform = MakeShapeToNDC(position, myMath::Vector2D(radius, radius), rotation, viewMatrix);
+    const std::vector<glm::vec2>& points = getUnitCircle(segments);
+
+    vertices.reserve(vertices.size() + segments * 2);
+    glm::vec2 first = glm::vec2(xform * glm::vec3(points[0], 1.f));
+    glm::vec2 previous = first;
+    for (int i = 1; i < segments; i++) {
+        glm::vec2 point = glm::vec2(xform * glm::vec3(points[i], 1.f));
+        addLine(previous, point, color);
+        previous = point;
+    }
+    addLine(previous, first, color);
+}
+
+const std::vector<glm::vec2>& DebugDraw::getUnitCircle(int segments) {
+    if (unitCircle.size() != static_cast<size_t>(segments)) {
+        unitCircle.resize(segments);
+        for (int i = 0; i < segments; i++) {
+            float theta = 2.0f * glm::pi<float>() * float(i) / float(segments);
+            unitCircle[i] = glm::vec2(std::cos(theta), std::sin(theta));
+        }
+    }
+    return unitCircle;
+}
+
+void DebugDraw::flush(Shader* shader) {
+    lastLineCount = getLineCount();
+    if (vertices.empty() || !vao || !shader) {
+        clear();
+        return;
+    }
+
+    GLStateCache::BindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    // Orphan last frame's storage so the upload does not wait on it
+    bufferVertices = std::max(vertices.size(), bufferVertices);
+    glBufferData(GL_ARRAY_BUFFER, bufferVertices * sizeof(Vertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
+
+    shader->Bind();
+    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(vertices.size()));
+    shader->Unbind();
+    GLStateCache::BindVertexArray(0);
+
+    clear();
+}
+
+void DebugDraw::clear() {
+    vertices.clear();
+}
@@ -0,0 +1,91 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  DebugDraw.h
+@brief  :  This file contains the declaration of the DebugDraw class. Debug
+           lines, boxes and circles drawn during a frame are transformed to NDC
+           on the CPU, one matrix per shape, and collected into a single line
+           list that is uploaded and drawn with one draw call. Collecting the
+           lines does not touch OpenGL, so a frame's vertices can be checked
+           without a window.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Declared the DebugDraw class.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#pragma once
+#include <GL/glew.h>
+#include <vector>
+#include <glm/glm.hpp>
+#include "vector2D.h"
+#include "matrix3x3.h"
+
+class Shader;
+
+class DebugDraw
+{
+public:
+    struct Color {
+        float r, g, b, a;
+    };
+
+    // Per vertex data of the line list: NDC position and color
+    struct Vertex {
+        float x, y;
+        float r, g, b, a;
+    };
+
+    static constexpr Color red = { 1.f, 0.f, 0.f, 1.f };
+    static constexpr int defaultCircleSegments = 100;
+
+    DebugDraw();
+    ~DebugDraw();
+
+    // Creates the vertex array and buffer. Needs a GL context
+    void initialise();
+    void cleanup();
+
+    // Model to NDC of a shape, with the window's projection. Rotation is in degrees
+    static glm::mat3 MakeShapeToNDC(myMath::Vector2D position, myMath::Vector2D size, float rotation, const myMath::Matrix3x3& viewMatrix);
+
+    // A line between two points already in NDC
+    void addLine(const glm::vec2& from, const glm::vec2& to, const Color& color = red);
+
+    // Outline of a box of the given size centered on position
+    void addBox(myMath::Vector2D position, myMath::Vector2D size, float rotation, const myMath::Matrix3x3& viewMatrix, const Color& color = red);
+
+    // Circle outline made of segments lines
+    void addCircle(myMath::Vector2D position, float radius, float rotation, const myMath::Matrix3x3& viewMatrix,
+                   const Color& color = red, int segments = defaultCircleSegments);
+
+    // Uploads the frame's lines, draws them with one call of the given line
+    // shader and starts a new frame. Without a shader the lines are dropped
+    void flush(Shader* shader);
+
+    // Drops everything added since the last flush
+    void clear();
+
+    bool empty() const { return vertices.empty(); }
+    const std::vector<Vertex>& getVertices() const { return vertices; }
+    size_t getLineCount() const { return vertices.size() / 2; }
+
+    // Lines drawn by the last flush
+    size_t getLastLineCount() const { return lastLineCount; }
+
+private:
+    // Points on the unit circle, worked out again only when the segment count changes
+    const std::vector<glm::vec2>& getUnitCircle(int segments);
+
+    std::vector<Vertex> vertices;
+    std::vector<glm::vec2> unitCircle;
+
+    GLuint vao;
+    GLuint vbo;
+    size_t bufferVertices;
+    size_t lastLineCount;
+};
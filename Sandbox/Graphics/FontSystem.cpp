@@ -13,16 +13,44 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
         - Developed the loadFont function to load and configure character glyphs using FreeType.
         - Created renderText function to handle word wrapping, line spacing, and character positioning.
         - Implemented cleanup to release allocated resources for fonts and graphics buffers.
+        - Moved the glyphs onto the font atlas, so text is queued in the sprite batch and drawn with one call per font.
+        - Cached the word wrapped layout of each string, so unchanged text only has its glyphs moved into place.
+        - Decoded the text as UTF-8 in the layout, so the Latin-1 glyphs of the atlas are found by their code point.
 
  File Contributions:  Javier Chua 
 /*_______________________________________________________________________________________________________________*/
 #include "FontSystem.h"
 #include "GlobalCoordinator.h"
 #include <iostream>
-#include <ft2build.h>
-#include FT_FREETYPE_H
 
-FontSystem::FontSystem() : VAO(0), VBO(0), isInitialized(false), projectionMatrix(1.0f) {
+namespace
+{
+    // Reads the UTF-8 character starting at pos and moves pos past it. The
+    // atlas only holds U+0000 to U+00FF, anything past it or malformed
+    // returns nullptr and is skipped
+    const Character* nextGlyph(const FontAtlas& font, const std::string& text, size_t& pos) {
+        unsigned char lead = static_cast<unsigned char>(text[pos++]);
+        if (lead < 0x80) {
+            return &font.Characters[lead];
+        }
+
+        size_t length = lead >= 0xF0 ? 3 : lead >= 0xE0 ? 2 : lead >= 0xC0 ? 1 : 0;
+        unsigned int codePoint = lead & (0x3F >> length);
+        for (size_t byte = 0; byte < length; byte++) {
+            if (pos >= text.size() || (static_cast<unsigned char>(text[pos]) & 0xC0) != 0x80) {
+                return nullptr;
+            }
+            codePoint = (codePoint << 6) | (static_cast<unsigned char>(text[pos++]) & 0x3F);
+        }
+
+        if (length == 0 || codePoint >= font.Characters.size()) {
+            return nullptr;
+        }
+        return &font.Characters[codePoint];
+    }
+}
+
+FontSystem::FontSystem() : isInitialized(false), projectionMatrix(1.0f) {
    if (isInitialized) return;
 }
 
@@ -46,83 +74,17 @@ void FontSystem::initialise() {
         GLFWFunctions::windowHeight / 2.0f   // top
     );
 
-
-
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, nullptr, GL_DYNAMIC_DRAW);
-
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
     isInitialized = true;
 }
 
-// Load a font with the specified path and size
+// Load a font with the specified path and size, the atlas is built by the assets manager
 void FontSystem::loadFont(const std::string& fontPath, unsigned int fontSize) {
-    FT_Library ft;
-    if (FT_Init_FreeType(&ft)) {
-        std::cerr << "ERROR::FREETYPE: Could not initialize FreeType Library" << std::endl;
-        return;
-    }
-
-    FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
-        std::cerr << "ERROR::FREETYPE: Failed to load font at path: " << fontPath << std::endl;
-        FT_Done_FreeType(ft);
-        return;
-    }
-
-    FT_Set_Pixel_Sizes(face, 0, fontSize);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    bool fontLoaded = true;
-    std::map<char, Character> tempCharacters;
-
-    for (unsigned char c = 0; c < 128; c++) {
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cerr << "ERROR::FREETYPE: Failed to load Glyph for character: " << c << std::endl;
-            fontLoaded = false;
-            continue;
-        }
-
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, face->glyph->bitmap.width, face->glyph->bitmap.rows, 0, GL_RED, GL_UNSIGNED_BYTE, face->glyph->bitmap.buffer);
-
-        // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            static_cast<unsigned int>(face->glyph->advance.x)
-        };
-
-        tempCharacters.insert(std::pair<char, Character>(c, character));
-    }
-
-    if (fontLoaded) {
-        (*Fonts)[fontPath] = std::move(tempCharacters); // Move the local map into the Fonts map
-    }
-    else {
-        std::cerr << "ERROR: Not all glyphs were loaded for font: " << fontPath << std::endl;
-    }
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
-    std::cout << "Font loaded successfully: " << fontPath << " with total glyphs loaded: " << (*Fonts)[fontPath].size() << std::endl;
+    assetsManager.LoadFont(fontPath, fontPath, fontSize);
 }
 
 // Render text on the screen using the specified font
 void FontSystem::renderText(const std::string& fontId, const std::string& text, float x, float y, float scale, myMath::Vector3D color, float maxWidth, myMath::Matrix3x3 viewMat) {
+    (void)viewMat; // Text is placed in screen space
     if (!isInitialized) {
         std::cerr << "ERROR: FontSystem not initialized!" << std::endl;
         return;
@@ -134,127 +96,108 @@ void FontSystem::renderText(const std::string& fontId, const std::string& text,
 		return;
 	}
 
-    const std::map<char, Character>& characters = it->second;
-
-    glm::mat3 viewMatrix = myMath::Matrix3x3::ConvertToGLMMat3(viewMat);
-
+    const TextLayout& layout = getLayout(fontId, it->second, text, scale, maxWidth);
+
+    // Queue the glyphs as sprites on the UI layer. The font projection takes
+    // them straight from pixels to NDC
+    float scaleX = projectionMatrix[0][0];
+    float scaleY = projectionMatrix[1][1];
+    float offsetX = x * scaleX + projectionMatrix[3][0];
+    float offsetY = y * scaleY + projectionMatrix[3][1];
+
+    SpriteBatch& batch = graphicsSystem.GetSpriteBatch();
+    SpriteBatch::Quad quad{};
+    quad.texture = layout.AtlasTexture;
+    quad.tint[0] = color.GetX();
+    quad.tint[1] = color.GetY();
+    quad.tint[2] = color.GetZ();
+    quad.tint[3] = 1.0f;
+
+    for (const LaidOutGlyph& glyph : layout.Glyphs) {
+        quad.xform = myMath::Matrix3x3(glyph.width * scaleX, 0.0f, 0.0f,
+                                       0.0f, glyph.height * scaleY, 0.0f,
+                                       glyph.centreX * scaleX + offsetX, glyph.centreY * scaleY + offsetY, 1.0f);
+        quad.uvs[0] = myMath::Vector2D(glyph.UVMax.x, glyph.UVMin.y);
+        quad.uvs[1] = myMath::Vector2D(glyph.UVMax.x, glyph.UVMax.y);
+        quad.uvs[2] = myMath::Vector2D(glyph.UVMin.x, glyph.UVMax.y);
+        quad.uvs[3] = myMath::Vector2D(glyph.UVMin.x, glyph.UVMin.y);
+        batch.submit(quad, static_cast<int>(SpriteLayer::UI));
+    }
+}
 
-    glm::mat4 viewMat4{ 1 };
-    // Combine the projection and view matrices
-    glm::mat4 finalProjection = projectionMatrix * viewMat4;
+// Find the layout of the string, laying it out only if it is new or its font was reloaded
+const TextLayout& FontSystem::getLayout(const std::string& fontId, const FontAtlas& font, const std::string& text, float scale, float maxWidth) {
+    auto cached = layoutCache.find(TextLayoutKeyRef{ fontId, text, scale, maxWidth });
+    if (cached == layoutCache.end()) {
+        cached = layoutCache.emplace(TextLayoutKey{ fontId, text, scale, maxWidth }, TextLayout{}).first;
+        layoutText(font, text, scale, maxWidth, cached->second);
+    }
+    else if (cached->second.FontVersion != font.Version || cached->second.AtlasTexture != font.AtlasTexture) {
+        layoutText(font, text, scale, maxWidth, cached->second);
+    }
 
-    // Bind the font shader and set uniforms
-    assetsManager.GetShader("fontShader")->Bind();
-    assetsManager.GetShader("fontShader")->SetUniform3f("textColor", color.GetX(), color.GetY(), color.GetZ());
-    assetsManager.GetShader("fontShader")->SetUniformMatrix4f("projection", finalProjection);
-    
+    cached->second.LastUsedFrame = frame;
+    return cached->second;
+}
 
-    float xpos = x;
-    float ypos = y;
+// Place the glyphs with the starting point at the origin, wrapping words that
+// would go past maxWidth onto the next line
+void FontSystem::layoutText(const FontAtlas& font, const std::string& text, float scale, float maxWidth, TextLayout& layout) {
+    layout.AtlasTexture = font.AtlasTexture;
+    layout.FontVersion = font.Version;
+    layout.Glyphs.clear();
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    float xpos = 0.0f;
+    float ypos = 0.0f;
 
    
     const float lineSpacing = 1.5f; 
 
-    std::string word; 
-    for (char c : text) {
-        if (c == ' ') { 
-            if (!word.empty()) {
-               
-                float wordWidth = 0.0f;
-                for (char wc : word) {
-                    if (characters.find(wc) != characters.end()) {
-                        wordWidth += (characters.at(wc).Advance >> 6) * scale; // Advance width
-                    }
-                }
+    // Words are the characters between spaces, kept as a range of the text
+    size_t wordStart = 0;
+    for (size_t i = 0; i <= text.size(); i++) {
+        if (i < text.size() && text[i] != ' ') {
+            continue;
+        }
 
-             
-                if (xpos + wordWidth > x + maxWidth) {
-                    xpos = x; 
-                    ypos -= (characters.at(word[0]).Size.y * scale) * lineSpacing; 
+        if (i > wordStart) {
+            float wordWidth = 0.0f;
+            for (size_t wc = wordStart; wc < i;) {
+                const Character* ch = nextGlyph(font, text, wc);
+                if (ch && ch->Loaded) {
+                    wordWidth += (ch->Advance >> 6) * scale; // Advance width
                 }
+            }
 
-                // Render the word
-                for (char wc : word) {
-                    if (characters.find(wc) != characters.end()) {
-                        Character ch = characters.at(wc);
-                        float h = ch.Size.y * scale;
-
-                        float yposAdjusted = ypos - (ch.Size.y - ch.Bearing.y) * scale;
-                        float w = ch.Size.x * scale;
-
-                        float vertices[6][4] = {
-                            { xpos,     yposAdjusted + h,   0.0f, 0.0f },
-                            { xpos,     yposAdjusted,       0.0f, 1.0f },
-                            { xpos + w, yposAdjusted,       1.0f, 1.0f },
-
-                            { xpos,     yposAdjusted + h,   0.0f, 0.0f },
-                            { xpos + w, yposAdjusted,       1.0f, 1.0f },
-                            { xpos + w, yposAdjusted + h,   1.0f, 0.0f }
-                        };
-
-                        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-                        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-                        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-                        xpos += (ch.Advance >> 6) * scale; 
-                    }
-                }
-                word.clear(); // Clear the word after rendering
+            if (xpos + wordWidth > maxWidth) {
+                xpos = 0.0f; // Reset x position to the start of the line
+                size_t first = wordStart;
+                const Character* ch = nextGlyph(font, text, first);
+                ypos -= ((ch ? ch->Size.y : 0) * scale) * lineSpacing; 
             }
-            xpos += 25; // Add space between words
-            continue;
-        }
 
-        word += c; 
-    }
+            // Place the word
+            for (size_t wc = wordStart; wc < i;) {
+                const Character* ch = nextGlyph(font, text, wc);
+                if (!ch || !ch->Loaded) {
+                    continue;
+                }
 
-    // Render the last word if there is one
-    if (!word.empty()) {
-        float wordWidth = 0.0f;
-        for (char wc : word) {
-            if (characters.find(wc) != characters.end()) {
-                wordWidth += (characters.at(wc).Advance >> 6) * scale; // Advance width
+                float w = ch->Size.x * scale;
+                float h = ch->Size.y * scale;
+                if (w > 0.0f && h > 0.0f) {
+                    float yposAdjusted = ypos - (ch->Size.y - ch->Bearing.y) * scale;
+                    layout.Glyphs.push_back({ xpos + w / 2.0f, yposAdjusted + h / 2.0f, w, h, ch->UVMin, ch->UVMax });
+                }
+                xpos += (ch->Advance >> 6) * scale; 
             }
         }
 
-        if (xpos + wordWidth > x + maxWidth) {
-            xpos = x; // Reset x position to the start of the line
-            ypos -= (characters.at(word[0]).Size.y * scale) * lineSpacing; 
-        }
-
-        for (char wc : word) {
-            if (characters.find(wc) != characters.end()) {
-                Character ch = characters.at(wc);
-                float h = ch.Size.y * scale;
-
-                float yposAdjusted = ypos - (ch.Size.y - ch.Bearing.y) * scale;
-                float w = ch.Size.x * scale;
-
-                float vertices[6][4] = {
-                    { xpos,     yposAdjusted + h,   0.0f, 0.0f },
-                    { xpos,     yposAdjusted,       0.0f, 1.0f },
-                    { xpos + w, yposAdjusted,       1.0f, 1.0f },
-
-                    { xpos,     yposAdjusted + h,   0.0f, 0.0f },
-                    { xpos + w, yposAdjusted,       1.0f, 1.0f },
-                    { xpos + w, yposAdjusted + h,   1.0f, 0.0f }
-                };
-
-                glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-                glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-                glDrawArrays(GL_TRIANGLES, 0, 6);
-
-                xpos += (ch.Advance >> 6) * scale; 
-            }
+        if (i < text.size()) {
+            xpos += 25; // Add space between words
         }
+        wordStart = i + 1;
     }
-
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    assetsManager.GetShader("fontShader")->Unbind();
 }
 
 void FontSystem::draw(const std::string& text, const std::string& fontId, float x, float y, float scale, myMath::Vector3D color, float maxWidth, myMath::Matrix3x3 viewMat) {
@@ -262,12 +205,22 @@ void FontSystem::draw(const std::string& text, const std::string& fontId, float
     renderText(fontId, text, x, y, scale, color, maxWidth, viewMat);
 }
 
+void FontSystem::endFrame() {
+    for (auto it = layoutCache.begin(); it != layoutCache.end();) {
+        if (it->second.LastUsedFrame != frame) {
+            it = layoutCache.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    frame++;
+}
+
 void FontSystem::cleanup() {
     if (!isInitialized) return;
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-
+    layoutCache.clear();
     isInitialized = false;
 
 }
@@ -10,6 +10,8 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 * Javier Chua (javierjunliang.chua) :
 *       - Implemented the declaration structure of the FontSystem class which inherits the GameSystems which includes member functions to initialise, update 
 *         and render. Character structure is also implemented to encapsulate the features needed to render each character
+*       - Declared the FontAtlas structure, which keeps every glyph of a font in one texture with a flat glyph table
+*       - Declared the text layout cache, which keeps the placed glyphs of each string until it stops being drawn
 *
 * File Contributions: Javier Chua 
 *
@@ -17,9 +19,12 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #ifndef FONTSYSTEM_H
 #define FONTSYSTEM_H
 
+#include <array>
 #include <string>
 #include <map>
 #include <memory>
+#include <tuple>
+#include <vector>
 #include <glm/glm.hpp>
 #include "Shader.h"
 #include "Systems.h"
@@ -31,10 +36,61 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 
 
 struct Character {
-    unsigned int TextureID;   // Texture ID for the character
+    glm::vec2 UVMin;          // Top left corner of the glyph in the font atlas
+    glm::vec2 UVMax;          // Bottom right corner of the glyph in the font atlas
     glm::ivec2 Size;          // Size of the glyph
     glm::ivec2 Bearing;       // Offset from the baseline to the top of the glyph
     unsigned int Advance;      // Horizontal offset to advance to the next glyph
+    bool Loaded;              // False for characters the font has no glyph for
+};
+
+// Every glyph of a font at one size, rasterised into a single texture. The
+// glyph table is indexed by the byte value of the character
+struct FontAtlas {
+    GLuint AtlasTexture;
+    int AtlasWidth, AtlasHeight;
+    unsigned int Version;     // Goes up each time the font is loaded again
+    std::array<Character, 256> Characters;
+};
+
+// A glyph placed by the layout, in pixels from the text's starting point
+struct LaidOutGlyph {
+    float centreX, centreY;
+    float width, height;
+    glm::vec2 UVMin, UVMax;
+};
+
+// The glyphs of one string after word wrapping, ready to be moved to where the text is drawn
+struct TextLayout {
+    GLuint AtlasTexture;
+    unsigned int FontVersion;
+    std::vector<LaidOutGlyph> Glyphs;
+    unsigned long long LastUsedFrame;
+};
+
+// Everything the layout of a string depends on
+struct TextLayoutKey {
+    std::string FontId;
+    std::string Text;
+    float Scale;
+    float MaxWidth;
+};
+
+// Same as TextLayoutKey but refers to the caller's strings, so finding a cached layout does not copy them
+struct TextLayoutKeyRef {
+    const std::string& FontId;
+    const std::string& Text;
+    float Scale;
+    float MaxWidth;
+};
+
+struct TextLayoutKeyLess {
+    using is_transparent = void;
+
+    template <typename Lhs, typename Rhs>
+    bool operator()(const Lhs& lhs, const Rhs& rhs) const {
+        return std::tie(lhs.FontId, lhs.Text, lhs.Scale, lhs.MaxWidth) < std::tie(rhs.FontId, rhs.Text, rhs.Scale, rhs.MaxWidth);
+    }
 };
 
 class FontSystem : public GameSystems {
@@ -49,18 +105,23 @@ public:
 
     void loadFont(const std::string& fontPath, unsigned int fontSize); // Load a font
 
+    // Queues the text's glyphs in the sprite batch, they are drawn by the next FlushSprites
     void draw(const std::string& text, const std::string& fontId, float x, float y, float scale, myMath::Vector3D color, float maxWidth,  myMath::Matrix3x3 viewMat);
+
+    // Drops the layouts of text that was not drawn since the last call
+    void endFrame();
+    size_t getCachedLayoutCount() const { return layoutCache.size(); }
     bool isInitialized = false;
-    std::map<std::string, std::map<char, Character>>* Fonts;
 
 
 
 private:
     void renderText(const std::string& fontId, const std::string& text, float x, float y, float scale, myMath::Vector3D color, float maxWidth, myMath::Matrix3x3 viewMat);
+    const TextLayout& getLayout(const std::string& fontId, const FontAtlas& font, const std::string& text, float scale, float maxWidth);
+    static void layoutText(const FontAtlas& font, const std::string& text, float scale, float maxWidth, TextLayout& layout);
     glm::mat4 projectionMatrix;
-    std::map<char, Character>* Characters; // Map of characters
-    unsigned int VAO, VBO;                 // Vertex Array Object and Vertex Buffer Object
-    std::unique_ptr<Shader> textShader;         // Shader for rendering text
+    std::map<TextLayoutKey, TextLayout, TextLayoutKeyLess> layoutCache;
+    unsigned long long frame = 0;
     bool isCleanedUp = false;
 
 
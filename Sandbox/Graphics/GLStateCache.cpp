@@ -0,0 +1,102 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  GLStateCache.cpp
+@brief  :  This file contains the implementation of the GLStateCache class.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Implemented the cached binds and the per frame counters.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#include "GLStateCache.h"
+
+GLuint GLStateCache::program = 0;
+GLuint GLStateCache::texture = 0;
+GLuint GLStateCache::vertexArray = 0;
+bool GLStateCache::programKnown = false;
+bool GLStateCache::textureKnown = false;
+bool GLStateCache::vertexArrayKnown = false;
+GLStateCache::Stats GLStateCache::frame{};
+GLStateCache::Stats GLStateCache::lastFrame{};
+
+void GLStateCache::UseProgram(GLuint newProgram) {
+    frame.requested++;
+    if (programKnown && program == newProgram) {
+        frame.skipped++;
+        return;
+    }
+
+    glUseProgram(newProgram);
+    program = newProgram;
+    programKnown = true;
+}
+
+void GLStateCache::BindTexture(GLuint newTexture) {
+    frame.requested++;
+    if (textureKnown && texture == newTexture) {
+        frame.skipped++;
+        return;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, newTexture);
+    texture = newTexture;
+    textureKnown = true;
+}
+
+void GLStateCache::BindVertexArray(GLuint newVertexArray) {
+    frame.requested++;
+    if (vertexArrayKnown && vertexArray == newVertexArray) {
+        frame.skipped++;
+        return;
+    }
+
+    glBindVertexArray(newVertexArray);
+    vertexArray = newVertexArray;
+    vertexArrayKnown = true;
+}
+
+void GLStateCache::DeleteProgram(GLuint deleted) {
+    glDeleteProgram(deleted);
+
+    // A deleted program stays in use until another is picked, so unbind it
+    // here before its name can be handed out again
+    if (programKnown && program == deleted) {
+        glUseProgram(0);
+        program = 0;
+    }
+}
+
+void GLStateCache::DeleteTextures(GLsizei count, const GLuint* textures) {
+    glDeleteTextures(count, textures);
+    for (GLsizei i = 0; i < count; i++) {
+        if (textureKnown && texture == textures[i]) {
+            texture = 0;
+        }
+    }
+}
+
+void GLStateCache::DeleteVertexArrays(GLsizei count, const GLuint* vertexArrays) {
+    glDeleteVertexArrays(count, vertexArrays);
+    for (GLsizei i = 0; i < count; i++) {
+        if (vertexArrayKnown && vertexArray == vertexArrays[i]) {
+            vertexArray = 0;
+        }
+    }
+}
+
+void GLStateCache::Invalidate() {
+    programKnown = false;
+    textureKnown = false;
+    vertexArrayKnown = false;
+}
+
+void GLStateCache::BeginFrame() {
+    lastFrame = frame;
+    frame = {};
+    Invalidate();
+}
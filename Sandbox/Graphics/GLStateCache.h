@@ -0,0 +1,55 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  GLStateCache.h
+@brief  :  This file contains the declaration of the GLStateCache class, which
+           remembers the bound shader program, 2D texture and vertex array and
+           skips binds that would not change anything. It also counts the binds
+           asked for and skipped each frame for the performance viewer.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Declared the GLStateCache class.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#pragma once
+#include <GL/glew.h>
+
+class GLStateCache
+{
+public:
+    struct Stats {
+        unsigned int requested;     // binds asked for through the cache
+        unsigned int skipped;       // binds that matched what was already bound
+    };
+
+    static void UseProgram(GLuint program);
+    static void BindTexture(GLuint texture);        // GL_TEXTURE_2D on texture unit 0
+    static void BindVertexArray(GLuint vertexArray);
+
+    // Deleting a bound object unbinds it, so the cache has to forget it too
+    static void DeleteProgram(GLuint program);
+    static void DeleteTextures(GLsizei count, const GLuint* textures);
+    static void DeleteVertexArrays(GLsizei count, const GLuint* vertexArrays);
+
+    // Forget everything, for after code that binds behind the cache's back
+    static void Invalidate();
+
+    // Called once per frame. Moves this frame's counts to GetLastFrameStats
+    // and invalidates, so each frame starts from a known state
+    static void BeginFrame();
+    static Stats GetLastFrameStats() { return lastFrame; }
+
+private:
+    static GLuint program;
+    static GLuint texture;
+    static GLuint vertexArray;
+    static bool programKnown, textureKnown, vertexArrayKnown;
+
+    static Stats frame;
+    static Stats lastFrame;
+};
@@ -22,17 +22,22 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
         - Implemented function to change sprite animation according to the action.
         - Implemented drawDebugLines function to draw the bounding box of the sprite,
           and the update function to update the model transformation matrix.
+        - Skipped tilemap chunks outside the camera's view.
+        - Moved the debug outlines from immediate mode into the batched DebugDraw.
+        - Drew the scene into a framebuffer for the editor's viewport.
+        - Took animation frames from each entity instead of one shared AnimationData.
         
  File Contributions: Liu YaoTing (50%), Javier Chua (50%)
 
 /*_______________________________________________________________________________________________________________*/
 
 #include "GraphicsSystem.h"
+#include "GLStateCache.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 #include <iostream>
 #include "GlobalCoordinator.h"
-#include "GUIGameViewport.h"
+#include "Tilemap.h"
 
 
 #define ASSERT(x) if (!(x)) __debugbreak();
@@ -55,9 +60,9 @@ static bool GLLogCall(const char* function, const char* file, int line) {
 
 // Function to load a texture from a file
 GraphicsSystem::GraphicsSystem()
-    : m_VAO(0), m_VBO(0), m_UVBO(0), m_EBO(0), m_Texture(0), is_animated(0), m_Texture2(0), m_Texture3(0) {
-    // Initialize AnimationData with total frames, frame duration, columns, rows of the spritesheet
-    m_AnimationData = std::make_unique<AnimationData>(48, 0.03f, 4, 6);
+    : m_VAO(0), m_VBO(0), m_UVBO(0), m_EBO(0), m_Texture(0), is_animated(0), m_Texture2(0), m_Texture3(0),
+      m_TextureShader(invalidShaderHandle), m_ColorShader(invalidShaderHandle), m_DebugShader(invalidShaderHandle), m_TextureModelUniform(-1), m_ColorModelUniform(-1),
+      m_ResolvedTextureShader(nullptr), m_ResolvedColorShader(nullptr) {
     vps = new std::vector<GLViewport>();
     vps->push_back({ 0, 0, GLFWFunctions::windowWidth, GLFWFunctions::windowHeight });
     glViewport((*vps)[0].x, (*vps)[0].y, (*vps)[0].width, (*vps)[0].height);
@@ -114,7 +119,7 @@ void GraphicsSystem::initialise() {
     };
 
     glGenVertexArrays(1, &m_VAO);
-    glBindVertexArray(m_VAO);
+    GLStateCache::BindVertexArray(m_VAO);
 
     // Position VBO
     glGenBuffers(1, &m_VBO);
@@ -137,41 +142,26 @@ void GraphicsSystem::initialise() {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
 
-    assetsManager.GetShader("shader2")->Bind();
+    // Resolve the shaders once instead of by name per draw, their uniforms
+    // are looked up again whenever a slot is given a new shader
+    m_TextureShader = assetsManager.GetShaderHandle("shader1");
+    m_ColorShader = assetsManager.GetShaderHandle("shader2");
+    m_DebugShader = assetsManager.GetShaderHandle("debugShader");
+    ResolveShaderUniforms();
 
-    int location = assetsManager.GetShader("shader2")->GetUniformLocation("u_Color");
-    ASSERT(location != -1);
-    GLCall(glUniform4f(location, 0.8f, 0.3f, 0.8f, 1.0f));
-
-    assetsManager.GetShader("shader2")->Unbind();
+    spriteBatch.initialise();
+    debugDraw.initialise();
+    sceneFramebuffer.setSize(GLFWFunctions::windowWidth, GLFWFunctions::windowHeight);
 }
 
 void GraphicsSystem::update() {}
 
-void GraphicsSystem::Update(float deltaTime, GLboolean isAnimated) {
-    if (isAnimated == GL_TRUE) {
-        if (!GameViewWindow::getPaused()) {
-            m_AnimationData->Update(deltaTime);
-        }
-        //m_AnimationData->Update(deltaTime);
-        const auto& uvCoords = m_AnimationData->GetCurrentUVs();
-
-        glBindBuffer(GL_ARRAY_BUFFER, m_UVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec2) * 4, uvCoords.data());
-    }
-    else {
-        // Update the UV coordinates for the current frame
-        float uvCoord[] = {
-            1.0f, 1.0f,  // top right
-            1.0f, 0.0f,  // bottom right
-            0.0f, 0.0f,  // bottom left
-            0.0f, 1.0f   // top left
-        };
-        glBindBuffer(GL_ARRAY_BUFFER, m_UVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec2) * 4, uvCoord);
-    }
-
-    GLint w{ GLFWFunctions::windowWidth }, h{ GLFWFunctions::windowHeight };
+// Animation frames are picked by AnimationSystemECS and go into the sprite
+// batch with each quad, so only the viewport is left to update here
+void GraphicsSystem::UpdateViewport() {
+    // The scene framebuffer has its own size while the editor is open
+    GLint w{ sceneFramebuffer.isBound() ? sceneFramebuffer.getWidth() : GLFWFunctions::windowWidth };
+    GLint h{ sceneFramebuffer.isBound() ? sceneFramebuffer.getHeight() : GLFWFunctions::windowHeight };
     static GLint old_w{}, old_h{};
     // update viewport settings in vps only if window's dimension change
     if (w != old_w || h != old_h)
@@ -190,17 +180,46 @@ void GraphicsSystem::Render(float deltaTime) {
 
 void GraphicsSystem::cleanup() {
     ReleaseResources();
-    delete m_AnimationData.release();
     delete vps;
     vps = nullptr;
 }
 
 void GraphicsSystem::ReleaseResources() {
+    spriteBatch.cleanup();
+    debugDraw.cleanup();
+    sceneFramebuffer.cleanup();
+
     glDeleteBuffers(1, &m_EBO);
     glDeleteBuffers(1, &m_UVBO);
     glDeleteBuffers(1, &m_VBO);
-    glDeleteTextures(1, &m_Texture);
-    glDeleteVertexArrays(1, &m_VAO);
+    GLStateCache::DeleteTextures(1, &m_Texture);
+    GLStateCache::DeleteVertexArrays(1, &m_VAO);
+
+    for (auto& tilemap : tilemapMeshes) {
+        for (auto& chunk : tilemap.second) {
+            DeleteChunkMesh(chunk.second);
+        }
+    }
+    tilemapMeshes.clear();
+}
+
+void GraphicsSystem::DeleteChunkMesh(TilemapChunkMesh& mesh) {
+    glDeleteBuffers(1, &mesh.ebo);
+    glDeleteBuffers(1, &mesh.uvbo);
+    glDeleteBuffers(1, &mesh.vbo);
+    GLStateCache::DeleteVertexArrays(1, &mesh.vao);
+}
+
+void GraphicsSystem::ReleaseTilemapMeshes(Entity entity) {
+    auto meshes = tilemapMeshes.find(entity);
+    if (meshes == tilemapMeshes.end()) {
+        return;
+    }
+
+    for (auto& chunk : meshes->second) {
+        DeleteChunkMesh(chunk.second);
+    }
+    tilemapMeshes.erase(meshes);
 }
 
 myMath::Matrix3x3 GraphicsSystem::UpdateObject(myMath::Vector2D objPos, myMath::Vector2D objScale, myMath::Vector2D objOri, myMath::Matrix3x3 viewMatrix) {
@@ -243,156 +262,214 @@ myMath::Matrix3x3 GraphicsSystem::UpdateObject(myMath::Vector2D objPos, myMath::
     return final_xform;
 }
 
+// The outlines are only collected here and drawn together when the sprites are flushed
 void GraphicsSystem::drawDebugOBB(TransformComponent transform, myMath::Matrix3x3 viewMatrix) {
+    debugDraw.addBox(transform.position, transform.scale, transform.orientation.GetX(), viewMatrix);
+}
 
-    glBegin(GL_LINES);
-
-    // Set color for debug lines
-    glColor3f(1.0f, 0.0f, 0.0f); // Red color for debug lines
-
-    float left, right, top, bottom;
-    left = -transform.scale.GetX() / 2.0f;
-    right = transform.scale.GetX() / 2.0f;
-    top = transform.scale.GetY() / 2.0f;
-    bottom = -transform.scale.GetY() / 2.0f;
-
-    // Define the corners of the AABB in homogeneous coordinates
-    glm::vec4 bottomLeft(left, bottom, 0.0f, 1.0f);
-    glm::vec4 bottomRight(right, bottom, 0.0f, 1.0f);
-    glm::vec4 topRight(right, top, 0.0f, 1.0f);
-    glm::vec4 topLeft(left, top, 0.0f, 1.0f);
-
-    glm::mat3 viewMat = myMath::Matrix3x3::ConvertToGLMMat3(viewMatrix);
+// Assumes the scale's X is the diameter
+void GraphicsSystem::drawDebugCircle(TransformComponent transform, myMath::Matrix3x3 viewMatrix) {
+    debugDraw.addCircle(transform.position, transform.scale.GetX() / 2.0f, transform.orientation.GetX(), viewMatrix);
+}
 
-    // Create the projection matrix
-    glm::mat4 projMat = glm::ortho(
-        -GLFWFunctions::windowWidth / 2.0f,  // left
-        GLFWFunctions::windowWidth / 2.0f,   // right
-        -GLFWFunctions::windowHeight / 2.0f, // bottom
-        GLFWFunctions::windowHeight / 2.0f   // top
-    );
-    glm::mat4 viewMat4 = {
-        viewMat[0][0], viewMat[0][1], viewMat[0][2], 0,
-        viewMat[1][0], viewMat[1][1], viewMat[1][2], 0,
-        0,             0,             viewMat[2][2], 0,
-        viewMat[2][0], viewMat[2][1], 1,             1
-    };
-    // Define the rotation angle (in radians)
-    float angle = glm::radians(transform.orientation.GetX()); // Example: 45 degrees
 
-    // Create the rotation matrix
-    glm::mat4 rotationMat = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 0.0f, 1.0f));
+// A dropped shader file replaces the shader in its slot, so the uniforms
+// cached from the old program are looked up again on the new one
+void GraphicsSystem::ResolveShaderUniforms() {
+    Shader* textureShader = assetsManager.GetShader(m_TextureShader);
+    if (textureShader != m_ResolvedTextureShader) {
+        m_ResolvedTextureShader = textureShader;
+        m_TextureModelUniform = textureShader ? textureShader->GetUniformHandle("uModel_to_NDC") : -1;
+        if (!textureShader) {
+            std::cout << "Error: texture shader \"shader1\" is not loaded" << std::endl;
+        }
+    }
 
-    // Define the translation vector using transform.position
-    glm::vec3 translationVec(transform.position.GetX(), transform.position.GetY(), 0.0f);
+    Shader* colorShader = assetsManager.GetShader(m_ColorShader);
+    if (colorShader == m_ResolvedColorShader) {
+        return;
+    }
+    m_ResolvedColorShader = colorShader;
+    m_ColorModelUniform = colorShader ? colorShader->GetUniformHandle("uModel_to_NDC") : -1;
+    if (!colorShader) {
+        std::cout << "Error: colour shader \"shader2\" is not loaded" << std::endl;
+        return;
+    }
 
-    // Create the translation matrix
-    glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), translationVec);
+    colorShader->Bind();
 
-    // Apply the projection, view, rotation, and translation matrices to each corner
-    bottomLeft = projMat * viewMat4 * translationMat * rotationMat * bottomLeft;
-    bottomRight = projMat * viewMat4 * translationMat * rotationMat * bottomRight;
-    topRight = projMat * viewMat4 * translationMat * rotationMat * topRight;
-    topLeft = projMat * viewMat4 * translationMat * rotationMat * topLeft;
+    int location = colorShader->GetUniformLocation("u_Color");
+    ASSERT(location != -1);
+    GLCall(glUniform4f(location, 0.8f, 0.3f, 0.8f, 1.0f));
 
-    // Draw the AABB lines using the transformed coordinates
-    glVertex2f(bottomLeft.x, bottomLeft.y);   // Bottom left
-    glVertex2f(bottomRight.x, bottomRight.y); // Bottom right
+    colorShader->Unbind();
+}
 
-    glVertex2f(bottomRight.x, bottomRight.y); // Bottom right
-    glVertex2f(topRight.x, topRight.y);       // Top right
+void GraphicsSystem::DrawObject(DrawMode mode, const GLuint texture, myMath::Matrix3x3 xform) {
+    // load shader program in use by this object
+    ResolveShaderUniforms();
+    Shader* shader = mode == DrawMode::TEXTURE ? m_ResolvedTextureShader : m_ResolvedColorShader;
+    if (!shader) {
+        return;
+    }
+    int modelUniform = mode == DrawMode::TEXTURE ? m_TextureModelUniform : m_ColorModelUniform;
+    shader->Bind();
+    GLStateCache::BindVertexArray(m_VAO);
+    GLStateCache::BindTexture(texture);
+    glm::mat3 mdl_xform(1.0f);
+    mdl_xform = myMath::Matrix3x3::ConvertToGLMMat3(xform);
 
-    glVertex2f(topRight.x, topRight.y);       // Top right
-    glVertex2f(topLeft.x, topLeft.y);         // Top left
+    if (modelUniform != -1) {
+        shader->SetUniformMatrix3f(modelUniform, mdl_xform);
+    }
 
-    glVertex2f(topLeft.x, topLeft.y);         // Top left
-    glVertex2f(bottomLeft.x, bottomLeft.y);   // Back to bottom left
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL);
 
-    glEnd();
+    // unbind VAO
+    GLStateCache::BindVertexArray(0);
+    GLStateCache::BindTexture(0);
+    shader->Unbind();
 }
 
-void GraphicsSystem::drawDebugCircle(TransformComponent transform, myMath::Matrix3x3 viewMatrix) {
-
-    glBegin(GL_LINE_LOOP); // Use GL_LINE_LOOP to connect the points in a circular loop
+void GraphicsSystem::DrawSprite(DrawMode mode, const GLuint texture, myMath::Matrix3x3 xform, SpriteLayer layer, const AnimationFrameUV* frame) {
+    if (mode == DrawMode::COLOR) {
+        // Same colour shader2 is given in initialise
+        SpriteBatch::Quad quad{};
+        quad.xform = xform;
+        quad.texture = 0;
+        quad.tint[0] = 0.8f;
+        quad.tint[1] = 0.3f;
+        quad.tint[2] = 0.8f;
+        quad.tint[3] = 1.0f;
+        spriteBatch.submit(quad, static_cast<int>(layer));
+        return;
+    }
 
-    // Set color for debug circle
-    glColor3f(1.0f, 0.0f, 0.0f); // Green color for debug circle
+    DrawSprite(AtlasSprite{ texture, 0.f, 0.f, 1.f, 1.f }, xform, layer, frame);
+}
 
-    // Define the radius of the circle (assuming scale's X represents the diameter)
-    float radius = transform.scale.GetX() / 2.0f;
+void GraphicsSystem::DrawSprite(const AtlasSprite& sprite, myMath::Matrix3x3 xform, SpriteLayer layer, const AnimationFrameUV* frame, size_t list) {
+    SpriteBatch::Quad quad{};
+    quad.xform = xform;
+    quad.texture = sprite.texture;
+    quad.tint[0] = quad.tint[1] = quad.tint[2] = quad.tint[3] = 1.0f;
+
+    float u0 = sprite.u0, v0 = sprite.v0, u1 = sprite.u1, v1 = sprite.v1;
+    if (frame) {
+        u0 = sprite.u0 + frame->u0 * (sprite.u1 - sprite.u0);
+        u1 = sprite.u0 + frame->u1 * (sprite.u1 - sprite.u0);
+        v0 = sprite.v0 + frame->v0 * (sprite.v1 - sprite.v0);
+        v1 = sprite.v0 + frame->v1 * (sprite.v1 - sprite.v0);
+    }
 
-    // Define the number of segments for the circle approximation
-    int numSegments = 100; // Higher value gives smoother circle
+    quad.uvs[0] = myMath::Vector2D(u1, v1);
+    quad.uvs[1] = myMath::Vector2D(u1, v0);
+    quad.uvs[2] = myMath::Vector2D(u0, v0);
+    quad.uvs[3] = myMath::Vector2D(u0, v1);
 
-    // Define the rotation angle (in radians)
-    float angle = glm::radians(transform.orientation.GetX());
+    if (list == 0) {
+        spriteBatch.submit(quad, static_cast<int>(layer));
+    }
+    else {
+        SpriteBatch::Record(spriteBatch.getQueue().getList(list), quad, static_cast<int>(layer));
+    }
+}
 
-    // Create the rotation matrix
-    glm::mat4 rotationMat = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 0.0f, 1.0f));
+void GraphicsSystem::BeginScene() {
+    if (GLFWFunctions::debug_flag) {
+        sceneFramebuffer.bind();
+    }
+}
 
-    // Define the translation vector using transform.position
-    glm::vec3 translationVec(transform.position.GetX(), transform.position.GetY(), 0.0f);
+void GraphicsSystem::EndScene() {
+    sceneFramebuffer.unbind(GLFWFunctions::windowWidth, GLFWFunctions::windowHeight);
+}
 
-    // Create the translation matrix
-    glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), translationVec);
+void GraphicsSystem::FlushSprites() {
+    // All the debug lines go out in one draw on top of the sprites
+    if (!debugDraw.empty()) {
+        spriteBatch.submitCustom(static_cast<int>(SpriteLayer::DEBUG), [this]() {
+            debugDraw.flush(assetsManager.GetShader(m_DebugShader));
+        });
+    }
+    spriteBatch.flush();
+}
 
-    // Convert the view matrix
-    glm::mat3 viewMat = myMath::Matrix3x3::ConvertToGLMMat3(viewMatrix);
-    glm::mat4 viewMat4 = {
-        viewMat[0][0], viewMat[0][1], viewMat[0][2], 0,
-        viewMat[1][0], viewMat[1][1], viewMat[1][2], 0,
-        0,             0,             viewMat[2][2], 0,
-        viewMat[2][0], viewMat[2][1], 1,             1
-    };
+void GraphicsSystem::DrawTilemap(Entity entity, const TilemapComponent& tilemap, myMath::Vector2D origin, myMath::Matrix3x3 viewMatrix, const SpriteCuller::Bounds& viewBounds) {
+    auto& meshes = tilemapMeshes[entity];
+    Tilemap::ChunkMesh meshData;
 
-    // Create the projection matrix
-    glm::mat4 projMat = glm::ortho(
-        -GLFWFunctions::windowWidth / 2.0f,  // left
-        GLFWFunctions::windowWidth / 2.0f,   // right
-        -GLFWFunctions::windowHeight / 2.0f, // bottom
-        GLFWFunctions::windowHeight / 2.0f   // top
-    );
+    // Meshes of chunks that were removed from the tilemap
+    for (auto mesh = meshes.begin(); mesh != meshes.end();) {
+        if (tilemap.chunkIndex.count(mesh->first)) {
+            ++mesh;
+            continue;
+        }
+        DeleteChunkMesh(mesh->second);
+        mesh = meshes.erase(mesh);
+    }
 
-    // Iterate over each segment to compute the vertices of the circle
-    for (int i = 0; i < numSegments; ++i) {
-        float theta = 2.0f * glm::pi<float>() * float(i) / float(numSegments); // Current angle
+    ResolveShaderUniforms();
+    Shader* shader = m_ResolvedTextureShader;
+    if (!shader) {
+        return;
+    }
+    shader->Bind();
+    GLStateCache::BindTexture(assetsManager.GetTexture(tilemap.tileset));
 
-        // Calculate the position of each point on the circle in local coordinates
-        glm::vec4 point(radius * cos(theta), radius * sin(theta), 0.0f, 1.0f);
+    // chunk vertices are already in world units, only the origin moves them
+    glm::mat3 mdl_xform = myMath::Matrix3x3::ConvertToGLMMat3(UpdateObject(origin, { 1.f, 1.f }, { 0.f, 0.f }, viewMatrix));
+    if (m_TextureModelUniform != -1) {
+        shader->SetUniformMatrix3f(m_TextureModelUniform, mdl_xform);
+    }
 
-        // Apply transformation matrices
-        point = projMat * viewMat4 * translationMat * rotationMat * point;
+    for (const auto& chunk : tilemap.chunks) {
+        // Chunks out of view are skipped, their meshes are built when they first come into view
+        if (!SpriteCuller::Overlaps(Tilemap::GetChunkBounds(tilemap, origin, chunk.chunkX, chunk.chunkY), viewBounds)) {
+            continue;
+        }
 
-        // Render the vertex
-        glVertex2f(point.x, point.y);
-    }
+        auto inserted = meshes.emplace(Tilemap::getChunkKey(chunk.chunkX, chunk.chunkY), TilemapChunkMesh{});
+        TilemapChunkMesh& mesh = inserted.first->second;
+
+        if (inserted.second) {
+            glGenVertexArrays(1, &mesh.vao);
+            glGenBuffers(1, &mesh.vbo);
+            glGenBuffers(1, &mesh.uvbo);
+            glGenBuffers(1, &mesh.ebo);
+
+            GLStateCache::BindVertexArray(mesh.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+            glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(0);
+            glBindBuffer(GL_ARRAY_BUFFER, mesh.uvbo);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(1);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+        }
+        else {
+            GLStateCache::BindVertexArray(mesh.vao);
+        }
 
-    glEnd();
-}
+        if (inserted.second || mesh.revision != chunk.revision) {
+            Tilemap::BuildChunkMesh(tilemap, chunk, meshData);
 
+            glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+            glBufferData(GL_ARRAY_BUFFER, meshData.positions.size() * sizeof(float), meshData.positions.data(), GL_STATIC_DRAW);
+            glBindBuffer(GL_ARRAY_BUFFER, mesh.uvbo);
+            glBufferData(GL_ARRAY_BUFFER, meshData.uvs.size() * sizeof(float), meshData.uvs.data(), GL_STATIC_DRAW);
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, meshData.indices.size() * sizeof(unsigned int), meshData.indices.data(), GL_STATIC_DRAW);
 
-void GraphicsSystem::DrawObject(DrawMode mode, const GLuint texture, myMath::Matrix3x3 xform) {
-    // load shader program in use by this object
-    if (mode == DrawMode::TEXTURE)
-        assetsManager.GetShader("shader1")->Bind();
-    else
-        assetsManager.GetShader("shader2")->Bind();
-    glBindVertexArray(m_VAO);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glm::mat3 mdl_xform(1.0f);
-    mdl_xform = myMath::Matrix3x3::ConvertToGLMMat3(xform);
+            mesh.indexCount = static_cast<GLsizei>(meshData.indices.size());
+            mesh.revision = chunk.revision;
+        }
 
-    GLint uniformLoc = assetsManager.GetShader("shader2")->GetUniformLocation("uModel_to_NDC");
-    if (uniformLoc != -1) {
-        glUniformMatrix3fv(uniformLoc, 1, GL_FALSE, glm::value_ptr(mdl_xform));
+        if (mesh.indexCount > 0) {
+            glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, NULL);
+        }
     }
 
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL);
-
-    // unbind VAO
-    glBindVertexArray(0);
-    glBindTexture(GL_TEXTURE_2D, 0);
-    assetsManager.GetShader("shader2")->Unbind();
+    GLStateCache::BindVertexArray(0);
+    GLStateCache::BindTexture(0);
+    shader->Unbind();
 }
-
-
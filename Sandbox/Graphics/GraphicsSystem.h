@@ -17,6 +17,9 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 *       - Implemented the the basic structure of the GraphicsSystem class that inherits from GameSystems,
 *         such as the constructor, destructor, initialise, update, and cleanup functions,
 *         as well as the data members.
+*       - Added the sprite culler that picks out the sprites inside the camera's view.
+*       - Added the batched debug line drawing.
+*       - Added the framebuffer the scene is drawn into for the editor's viewport.
 *
 * File Contributions: Liu YaoTing (50%), Javier Chua (50%)
 *
@@ -38,6 +41,14 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "vector3D.h"
 #include "matrix3x3.h"
 #include "TransformComponent.h"
+#include "TilemapComponent.h"
+#include "SpriteBatch.h"
+#include "SpriteCuller.h"
+#include "DebugDraw.h"
+#include "SceneFramebuffer.h"
+#include "AtlasSprite.h"
+#include "ECSDefinitions.h"
+#include <unordered_map>
 
 
 class GraphicsSystem : public GameSystems
@@ -53,7 +64,8 @@ public:
 
     void initialise() override;
     void update() override;
-    void Update(float deltaTime, GLboolean isAnimated);
+    // Once a frame, follows the window's or the scene framebuffer's size
+    void UpdateViewport();
     void Render(float deltaTime);
     void cleanup() override;
     SystemType getSystem() override; //For perfomance viewer
@@ -61,6 +73,35 @@ public:
     myMath::Matrix3x3 UpdateObject(myMath::Vector2D objPos, myMath::Vector2D objScale, myMath::Vector2D objOri, myMath::Matrix3x3 viewMat);
     void DrawObject(DrawMode mode, const GLuint texture, myMath::Matrix3x3 xform);
 
+    // Queues a quad in the sprite batch instead of drawing it right away.
+    // Animated sprites pass the UVs of their entity's current frame
+    void DrawSprite(DrawMode mode, const GLuint texture, myMath::Matrix3x3 xform, SpriteLayer layer, const AnimationFrameUV* frame = nullptr);
+
+    // Same as above for a sprite that may sit in an atlas page. Animation
+    // frames are picked inside the sprite's part of the page. Worker threads
+    // pass the render queue list they were given, only list 0 is for this thread
+    void DrawSprite(const AtlasSprite& sprite, myMath::Matrix3x3 xform, SpriteLayer layer, const AnimationFrameUV* frame = nullptr, size_t list = 0);
+
+    // Draws everything queued this frame, layer by layer
+    void FlushSprites();
+    SpriteBatch& GetSpriteBatch() { return spriteBatch; }
+    SpriteCuller& GetSpriteCuller() { return spriteCuller; }
+    DebugDraw& GetDebugDraw() { return debugDraw; }
+
+    // While the editor is open the scene is drawn into the framebuffer shown in
+    // the game viewport panel. EndScene goes back to the window for the editor
+    void BeginScene();
+    void EndScene();
+    SceneFramebuffer& GetSceneFramebuffer() { return sceneFramebuffer; }
+
+    // Draws every chunk of a tilemap in view with one draw call each. A chunk's
+    // mesh is only uploaded again after one of its tiles changes
+    void DrawTilemap(Entity entity, const TilemapComponent& tilemap, myMath::Vector2D origin, myMath::Matrix3x3 viewMatrix, const SpriteCuller::Bounds& viewBounds);
+
+    // Frees the chunk meshes kept for an entity, called when it is destroyed so
+    // a reused entity id starts without them
+    void ReleaseTilemapMeshes(Entity entity);
+
     GLuint GetVAO() const { return m_VAO; }
 
     struct GLViewport {
@@ -69,6 +110,8 @@ public:
     };
 
     std::vector<GLViewport>* vps; // container for viewports
+
+    // Queue a debug outline, drawn with the rest of the frame's lines at FlushSprites
     void drawDebugOBB(TransformComponent transform, myMath::Matrix3x3 viewMatrix);
 	void drawDebugCircle(const TransformComponent transform, const myMath::Matrix3x3 viewMatrix);
 
@@ -80,8 +123,30 @@ private:
     GLuint m_Texture, m_Texture2, m_Texture3;
     GLboolean is_animated;
     std::unique_ptr<Shader> m_Shader, m_Shader2;
-    std::unique_ptr<AnimationData> m_AnimationData;  // Pointer to the AnimationData instance
-    std::unique_ptr<AnimationData> idleAnimation;  // Pointer to the AnimationData instance
+    ShaderHandle m_TextureShader, m_ColorShader, m_DebugShader;
+    int m_TextureModelUniform, m_ColorModelUniform;   // uModel_to_NDC of each shader
+    Shader* m_ResolvedTextureShader, *m_ResolvedColorShader;   // shaders the uniforms were looked up on
+    SpriteBatch spriteBatch;
+    SpriteCuller spriteCuller;
+    DebugDraw debugDraw;
+    SceneFramebuffer sceneFramebuffer;
+
+    struct TilemapChunkMesh {
+        GLuint vao;
+        GLuint vbo;
+        GLuint uvbo;
+        GLuint ebo;
+        GLsizei indexCount;
+        uint64_t revision;
+    };
+
+    // Chunk meshes of each tilemap entity, by chunk key
+    std::unordered_map<Entity, std::unordered_map<uint64_t, TilemapChunkMesh>> tilemapMeshes;
+
+    static void DeleteChunkMesh(TilemapChunkMesh& mesh);
+
+    // Looks the cached uniforms up again if either shader slot has changed
+    void ResolveShaderUniforms();
 
     void ReleaseResources();
 };
@@ -0,0 +1,166 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  RenderQueue.cpp
+@brief  :  This file contains the implementation of the command lists, the
+           gathering and radix sorting of the render queue, and the recording
+           backend.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Implemented gathering the command lists and the radix sort.
+*       - Implemented the RecordingBackend.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#include "RenderQueue.h"
+#include <array>
+#include <sstream>
+
+void RenderCommandList::addQuad(uint64_t key, const RenderQuad& quad) {
+    commands.push_back({ key, static_cast<uint32_t>(quads.size()), RenderCommandType::QUAD });
+    quads.push_back(quad);
+}
+
+void RenderCommandList::addCustom(uint64_t key, std::function<void()> callback) {
+    commands.push_back({ key, static_cast<uint32_t>(callbacks.size()), RenderCommandType::CUSTOM });
+    callbacks.push_back(std::move(callback));
+}
+
+void RenderCommandList::clear() {
+    commands.clear();
+    quads.clear();
+    callbacks.clear();
+}
+
+RenderQueue::RenderQueue() : lists(1) {}
+
+void RenderQueue::setListCount(size_t count) {
+    lists.resize(count < 1 ? 1 : count);
+}
+
+void RenderQueue::sort() {
+    sorted.clear();
+    quads.clear();
+    callbacks.clear();
+
+    // Payloads index into their own list, so shift them past the lists before
+    for (auto& list : lists) {
+        uint32_t quadOffset = static_cast<uint32_t>(quads.size());
+        uint32_t callbackOffset = static_cast<uint32_t>(callbacks.size());
+
+        for (const auto& command : list.commands) {
+            RenderCommand gathered = command;
+            gathered.payload += command.type == RenderCommandType::QUAD ? quadOffset : callbackOffset;
+            sorted.push_back(gathered);
+        }
+
+        quads.insert(quads.end(), list.quads.begin(), list.quads.end());
+        for (auto& callback : list.callbacks) {
+            callbacks.push_back(std::move(callback));
+        }
+        list.clear();
+    }
+
+    RadixSort(sorted, scratch);
+}
+
+size_t RenderQueue::getQuadCount() const {
+    size_t count = quads.size();
+    for (const auto& list : lists) {
+        count += list.quads.size();
+    }
+    return count;
+}
+
+void RenderQueue::clear() {
+    for (auto& list : lists) {
+        list.clear();
+    }
+    sorted.clear();
+    quads.clear();
+    callbacks.clear();
+}
+
+void RenderQueue::RadixSort(std::vector<RenderCommand>& commands, std::vector<RenderCommand>& scratch) {
+    const size_t count = commands.size();
+    if (count < 2) {
+        return;
+    }
+
+    // Count every byte of every key in one read
+    std::array<std::array<size_t, 256>, 8> histograms{};
+    for (const auto& command : commands) {
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(command.key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    scratch.resize(count);
+    std::vector<RenderCommand>* source = &commands;
+    std::vector<RenderCommand>* destination = &scratch;
+
+    for (int pass = 0; pass < 8; pass++) {
+        auto& histogram = histograms[pass];
+        int shift = pass * 8;
+
+        if (histogram[((*source)[0].key >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        std::array<size_t, 256> offsets;
+        size_t offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            offsets[digit] = offset;
+            offset += histogram[digit];
+        }
+
+        for (const auto& command : *source) {
+            (*destination)[offsets[(command.key >> shift) & 0xFF]++] = command;
+        }
+        std::swap(source, destination);
+    }
+
+    if (source != &commands) {
+        commands.swap(scratch);
+    }
+}
+
+void RecordingBackend::beginFrame(const std::vector<RenderVertex>& vertices) {
+    // Hash the vertex stream so a change in any vertex shows up in the log
+    uint64_t hash = 14695981039346656037ull;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(vertices.data());
+    for (size_t i = 0; i < vertices.size() * sizeof(RenderVertex); i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    std::ostringstream line;
+    line << "frame " << frames << " vertices " << vertices.size() << " hash " << std::hex << hash << "\n";
+    recording += line.str();
+}
+
+void RecordingBackend::drawQuads(uint32_t shader, GLuint texture, size_t firstQuad, size_t quadCount) {
+    std::ostringstream line;
+    line << "draw shader " << shader << " texture " << texture << " first " << firstQuad << " count " << quadCount << "\n";
+    recording += line.str();
+    drawCalls++;
+}
+
+void RecordingBackend::runCustom(const std::function<void()>&) {
+    recording += "custom\n";
+}
+
+void RecordingBackend::endFrame() {
+    recording += "end\n";
+    frames++;
+}
+
+void RecordingBackend::reset() {
+    recording.clear();
+    drawCalls = 0;
+    frames = 0;
+}
@@ -0,0 +1,167 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  RenderQueue.h
+@brief  :  This file contains the declaration of the render command queue. Draws
+           are recorded as small commands with a 64 bit sort key made of the
+           layer, shader, texture and depth. Each thread records into its own
+           command list, the lists are gathered in a fixed order and radix
+           sorted by key, and a RenderBackend executes the result. The
+           RecordingBackend writes the commands out instead of drawing them,
+           for checking and timing the command building without a GPU.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Declared the sort keys, command lists, the RenderQueue class and the
+*         render backends.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "vector2D.h"
+#include "matrix3x3.h"
+
+// Bits of the sort key, from the most significant: layer, shader, texture, depth
+namespace RenderKey
+{
+    constexpr int layerBits = 8;
+    constexpr int shaderBits = 8;
+    constexpr int textureBits = 24;
+    constexpr int depthBits = 24;
+
+    constexpr int depthShift = 0;
+    constexpr int textureShift = depthShift + depthBits;
+    constexpr int shaderShift = textureShift + textureBits;
+    constexpr int layerShift = shaderShift + shaderBits;
+
+    constexpr uint64_t Make(uint32_t layer, uint32_t shader, uint32_t texture, uint32_t depth) {
+        return (static_cast<uint64_t>(layer & ((1u << layerBits) - 1)) << layerShift) |
+               (static_cast<uint64_t>(shader & ((1u << shaderBits) - 1)) << shaderShift) |
+               (static_cast<uint64_t>(texture & ((1u << textureBits) - 1)) << textureShift) |
+               (static_cast<uint64_t>(depth & ((1u << depthBits) - 1)) << depthShift);
+    }
+
+    constexpr uint32_t Layer(uint64_t key) { return static_cast<uint32_t>(key >> layerShift) & ((1u << layerBits) - 1); }
+    constexpr uint32_t Shader(uint64_t key) { return static_cast<uint32_t>(key >> shaderShift) & ((1u << shaderBits) - 1); }
+    constexpr uint32_t Texture(uint64_t key) { return static_cast<uint32_t>(key >> textureShift) & ((1u << textureBits) - 1); }
+    constexpr uint32_t Depth(uint64_t key) { return static_cast<uint32_t>(key >> depthShift) & ((1u << depthBits) - 1); }
+}
+
+// Per vertex data of the sprite stream: NDC position, texture coordinates and tint
+struct RenderVertex {
+    float x, y;
+    float u, v;
+    float r, g, b, a;
+};
+
+struct RenderQuad {
+    myMath::Matrix3x3 xform;        // model to NDC of a unit quad centered on the origin
+    myMath::Vector2D uvs[4];        // top right, bottom right, bottom left, top left
+    GLuint texture;                 // 0 draws the tint alone
+    float tint[4];
+};
+
+enum class RenderCommandType : uint8_t {
+    QUAD,       // payload indexes the quads
+    CUSTOM      // payload indexes the callbacks, for things drawn with their own meshes
+};
+
+struct RenderCommand {
+    uint64_t key;
+    uint32_t payload;
+    RenderCommandType type;
+};
+
+// Commands recorded by one thread, with the quads and callbacks they refer to
+class RenderCommandList
+{
+public:
+    void addQuad(uint64_t key, const RenderQuad& quad);
+    void addCustom(uint64_t key, std::function<void()> callback);
+    void clear();
+
+    size_t size() const { return commands.size(); }
+
+private:
+    friend class RenderQueue;
+
+    std::vector<RenderCommand> commands;
+    std::vector<RenderQuad> quads;
+    std::vector<std::function<void()>> callbacks;
+};
+
+class RenderQueue
+{
+public:
+    RenderQueue();
+
+    // One list per recording thread. List 0 is for the main thread
+    void setListCount(size_t count);
+    size_t getListCount() const { return lists.size(); }
+    RenderCommandList& getList(size_t index) { return lists[index]; }
+
+    // Appends the lists in index order and sorts the commands by key. Equal
+    // keys keep their gathered order, so it does not matter which thread
+    // finished recording first
+    void sort();
+
+    const std::vector<RenderCommand>& getCommands() const { return sorted; }
+    const RenderQuad& getQuad(const RenderCommand& command) const { return quads[command.payload]; }
+    const std::function<void()>& getCallback(const RenderCommand& command) const { return callbacks[command.payload]; }
+    size_t getQuadCount() const;
+
+    // Drops everything recorded since the last clear
+    void clear();
+
+    // Stable least significant digit radix sort on the keys, a byte per pass.
+    // Passes where every key has the same byte are skipped
+    static void RadixSort(std::vector<RenderCommand>& commands, std::vector<RenderCommand>& scratch);
+
+private:
+    std::vector<RenderCommandList> lists;
+    std::vector<RenderCommand> sorted;
+    std::vector<RenderCommand> scratch;
+    std::vector<RenderQuad> quads;
+    std::vector<std::function<void()>> callbacks;
+};
+
+// Executes a built frame. Quads arrive as runs sharing a shader and texture
+class RenderBackend
+{
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual void beginFrame(const std::vector<RenderVertex>& vertices) = 0;
+    virtual void drawQuads(uint32_t shader, GLuint texture, size_t firstQuad, size_t quadCount) = 0;
+    virtual void runCustom(const std::function<void()>& callback) = 0;
+    virtual void endFrame() = 0;
+};
+
+// Writes each call into a text log instead of drawing. Custom callbacks are
+// logged but not run, since they talk to OpenGL themselves
+class RecordingBackend : public RenderBackend
+{
+public:
+    void beginFrame(const std::vector<RenderVertex>& vertices) override;
+    void drawQuads(uint32_t shader, GLuint texture, size_t firstQuad, size_t quadCount) override;
+    void runCustom(const std::function<void()>& callback) override;
+    void endFrame() override;
+
+    const std::string& getRecording() const { return recording; }
+    size_t getDrawCalls() const { return drawCalls; }
+    size_t getFrameCount() const { return frames; }
+    void reset();
+
+private:
+    std::string recording;
+    size_t drawCalls = 0;
+    size_t frames = 0;
+};
@@ -0,0 +1,359 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  RenderSelfTest.cpp
+@brief  :  This file contains the implementation of the RenderSelfTest class and
+           the scenes each check builds.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Implemented the sprite batching and atlas packing checks.
+*       - Implemented the radix sort and worker list checks.
+*       - Implemented the debug draw check against the old per shape transforms.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#include "RenderSelfTest.h"
+#include "SpriteBatch.h"
+#include "RenderQueue.h"
+#include "AtlasPacker.h"
+#include "WorkerPool.h"
+#include "DebugDraw.h"
+#include "GlfwFunctions.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace
+{
+    // Layer and texture of each batch the sprite checks expect, in draw order
+    struct BatchKey {
+        SpriteLayer layer;
+        GLuint texture;
+    };
+
+    const BatchKey expectedBatches[] = {
+        { SpriteLayer::BACKGROUND, 1 }, { SpriteLayer::BACKGROUND, 2 },
+        { SpriteLayer::LEVEL, 1 }, { SpriteLayer::LEVEL, 2 }, { SpriteLayer::LEVEL, 3 },
+        { SpriteLayer::CHARACTERS, 3 }, { SpriteLayer::CHARACTERS, 4 }
+    };
+    const size_t batchCount = sizeof(expectedBatches) / sizeof(expectedBatches[0]);
+    const size_t spriteQuadCount = 1001;
+
+    // Quad i goes to batch (i * 3) % 7, so neighbouring submits never share a
+    // batch and every batch gets the same number of quads
+    const BatchKey& batchOfQuad(size_t quad) {
+        return expectedBatches[(quad * 3) % batchCount];
+    }
+
+    RenderQuad makeQuad(GLuint texture) {
+        RenderQuad quad{};
+        quad.xform = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f };
+        quad.uvs[0] = myMath::Vector2D(1.f, 1.f);
+        quad.uvs[1] = myMath::Vector2D(1.f, 0.f);
+        quad.uvs[2] = myMath::Vector2D(0.f, 0.f);
+        quad.uvs[3] = myMath::Vector2D(0.f, 1.f);
+        quad.texture = texture;
+        quad.tint[0] = quad.tint[1] = quad.tint[2] = quad.tint[3] = 1.f;
+        return quad;
+    }
+
+    // The built commands must be the expected batches in order, each holding
+    // its share of the quads back to back in the vertex stream
+    bool checkBatches(const SpriteBatch& batch, std::string& problem) {
+        const auto& commands = batch.getCommands();
+        if (commands.size() != batchCount) {
+            problem = std::to_string(commands.size()) + " commands instead of " + std::to_string(batchCount);
+            return false;
+        }
+
+        size_t nextQuad = 0;
+        for (size_t i = 0; i < commands.size(); i++) {
+            const SpriteBatch::Command& command = commands[i];
+            if (command.type != SpriteBatch::CommandType::QUADS || command.layer != static_cast<int>(expectedBatches[i].layer) ||
+                command.texture != expectedBatches[i].texture) {
+                problem = "command " + std::to_string(i) + " is out of order";
+                return false;
+            }
+            if (command.firstQuad != nextQuad || command.quadCount != spriteQuadCount / batchCount) {
+                problem = "command " + std::to_string(i) + " covers the wrong quads";
+                return false;
+            }
+            nextQuad += command.quadCount;
+        }
+
+        if (batch.getVertices().size() != spriteQuadCount * 4) {
+            problem = std::to_string(batch.getVertices().size()) + " vertices instead of " + std::to_string(spriteQuadCount * 4);
+            return false;
+        }
+        return true;
+    }
+
+    const size_t radixKeyCount = 200000;
+    const size_t workerListCount = 3;
+
+    const int atlasPageSize = 256;
+    const int atlasPadding = 2;
+    const int atlasSpriteCount = 40;
+
+    // Whether two packed sprites, grown by the padding, share any pixel
+    bool overlaps(const AtlasRect& a, const AtlasRect& b, int padding) {
+        return a.page == b.page &&
+               a.x - padding < b.x + b.width + padding && b.x - padding < a.x + a.width + padding &&
+               a.y - padding < b.y + b.height + padding && b.y - padding < a.y + a.height + padding;
+    }
+
+    const int debugWindowWidth = 1600;
+    const int debugWindowHeight = 900;
+    const int debugShapeCount = 50;
+    // About two float steps at 1.0, the two paths round in a different order
+    const float debugTolerance = 2.5e-7f;
+
+    // Model to NDC of a debug shape the way drawDebugOBB and drawDebugCircle
+    // built it before DebugDraw, from 4x4 matrices
+    glm::mat4 oldShapeToNDC(myMath::Vector2D position, float rotation, const myMath::Matrix3x3& viewMatrix) {
+        glm::mat3 viewMat = myMath::Matrix3x3::ConvertToGLMMat3(viewMatrix);
+        glm::mat4 projMat = glm::ortho(-GLFWFunctions::windowWidth / 2.0f, GLFWFunctions::windowWidth / 2.0f,
+                                       -GLFWFunctions::windowHeight / 2.0f, GLFWFunctions::windowHeight / 2.0f);
+        glm::mat4 viewMat4 = {
+            viewMat[0][0], viewMat[0][1], viewMat[0][2], 0,
+            viewMat[1][0], viewMat[1][1], viewMat[1][2], 0,
+            0,             0,             viewMat[2][2], 0,
+            viewMat[2][0], viewMat[2][1], 1,             1
+        };
+        glm::mat4 rotationMat = glm::rotate(glm::mat4(1.0f), glm::radians(rotation), glm::vec3(0.0f, 0.0f, 1.0f));
+        glm::mat4 translationMat = glm::translate(glm::mat4(1.0f), glm::vec3(position.GetX(), position.GetY(), 0.0f));
+        return projMat * viewMat4 * translationMat * rotationMat;
+    }
+
+    // Largest distance between a line list vertex and the point it should be at
+    float vertexError(const DebugDraw::Vertex& vertex, const glm::vec4& expected) {
+        return std::max(std::fabs(vertex.x - expected.x), std::fabs(vertex.y - expected.y));
+    }
+
+    bool report(const char* name, bool passed, const std::string& problem) {
+        if (passed) {
+            std::cout << name << ": passed" << std::endl;
+        }
+        else {
+            std::cout << "Error: " << name << " failed, " << problem << std::endl;
+        }
+        return passed;
+    }
+}
+
+bool RenderSelfTest::runAll() {
+    bool passed = true;
+    passed &= checkSpriteBatching();
+    passed &= checkAtlasPacking();
+    passed &= checkRadixSort();
+    passed &= checkWorkerLists();
+    passed &= checkDebugDraw();
+    return passed;
+}
+
+bool RenderSelfTest::checkSpriteBatching() {
+    SpriteBatch batch;
+    for (size_t i = 0; i < spriteQuadCount; i++) {
+        const BatchKey& key = batchOfQuad(i);
+        batch.submit(makeQuad(key.texture), static_cast<int>(key.layer));
+    }
+
+    std::string problem;
+    batch.build();
+    bool passed = checkBatches(batch, problem);
+
+    RecordingBackend recorder;
+    batch.flush(recorder);
+    if (passed && recorder.getDrawCalls() != batchCount) {
+        problem = std::to_string(recorder.getDrawCalls()) + " draw calls instead of " + std::to_string(batchCount);
+        passed = false;
+    }
+
+    return report("sprite batching, 1001 quads over 4 textures and 3 layers", passed, problem);
+}
+
+bool RenderSelfTest::checkAtlasPacking() {
+    AtlasPacker packer(atlasPageSize, atlasPageSize, atlasPadding);
+    for (int i = 0; i < atlasSpriteCount; i++) {
+        packer.Add("sprite" + std::to_string(i), 8 + (i * 37) % 90, 8 + (i * 53) % 70);
+    }
+    packer.Add("tooWide", atlasPageSize, 8);
+    packer.Pack();
+
+    std::string problem;
+    AtlasPacker::Report packReport = packer.GetReport();
+    if (packReport.packedCount != atlasSpriteCount || packReport.rejectedCount != 1) {
+        problem = std::to_string(packReport.packedCount) + " sprites packed and " + std::to_string(packReport.rejectedCount) + " rejected";
+    }
+
+    std::vector<AtlasRect> rects;
+    for (const auto& rect : packer.GetRects()) {
+        const AtlasRect& r = rect.second;
+        if (r.page < 0 || r.page >= packer.GetPageCount() || r.x < atlasPadding || r.y < atlasPadding ||
+            r.x + r.width + atlasPadding > atlasPageSize || r.y + r.height + atlasPadding > atlasPageSize) {
+            problem = rect.first + " is outside its page";
+        }
+        for (const auto& other : rects) {
+            if (overlaps(r, other, atlasPadding)) {
+                problem = rect.first + " overlaps another sprite";
+            }
+        }
+        rects.push_back(r);
+    }
+
+    // A 2x2 sprite with a different colour in each corner of a 6x6 page: the
+    // padding around it takes the colour of the nearest sprite pixel
+    const unsigned char pixels[16] = { 10, 0, 0, 255,  20, 0, 0, 255,
+                                       30, 0, 0, 255,  40, 0, 0, 255 };
+    std::vector<unsigned char> page(6 * 6 * 4, 0);
+    AtlasPacker::Blit(page, 6, 6, pixels, { 0, 2, 2, 2, 2 }, atlasPadding);
+    if (page[0] != 10 || page[(5 * 6) * 4] != 30 || page[(5 * 6 + 5) * 4] != 40 || page[(2 * 6 + 3) * 4] != 20) {
+        problem = "blit did not repeat the edge pixels into the padding";
+    }
+
+    std::cout << "  ";
+    packer.PrintReport(std::cout);
+    return report("atlas packing", problem.empty(), problem);
+}
+
+bool RenderSelfTest::checkRadixSort() {
+    // Keys spread over every byte, but only 64 different layer and shader
+    // pairs and 1000 textures, so most keys are shared by many commands
+    std::mt19937_64 rng(12345u);
+    std::vector<RenderCommand> commands(radixKeyCount);
+    for (size_t i = 0; i < commands.size(); i++) {
+        uint64_t random = rng();
+        uint64_t key = RenderKey::Make(static_cast<uint32_t>(random % 8), static_cast<uint32_t>((random >> 8) % 8),
+                                       static_cast<uint32_t>((random >> 16) % 1000), static_cast<uint32_t>((random >> 32) % 4));
+        commands[i] = { key, static_cast<uint32_t>(i), RenderCommandType::QUAD };
+    }
+
+    std::vector<RenderCommand> expected = commands;
+    std::stable_sort(expected.begin(), expected.end(), [](const RenderCommand& lhs, const RenderCommand& rhs) {
+        return lhs.key < rhs.key;
+    });
+
+    std::vector<RenderCommand> scratch;
+    RenderQueue::RadixSort(commands, scratch);
+
+    std::string problem;
+    for (size_t i = 0; i < commands.size() && problem.empty(); i++) {
+        if (commands[i].key != expected[i].key || commands[i].payload != expected[i].payload) {
+            problem = "command " + std::to_string(i) + " differs from std::stable_sort";
+        }
+    }
+    return report("radix sort, 200k keys against std::stable_sort", problem.empty(), problem);
+}
+
+// Each worker records a slice of the quads into the list of its slice, the
+// same way GraphicSystemECS splits its draw list
+bool RenderSelfTest::checkWorkerLists() {
+    SpriteBatch single;
+    for (size_t i = 0; i < spriteQuadCount; i++) {
+        const BatchKey& key = batchOfQuad(i);
+        single.submit(makeQuad(key.texture), static_cast<int>(key.layer));
+    }
+    single.build();
+
+    SpriteBatch batch;
+    batch.getQueue().setListCount(workerListCount);
+    WorkerPool pool(workerListCount);
+    pool.parallelFor(workerListCount, 1, [&batch](size_t begin, size_t end, size_t) {
+        for (size_t list = begin; list < end; list++) {
+            size_t last = spriteQuadCount * (list + 1) / workerListCount;
+            for (size_t quad = spriteQuadCount * list / workerListCount; quad < last; quad++) {
+                const BatchKey& key = batchOfQuad(quad);
+                SpriteBatch::Record(batch.getQueue().getList(list), makeQuad(key.texture), static_cast<int>(key.layer));
+            }
+        }
+    });
+
+    std::string problem;
+    batch.build();
+    bool passed = checkBatches(batch, problem);
+    if (passed && !std::equal(batch.getVertices().begin(), batch.getVertices().end(), single.getVertices().begin(),
+                              [](const RenderVertex& lhs, const RenderVertex& rhs) {
+                                  return lhs.x == rhs.x && lhs.y == rhs.y && lhs.u == rhs.u && lhs.v == rhs.v;
+                              })) {
+        problem = "the vertex stream differs from recording on one thread";
+        passed = false;
+    }
+
+    RecordingBackend recorder;
+    batch.flush(recorder);
+    if (passed && recorder.getDrawCalls() != batchCount) {
+        problem = std::to_string(recorder.getDrawCalls()) + " draw calls instead of " + std::to_string(batchCount);
+        passed = false;
+    }
+
+    return report("3 worker lists, 1001 quads over 4 textures and 3 layers", passed, problem);
+}
+
+// Boxes and circles over a zoomed and panned view, the old functions drew the
+// box corners and circle points in the same order as the line list
+bool RenderSelfTest::checkDebugDraw() {
+    int windowWidth = GLFWFunctions::windowWidth;
+    int windowHeight = GLFWFunctions::windowHeight;
+    GLFWFunctions::windowWidth = debugWindowWidth;
+    GLFWFunctions::windowHeight = debugWindowHeight;
+
+    myMath::Matrix3x3 viewMatrix(0.75f, 0.f, 0.f, 0.f, 0.75f, 0.f, -120.f, 45.f, 1.f);
+    DebugDraw debugDraw;
+    float maxError = 0.f;
+    std::string problem;
+
+    for (int shape = 0; shape < debugShapeCount && problem.empty(); shape++) {
+        myMath::Vector2D position(-800.f + (shape * 137) % 1600, -450.f + (shape * 89) % 900);
+        myMath::Vector2D size(10.f + (shape * 53) % 300, 10.f + (shape * 31) % 200);
+        float rotation = static_cast<float>((shape * 47) % 360);
+        glm::mat4 oldXform = oldShapeToNDC(position, rotation, viewMatrix);
+
+        debugDraw.clear();
+        debugDraw.addBox(position, size, rotation, viewMatrix);
+        const float halfX = size.GetX() / 2.0f;
+        const float halfY = size.GetY() / 2.0f;
+        const glm::vec4 corners[4] = { oldXform * glm::vec4(-halfX, -halfY, 0.f, 1.f), oldXform * glm::vec4(halfX, -halfY, 0.f, 1.f),
+                                       oldXform * glm::vec4(halfX, halfY, 0.f, 1.f), oldXform * glm::vec4(-halfX, halfY, 0.f, 1.f) };
+        if (debugDraw.getVertices().size() != 8) {
+            problem = "a box gave " + std::to_string(debugDraw.getVertices().size()) + " vertices instead of 8";
+            break;
+        }
+        for (int corner = 0; corner < 4; corner++) {
+            maxError = std::max(maxError, vertexError(debugDraw.getVertices()[corner * 2], corners[corner]));
+            maxError = std::max(maxError, vertexError(debugDraw.getVertices()[corner * 2 + 1], corners[(corner + 1) % 4]));
+        }
+
+        debugDraw.clear();
+        float radius = size.GetX() / 2.0f;
+        debugDraw.addCircle(position, radius, rotation, viewMatrix);
+        const int segments = DebugDraw::defaultCircleSegments;
+        if (debugDraw.getVertices().size() != static_cast<size_t>(segments * 2)) {
+            problem = "a circle gave " + std::to_string(debugDraw.getVertices().size()) + " vertices instead of " + std::to_string(segments * 2);
+            break;
+        }
+        for (int i = 0; i < segments; i++) {
+            float theta = 2.0f * glm::pi<float>() * float(i) / float(segments);
+            glm::vec4 point = oldXform * glm::vec4(radius * std::cos(theta), radius * std::sin(theta), 0.f, 1.f);
+            maxError = std::max(maxError, vertexError(debugDraw.getVertices()[i * 2], point));
+        }
+    }
+    debugDraw.clear();
+
+    GLFWFunctions::windowWidth = windowWidth;
+    GLFWFunctions::windowHeight = windowHeight;
+
+    if (problem.empty() && maxError > debugTolerance) {
+        problem = "vertices are up to " + std::to_string(maxError) + " NDC away from the old transforms";
+    }
+    std::cout << "  largest difference from the old transforms: " << std::scientific << std::setprecision(2) << maxError
+              << std::defaultfloat << " NDC" << std::endl;
+    return report("debug draw, 50 boxes and circles against the old transforms", problem.empty(), problem);
+}
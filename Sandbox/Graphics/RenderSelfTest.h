@@ -0,0 +1,47 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  RenderSelfTest.h
+@brief  :  This file contains the declaration of the RenderSelfTest class. It
+           checks the parts of the renderer that build their output on the CPU
+           against known results, without a window or OpenGL context, so they
+           can be run on machines without a GPU.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Declared the RenderSelfTest class.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#pragma once
+
+class RenderSelfTest
+{
+public:
+    // Run every check and print its result. Returns false if any failed
+    static bool runAll();
+
+    // 1001 quads over 4 textures and 3 layers, submitted out of order, come
+    // out of the sprite batch as 7 draws in layer order
+    static bool checkSpriteBatching();
+
+    // A mix of sprite sizes packs inside the pages without overlapping, the
+    // one larger than a page is left out, and Blit repeats the edge pixels
+    // into the padding
+    static bool checkAtlasPacking();
+
+    // The render queue's radix sort gives the same order as std::stable_sort
+    // on 200k keys with many duplicates
+    static bool checkRadixSort();
+
+    // The sprites of checkSpriteBatching recorded by 3 worker threads into
+    // their own lists still come out as 7 draws, with the same vertex stream
+    static bool checkWorkerLists();
+
+    // Debug boxes and circles come out of DebugDraw at the same NDC positions
+    // as the per shape 4x4 transforms it replaced
+    static bool checkDebugDraw();
+};
@@ -0,0 +1,116 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  SceneFramebuffer.cpp
+@brief  :  This file contains the implementation of the SceneFramebuffer class.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Implemented creating, resizing and binding the framebuffer and its
+*         colour texture.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#include "SceneFramebuffer.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+SceneFramebuffer::SceneFramebuffer()
+    : framebuffer(0), texture(0), width(0), height(0), requestedWidth(0), requestedHeight(0), bound(false), allocations(0) {
+}
+
+SceneFramebuffer::~SceneFramebuffer() {
+    cleanup();
+}
+
+void SceneFramebuffer::setSize(int newWidth, int newHeight) {
+    requestedWidth = std::max(newWidth, 1);
+    requestedHeight = std::max(newHeight, 1);
+}
+
+void SceneFramebuffer::FitToPanel(float panelWidth, float panelHeight, int windowWidth, int windowHeight, int& fitWidth, int& fitHeight) {
+    fitWidth = static_cast<int>(std::lround(panelWidth));
+    fitHeight = static_cast<int>(std::lround(panelHeight));
+
+    if (fitWidth > windowWidth || fitHeight > windowHeight) {
+        fitWidth = windowWidth;
+        fitHeight = windowHeight;
+    }
+    fitWidth = std::max(fitWidth, 1);
+    fitHeight = std::max(fitHeight, 1);
+}
+
+// The colour attachment is RGB so the game's blended alpha does not make the
+// panel see-through, the same as the copied back buffer before
+bool SceneFramebuffer::allocate() {
+    if (!framebuffer) {
+        glGenFramebuffers(1, &framebuffer);
+        glGenTextures(1, &texture);
+        GLStateCache::BindTexture(texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    width = requestedWidth;
+    height = requestedHeight;
+    allocations++;
+
+    GLStateCache::BindTexture(texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    GLStateCache::BindTexture(0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        std::cout << "Error: scene framebuffer incomplete (" << status << ") at " << width << "x" << height << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SceneFramebuffer::bind() {
+    if (requestedWidth <= 0 || requestedHeight <= 0) {
+        return false;
+    }
+    if (!framebuffer || requestedWidth != width || requestedHeight != height) {
+        if (!allocate()) {
+            return false;
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    glClear(GL_COLOR_BUFFER_BIT);
+    bound = true;
+    return true;
+}
+
+void SceneFramebuffer::unbind(int windowWidth, int windowHeight) {
+    if (!bound) {
+        return;
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, windowWidth, windowHeight);
+    bound = false;
+}
+
+void SceneFramebuffer::cleanup() {
+    if (framebuffer) {
+        glDeleteFramebuffers(1, &framebuffer);
+        GLStateCache::DeleteTextures(1, &texture);
+        framebuffer = texture = 0;
+    }
+    width = height = 0;
+    bound = false;
+}
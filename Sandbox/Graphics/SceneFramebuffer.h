@@ -0,0 +1,64 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  SceneFramebuffer.h
+@brief  :  This file contains the declaration of the SceneFramebuffer class. While
+           the editor is open the game scene is drawn into a framebuffer object
+           whose colour texture is shown in the game viewport panel directly,
+           instead of being copied out of the back buffer every frame. The
+           texture is sized to the panel, so a small panel also means fewer
+           pixels to fill.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Declared the SceneFramebuffer class.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#pragma once
+#include <GL/glew.h>
+
+class SceneFramebuffer
+{
+public:
+    SceneFramebuffer();
+    ~SceneFramebuffer();
+
+    // Size of the texture from the next bind on. The texture keeps its
+    // storage until the size actually changes
+    void setSize(int width, int height);
+
+    // Render size for a panel showing the scene: the panel's size, but never
+    // more pixels than the window itself has
+    static void FitToPanel(float panelWidth, float panelHeight, int windowWidth, int windowHeight, int& width, int& height);
+
+    // Everything drawn after this goes into the texture, which is cleared
+    // first. Creates or resizes the texture as needed. Needs a GL context
+    bool bind();
+
+    // Back to drawing into the window
+    void unbind(int windowWidth, int windowHeight);
+
+    void cleanup();
+
+    bool isBound() const { return bound; }
+    GLuint getTexture() const { return texture; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+    // Times the texture storage was allocated, to check resizes are not repeated
+    unsigned int getAllocationCount() const { return allocations; }
+
+private:
+    bool allocate();
+
+    GLuint framebuffer;
+    GLuint texture;
+    int width, height;
+    int requestedWidth, requestedHeight;
+    bool bound;
+    unsigned int allocations;
+};
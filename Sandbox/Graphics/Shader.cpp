@@ -13,13 +13,14 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 *
 * Javier Chua (javierjunliang.chua) :
 *       - Implemented the Shader class, which is responsible for compiling and linking the vertex and fragment shaders,
-*
+*       - Read the active uniforms into a table after linking so locations are not queried per draw.
 *
 * File Contributions: Liu YaoTing (30%), Javier Chua (70%)
 *
 /*_ _ _ _ ________________________________________________________________________________-\*/
 
 #include "Shader.h"
+#include "GLStateCache.h"
 #include <iostream>
 #include <vector>
 #include <string>
@@ -86,6 +87,7 @@ Shader::Shader(const std::string& vertexSrc, const std::string& fragmentSrc)
 
     m_IsCompiled = true;
     m_IsInitialized = true;
+    LoadUniforms();
     glDetachShader(m_ShaderID, vertexShader);
     glDetachShader(m_ShaderID, fragmentShader);
     glDeleteShader(vertexShader);
@@ -93,15 +95,15 @@ Shader::Shader(const std::string& vertexSrc, const std::string& fragmentSrc)
 }
 
 Shader::~Shader() {
-    glDeleteProgram(m_ShaderID);
+    GLStateCache::DeleteProgram(m_ShaderID);
 }
 
 void Shader::Bind() const {
-    glUseProgram(m_ShaderID);
+    GLStateCache::UseProgram(m_ShaderID);
 }
 
 void Shader::Unbind() const {
-    glUseProgram(0);
+    GLStateCache::UseProgram(0);
 }
 
 void Shader::SetUniform1i(const std::string& name, int value) {
@@ -110,7 +112,7 @@ void Shader::SetUniform1i(const std::string& name, int value) {
 }
 
 void Shader::SetUniform3f(const std::string& name, float v0, float v1, float v2) {
-    glUniform3f(glGetUniformLocation(m_ShaderID, name.c_str()), v0, v1, v2);
+    glUniform3f(GetUniformLocation(name), v0, v1, v2);
 }
 // Compile shader function implementation
 GLuint Shader::CompileShader(GLenum type, const std::string& source) {
@@ -136,18 +138,74 @@ GLuint Shader::CompileShader(GLenum type, const std::string& source) {
 
     return id;
 }
+// Read the name and location of every active uniform into the table. Array
+// uniforms are listed as "name[0]" and can be looked up by "name" as well
+void Shader::LoadUniforms() {
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_ShaderID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+
+    std::vector<GLchar> nameBuffer(maxLength > 0 ? maxLength : 1);
+    for (GLint i = 0; i < count; i++) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_ShaderID, static_cast<GLuint>(i), maxLength, &length, &size, &type, nameBuffer.data());
+
+        std::string name(nameBuffer.data(), length);
+        GLint location = glGetUniformLocation(m_ShaderID, name.c_str());
+
+        int handle = static_cast<int>(m_Uniforms.size());
+        m_Uniforms.push_back({ name, location });
+        m_UniformHandles[name] = handle;
+
+        size_t bracket = name.find("[0]");
+        if (bracket != std::string::npos) {
+            m_UniformHandles[name.substr(0, bracket)] = handle;
+        }
+    }
+}
+
 // Get uniform location function implementation
 GLint Shader::GetUniformLocation(const std::string& name) {
-    GLint location = glGetUniformLocation(m_ShaderID, name.c_str());
-    if (location == -1) {
-        std::cerr << "Warning: Uniform '" << name << "' not found!" << std::endl;
+    int handle = GetUniformHandle(name);
+    if (handle == -1) {
+        if (m_MissingUniforms.insert(name).second) {
+            std::cerr << "Warning: Uniform '" << name << "' not found!" << std::endl;
+        }
+        return -1;
     }
-    return location;
+    return m_Uniforms[handle].location;
+}
+
+int Shader::GetUniformHandle(const std::string& name) const {
+    auto iterator = m_UniformHandles.find(name);
+    return iterator != m_UniformHandles.end() ? iterator->second : -1;
+}
+
+GLint Shader::GetUniformLocation(int handle) const {
+    return handle >= 0 && handle < static_cast<int>(m_Uniforms.size()) ? m_Uniforms[handle].location : -1;
+}
+
+void Shader::SetUniform1i(int handle, int value) {
+    glUniform1i(GetUniformLocation(handle), value);
+}
+
+void Shader::SetUniform3f(int handle, float v0, float v1, float v2) {
+    glUniform3f(GetUniformLocation(handle), v0, v1, v2);
+}
+
+void Shader::SetUniformMatrix3f(int handle, const glm::mat3& matrix) {
+    glUniformMatrix3fv(GetUniformLocation(handle), 1, GL_FALSE, glm::value_ptr(matrix));
+}
+
+void Shader::SetUniformMatrix4f(int handle, const glm::mat4& matrix) {
+    glUniformMatrix4fv(GetUniformLocation(handle), 1, GL_FALSE, glm::value_ptr(matrix));
 }
 
 bool Shader::isInitialized() const {
     return m_IsInitialized; // Return the initialization status
 }
 void Shader::SetUniformMatrix4f(const std::string& name, const glm::mat4& matrix) {
-    glUniformMatrix4fv(glGetUniformLocation(m_ShaderID, name.c_str()), 1, GL_FALSE, glm::value_ptr(matrix));
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, glm::value_ptr(matrix));
 }
\ No newline at end of file
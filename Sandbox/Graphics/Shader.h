@@ -21,8 +21,15 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 
 #include <GL/glew.h>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <glm/glm.hpp>        // For glm::mat4
 #include <glm/gtc/type_ptr.hpp>
+// Index of a loaded shader in the AssetsManager, stays valid across reloads
+using ShaderHandle = int;
+constexpr ShaderHandle invalidShaderHandle = -1;
+
 struct ShaderProgramSource {
     std::string VertexSource;
     std::string FragmentSource;
@@ -35,6 +42,15 @@ private:
     bool m_IsInitialized;
     GLuint CompileShader(GLenum type, const std::string& source);
 
+    // Active uniforms, read once after linking
+    struct Uniform {
+        std::string name;
+        GLint location;
+    };
+    std::vector<Uniform> m_Uniforms;
+    std::unordered_map<std::string, int> m_UniformHandles;
+    std::unordered_set<std::string> m_MissingUniforms;     // warned about already
+    void LoadUniforms();
     
 
 public:
@@ -54,6 +70,15 @@ public:
     static ShaderProgramSource ParseShader(const std::string& filepath);
 
     GLint GetUniformLocation(const std::string& name);
+
+    // Index of the uniform in the shader's table, -1 if it is not active.
+    // Look it up once and set the uniform through the handle after
+    int GetUniformHandle(const std::string& name) const;
+    GLint GetUniformLocation(int handle) const;
+    void SetUniform1i(int handle, int value);
+    void SetUniform3f(int handle, float v0, float v1, float v2);
+    void SetUniformMatrix3f(int handle, const glm::mat3& matrix);
+    void SetUniformMatrix4f(int handle, const glm::mat4& matrix);
     bool isInitialized() const;
     inline GLuint GetProgram() const {
         return m_ShaderID; 
@@ -0,0 +1,286 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  SpriteBatch.cpp
+@brief  :  This file contains the implementation of the SpriteBatch class, the
+           vertex stream building and the streamed draw.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Implemented sorting the quads into texture runs and building the
+*         vertex stream and command list.
+*       - Implemented the streamed vertex buffer and the shared index buffer.
+*       - Moved the sorting onto the render queue and the GL calls into
+*         GLSpriteBackend.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#include "SpriteBatch.h"
+#include "Shader.h"
+#include "GLStateCache.h"
+#include <algorithm>
+#include <glm/glm.hpp>
+
+namespace
+{
+    // Positions arrive in NDC already, the tint multiplies the texture
+    const char* batchVertexShader = R"(
+#version 330 core
+layout(location = 0) in vec2 position;
+layout(location = 1) in vec2 texCoords;
+layout(location = 2) in vec4 color;
+
+out vec2 TexCoords;
+out vec4 Color;
+
+void main() {
+    gl_Position = vec4(position, 0.0, 1.0);
+    TexCoords = texCoords;
+    Color = color;
+}
+)";
+
+    const char* batchFragmentShader = R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoords;
+in vec4 Color;
+uniform sampler2D u_Texture;
+uniform int u_UseTexture;
+
+void main() {
+    FragColor = u_UseTexture != 0 ? texture(u_Texture, TexCoords) * Color : Color;
+}
+)";
+
+    // Corners of the unit quad, in the same order as the sprite quad in GraphicsSystem
+    const float quadCorners[4][2] = { { 0.5f, 0.5f }, { 0.5f, -0.5f }, { -0.5f, -0.5f }, { -0.5f, 0.5f } };
+}
+
+GLSpriteBackend::GLSpriteBackend()
+    : useTextureLocation(-1), useTexture(-1), vao(0), vbo(0), ebo(0), bufferQuads(0) {
+}
+
+void GLSpriteBackend::initialise() {
+    shader = std::make_unique<Shader>(batchVertexShader, batchFragmentShader);
+    shader->Bind();
+    shader->SetUniform1i("u_Texture", 0);
+    useTextureLocation = shader->GetUniformLocation("u_UseTexture");
+    shader->Unbind();
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+
+    GLStateCache::BindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(RenderVertex), (void*)offsetof(RenderVertex, x));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(RenderVertex), (void*)offsetof(RenderVertex, u));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(RenderVertex), (void*)offsetof(RenderVertex, r));
+    glEnableVertexAttribArray(2);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    GLStateCache::BindVertexArray(0);
+
+    bufferQuads = 0;
+}
+
+void GLSpriteBackend::cleanup() {
+    if (vao) {
+        glDeleteBuffers(1, &ebo);
+        glDeleteBuffers(1, &vbo);
+        GLStateCache::DeleteVertexArrays(1, &vao);
+        vao = vbo = ebo = 0;
+    }
+    shader.reset();
+    bufferQuads = 0;
+}
+
+void GLSpriteBackend::reserveBuffers(size_t quadCount) {
+    if (quadCount <= bufferQuads) {
+        return;
+    }
+
+    bufferQuads = std::max(quadCount, bufferQuads * 2);
+
+    // Every quad uses the same two triangles, so the indices never change
+    std::vector<GLuint> indices;
+    indices.reserve(bufferQuads * 6);
+    for (GLuint quad = 0; quad < bufferQuads; quad++) {
+        GLuint first = quad * 4;
+        GLuint pattern[] = { first, first + 1, first + 3, first + 1, first + 2, first + 3 };
+        indices.insert(indices.end(), std::begin(pattern), std::end(pattern));
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, bufferQuads * 4 * sizeof(RenderVertex), nullptr, GL_STREAM_DRAW);
+}
+
+void GLSpriteBackend::beginFrame(const std::vector<RenderVertex>& vertices) {
+    if (vertices.empty()) {
+        return;
+    }
+
+    GLStateCache::BindVertexArray(vao);
+    reserveBuffers(vertices.size() / 4);
+
+    // Orphan last frame's storage so the upload does not wait on it
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, bufferQuads * 4 * sizeof(RenderVertex), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(RenderVertex), vertices.data());
+    useTexture = -1;
+}
+
+void GLSpriteBackend::drawQuads(uint32_t, GLuint texture, size_t firstQuad, size_t quadCount) {
+    shader->Bind();
+    GLStateCache::BindVertexArray(vao);
+    GLStateCache::BindTexture(texture);
+
+    // Uniform values stay with the program, so custom draws in between do not reset it
+    int textured = texture != 0;
+    if (textured != useTexture) {
+        glUniform1i(useTextureLocation, textured);
+        useTexture = textured;
+    }
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(quadCount * 6), GL_UNSIGNED_INT,
+                   (void*)(firstQuad * 6 * sizeof(GLuint)));
+}
+
+void GLSpriteBackend::runCustom(const std::function<void()>& callback) {
+    callback();
+}
+
+void GLSpriteBackend::endFrame() {
+    GLStateCache::BindVertexArray(0);
+    GLStateCache::BindTexture(0);
+    if (shader) {
+        shader->Unbind();
+    }
+}
+
+SpriteBatch::SpriteBatch()
+    : built(false), lastDrawCalls(0), lastQuadCount(0) {
+}
+
+SpriteBatch::~SpriteBatch() {
+    cleanup();
+}
+
+void SpriteBatch::initialise() {
+    glBackend.initialise();
+}
+
+void SpriteBatch::cleanup() {
+    glBackend.cleanup();
+}
+
+uint64_t SpriteBatch::MakeKey(int layer, GLuint texture, uint32_t depth) {
+    return RenderKey::Make(static_cast<uint32_t>(layer), spriteShader, texture, depth);
+}
+
+void SpriteBatch::submit(GLuint texture, const myMath::Matrix3x3& xform, int layer, uint32_t depth) {
+    Quad quad{};
+    quad.xform = xform;
+    quad.uvs[0] = myMath::Vector2D(1.f, 1.f);
+    quad.uvs[1] = myMath::Vector2D(1.f, 0.f);
+    quad.uvs[2] = myMath::Vector2D(0.f, 0.f);
+    quad.uvs[3] = myMath::Vector2D(0.f, 1.f);
+    quad.texture = texture;
+    quad.tint[0] = quad.tint[1] = quad.tint[2] = quad.tint[3] = 1.f;
+    submit(quad, layer, depth);
+}
+
+void SpriteBatch::submit(const Quad& quad, int layer, uint32_t depth) {
+    Record(queue.getList(0), quad, layer, depth);
+    built = false;
+}
+
+void SpriteBatch::Record(RenderCommandList& list, const Quad& quad, int layer, uint32_t depth) {
+    list.addQuad(MakeKey(layer, quad.texture, depth), quad);
+}
+
+void SpriteBatch::submitCustom(int layer, std::function<void()> callback) {
+    queue.getList(0).addCustom(RenderKey::Make(static_cast<uint32_t>(layer), customShader, 0, 0), std::move(callback));
+    built = false;
+}
+
+// The queue hands the commands back sorted by layer, shader, texture and
+// depth, so a batch ends wherever one of those changes
+void SpriteBatch::build() {
+    queue.sort();
+
+    vertices.clear();
+    commands.clear();
+    vertices.reserve(queue.getQuadCount() * 4);
+
+    size_t quadIndex = 0;
+    for (const auto& command : queue.getCommands()) {
+        int layer = static_cast<int>(RenderKey::Layer(command.key));
+
+        if (command.type == RenderCommandType::CUSTOM) {
+            commands.push_back({ CommandType::CUSTOM, layer, RenderKey::Shader(command.key), 0, 0, 0, command.payload });
+            continue;
+        }
+
+        const Quad& quad = queue.getQuad(command);
+        uint32_t shader = RenderKey::Shader(command.key);
+
+        if (commands.empty() || commands.back().type != CommandType::QUADS || commands.back().layer != layer ||
+            commands.back().shader != shader || commands.back().texture != quad.texture) {
+            commands.push_back({ CommandType::QUADS, layer, shader, quad.texture, quadIndex, 0, 0 });
+        }
+        commands.back().quadCount++;
+
+        glm::mat3 xform = myMath::Matrix3x3::ConvertToGLMMat3(quad.xform);
+        for (int corner = 0; corner < 4; corner++) {
+            glm::vec3 position = xform * glm::vec3(quadCorners[corner][0], quadCorners[corner][1], 1.f);
+            vertices.push_back({ position.x, position.y, quad.uvs[corner].GetX(), quad.uvs[corner].GetY(),
+                                 quad.tint[0], quad.tint[1], quad.tint[2], quad.tint[3] });
+        }
+        quadIndex++;
+    }
+
+    built = true;
+}
+
+void SpriteBatch::flush() {
+    flush(glBackend);
+}
+
+void SpriteBatch::flush(RenderBackend& backend) {
+    if (!built) {
+        build();
+    }
+
+    lastDrawCalls = 0;
+    lastQuadCount = vertices.size() / 4;
+
+    backend.beginFrame(vertices);
+    for (const auto& command : commands) {
+        if (command.type == CommandType::CUSTOM) {
+            RenderCommand custom{ 0, static_cast<uint32_t>(command.callback), RenderCommandType::CUSTOM };
+            backend.runCustom(queue.getCallback(custom));
+            continue;
+        }
+
+        backend.drawQuads(command.shader, command.texture, command.firstQuad, command.quadCount);
+        lastDrawCalls++;
+    }
+    backend.endFrame();
+
+    clear();
+}
+
+void SpriteBatch::clear() {
+    queue.clear();
+    vertices.clear();
+    commands.clear();
+    built = false;
+}
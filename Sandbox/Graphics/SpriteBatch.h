@@ -0,0 +1,148 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  SpriteBatch.h
+@brief  :  This file contains the declaration of the SpriteBatch class. Sprites
+           submitted during a frame are recorded in a render queue, sorted by
+           layer, shader and texture, and written into one streamed vertex
+           buffer so that every run of quads sharing a texture is drawn with a
+           single draw call. Building the command stream does not touch OpenGL,
+           so a frame's batches can be inspected without a window.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Declared the SpriteBatch class, the quad and command structures.
+*       - Declared the GL backend that draws the built commands.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#pragma once
+#include <GL/glew.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "vector2D.h"
+#include "matrix3x3.h"
+#include "RenderQueue.h"
+
+class Shader;
+
+// Draw order of sprites, lower layers are drawn first
+enum class SpriteLayer
+{
+    BACKGROUND,
+    LEVEL,
+    PROPS,
+    CHARACTERS,
+    EFFECTS,
+    UI,
+    DEBUG
+};
+
+// Draws the sprite stream with the batch shader
+class GLSpriteBackend : public RenderBackend
+{
+public:
+    GLSpriteBackend();
+
+    // Creates the shader, vertex array and buffers. Needs a GL context
+    void initialise();
+    void cleanup();
+
+    void beginFrame(const std::vector<RenderVertex>& vertices) override;
+    void drawQuads(uint32_t shader, GLuint texture, size_t firstQuad, size_t quadCount) override;
+    void runCustom(const std::function<void()>& callback) override;
+    void endFrame() override;
+
+private:
+    // Grow the vertex buffer and the shared index pattern to hold the quads
+    void reserveBuffers(size_t quadCount);
+
+    std::unique_ptr<Shader> shader;
+    GLint useTextureLocation;
+    int useTexture;                 // last value given to u_UseTexture, -1 before the first draw
+    GLuint vao;
+    GLuint vbo;
+    GLuint ebo;
+    size_t bufferQuads;
+};
+
+class SpriteBatch
+{
+public:
+    using Vertex = RenderVertex;
+    using Quad = RenderQuad;
+
+    // Shader part of the sort key. Custom draws sort before the sprites of their layer
+    static constexpr uint32_t customShader = 0;
+    static constexpr uint32_t spriteShader = 1;
+
+    enum class CommandType {
+        QUADS,      // draw quadCount quads starting at firstQuad with one texture
+        CUSTOM      // run a callback, for things drawn with their own meshes
+    };
+
+    struct Command {
+        CommandType type;
+        int layer;
+        uint32_t shader;
+        GLuint texture;
+        size_t firstQuad;
+        size_t quadCount;
+        size_t callback;                // index into the queue's callbacks
+    };
+
+    SpriteBatch();
+    ~SpriteBatch();
+
+    void initialise();
+    void cleanup();
+
+    // Depth orders sprites of the same layer and texture. Equal keys keep the
+    // order they were submitted in
+    void submit(GLuint texture, const myMath::Matrix3x3& xform, int layer, uint32_t depth = 0);
+    void submit(const Quad& quad, int layer, uint32_t depth = 0);
+    void submitCustom(int layer, std::function<void()> callback);
+
+    // Worker threads record into their own list of the queue, with keys from MakeKey
+    RenderQueue& getQueue() { return queue; }
+    static uint64_t MakeKey(int layer, GLuint texture, uint32_t depth = 0);
+
+    // Same as submit, into a list of the queue given out to a worker thread.
+    // The lists must be set up with setListCount before the workers start
+    static void Record(RenderCommandList& list, const Quad& quad, int layer, uint32_t depth = 0);
+
+    // Sort the frame's commands and build the vertex stream and batches. Does
+    // not touch OpenGL
+    void build();
+
+    // Builds if needed, hands the frame to the backend and starts a new frame
+    void flush();
+    void flush(RenderBackend& backend);
+
+    // Drops everything submitted since the last flush
+    void clear();
+
+    const std::vector<Command>& getCommands() const { return commands; }
+    const std::vector<Vertex>& getVertices() const { return vertices; }
+    size_t getQuadCount() const { return queue.getQuadCount(); }
+
+    // Draw calls issued by the last flush, and the quads they covered
+    size_t getLastDrawCalls() const { return lastDrawCalls; }
+    size_t getLastQuadCount() const { return lastQuadCount; }
+
+private:
+    RenderQueue queue;
+    std::vector<Vertex> vertices;
+    std::vector<Command> commands;
+    bool built;
+
+    GLSpriteBackend glBackend;
+
+    size_t lastDrawCalls;
+    size_t lastQuadCount;
+};
@@ -0,0 +1,99 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  SpriteCuller.cpp
+@brief  :  This file contains the implementation of the SpriteCuller class.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Implemented the sprite and view bounds and the visibility query.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#include "SpriteCuller.h"
+#include <algorithm>
+#include <cmath>
+#include <glm/glm.hpp>
+
+SpriteCuller::SpriteCuller(float cellSize)
+    : grid(cellSize), lastUpdated(MAX_ENTITIES, 0), frame(1), stats{ 0, 0 } {
+}
+
+SpriteCuller::Bounds SpriteCuller::GetSpriteBounds(const myMath::Vector2D& position, const myMath::Vector2D& scale, const myMath::Vector2D& orientation) {
+    // Same angle as UpdateObject, the unit quad spans -0.5 to 0.5
+    float angle = glm::radians(orientation.GetX() + orientation.GetY());
+    float cosine = std::fabs(std::cos(angle));
+    float sine = std::fabs(std::sin(angle));
+
+    float halfWidth = 0.5f * (std::fabs(scale.GetX()) * cosine + std::fabs(scale.GetY()) * sine);
+    float halfHeight = 0.5f * (std::fabs(scale.GetX()) * sine + std::fabs(scale.GetY()) * cosine);
+
+    myMath::Vector2D half(halfWidth, halfHeight);
+    return { position - half, position + half };
+}
+
+// The projection maps view space -w/2..w/2 onto the screen, so undoing the
+// view matrix on those corners gives the world the camera sees
+SpriteCuller::Bounds SpriteCuller::GetViewBounds(const myMath::Matrix3x3& viewMatrix, float viewWidth, float viewHeight) {
+    glm::mat3 inverseView = glm::inverse(myMath::Matrix3x3::ConvertToGLMMat3(viewMatrix));
+
+    const float corners[4][2] = { { -1.f, -1.f }, { 1.f, -1.f }, { 1.f, 1.f }, { -1.f, 1.f } };
+    glm::vec2 min(0.f), max(0.f);
+
+    for (int corner = 0; corner < 4; corner++) {
+        glm::vec3 world = inverseView * glm::vec3(corners[corner][0] * viewWidth / 2.f, corners[corner][1] * viewHeight / 2.f, 1.f);
+        glm::vec2 point(world.x, world.y);
+
+        min = corner == 0 ? point : glm::min(min, point);
+        max = corner == 0 ? point : glm::max(max, point);
+    }
+
+    return { myMath::Vector2D(min.x, min.y), myMath::Vector2D(max.x, max.y) };
+}
+
+bool SpriteCuller::Overlaps(const Bounds& lhs, const Bounds& rhs) {
+    return lhs.min.GetX() <= rhs.max.GetX() && lhs.max.GetX() >= rhs.min.GetX() &&
+           lhs.min.GetY() <= rhs.max.GetY() && lhs.max.GetY() >= rhs.min.GetY();
+}
+
+void SpriteCuller::beginFrame() {
+    frame++;
+}
+
+void SpriteCuller::update(Entity entity, const Bounds& bounds) {
+    if (entity >= MAX_ENTITIES) {
+        return;
+    }
+
+    grid.update(entity, bounds);
+    lastUpdated[entity] = frame;
+}
+
+void SpriteCuller::queryVisible(const Bounds& view, std::vector<Entity>& visible) {
+    visible.clear();
+    grid.queryRegion(view, visible);
+
+    // Destroyed entities are only noticed once they come into view, which is
+    // the only time they would cost anything
+    auto gone = std::remove_if(visible.begin(), visible.end(), [this](Entity entity) {
+        if (lastUpdated[entity] == frame) {
+            return false;
+        }
+        grid.remove(entity);
+        return true;
+    });
+    visible.erase(gone, visible.end());
+    std::sort(visible.begin(), visible.end());
+
+    stats.indexed = grid.getEntityCount();
+    stats.visible = visible.size();
+}
+
+void SpriteCuller::clear() {
+    grid.clear();
+    std::fill(lastUpdated.begin(), lastUpdated.end(), 0u);
+    stats = { 0, 0 };
+}
@@ -0,0 +1,62 @@
+/*
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author :  Javier Chua (javierjunliang.chua)
+@team   :  MonkeHood
+@course :  CSD2401
+@file   :  SpriteCuller.h
+@brief  :  This file contains the declaration of the SpriteCuller class. The
+           world space bounds of every sprite are kept in a spatial grid, and
+           each frame only the sprites overlapping the camera's view rectangle
+           are handed back to be drawn.
+
+* Javier Chua (javierjunliang.chua) :
+*       - Declared the SpriteCuller class.
+
+ File Contributions: Javier Chua (100%)
+
+/*_______________________________________________________________________________________________________________*/
+
+#pragma once
+#include <vector>
+#include "ECSDefinitions.h"
+#include "SpatialGrid.h"
+#include "vector2D.h"
+#include "matrix3x3.h"
+
+class SpriteCuller
+{
+public:
+    using Bounds = SpatialGrid::Bounds;
+
+    struct Stats {
+        size_t indexed;     // sprites in the grid
+        size_t visible;     // sprites the last query handed back
+    };
+
+    explicit SpriteCuller(float cellSize = 512.f);
+
+    // Box around a sprite drawn with UpdateObject, rotation included
+    static Bounds GetSpriteBounds(const myMath::Vector2D& position, const myMath::Vector2D& scale, const myMath::Vector2D& orientation);
+
+    // Box around what the camera shows in a viewWidth x viewHeight window
+    static Bounds GetViewBounds(const myMath::Matrix3x3& viewMatrix, float viewWidth, float viewHeight);
+
+    static bool Overlaps(const Bounds& lhs, const Bounds& rhs);
+
+    // Sprites not updated between beginFrame and the query are treated as gone
+    void beginFrame();
+    void update(Entity entity, const Bounds& bounds);
+
+    // Sprites overlapping the view, in entity order so they are submitted in
+    // the same order as a walk over the live entities
+    void queryVisible(const Bounds& view, std::vector<Entity>& visible);
+
+    void clear();
+    Stats getStats() const { return stats; }
+
+private:
+    SpatialGrid grid;
+    std::vector<unsigned int> lastUpdated;     // frame each entity was last updated in
+    unsigned int frame;
+    Stats stats;
+};
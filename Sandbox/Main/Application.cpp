@@ -17,6 +17,9 @@ File Contributions: Joel Chu (50%)
 #include "ECSCoordinator.h"
 #include "GlobalCoordinator.h"
 #include "Crashlog.h"
+#include "PhysicsBenchmark.h"
+#include "CullingBenchmark.h"
+#include "RenderSelfTest.h"
 
 #define _CRTDBG_MAP_ALLOC
 #include <stdlib.h>
@@ -34,7 +37,29 @@ namespace monkeybrother {
 	__declspec(dllimport) void Print();
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+	// Headless physics benchmark: Sandbox.exe --physics-benchmark [output.json]
+	if (argc > 1 && std::string(argv[1]) == "--physics-benchmark") {
+		ecsCoordinator.initialise();
+		ecsCoordinator.initialiseHeadless();
+		bool saved = PhysicsBenchmark::runSuite(PhysicsBenchmark::getDefaultSuite(),
+			argc > 2 ? argv[2] : FilePathManager::GetPhysicsBenchmarkJSONPath());
+		ecsCoordinator.cleanup();
+		return saved ? 0 : 1;
+	}
+
+	// Headless sprite culling benchmark: Sandbox.exe --culling-benchmark [output.json]
+	if (argc > 1 && std::string(argv[1]) == "--culling-benchmark") {
+		bool saved = CullingBenchmark::runSuite(CullingBenchmark::getDefaultSuite(),
+			argc > 2 ? argv[2] : FilePathManager::GetCullingBenchmarkJSONPath());
+		return saved ? 0 : 1;
+	}
+
+	// Headless renderer checks: Sandbox.exe --render-selftest
+	if (argc > 1 && std::string(argv[1]) == "--render-selftest") {
+		return RenderSelfTest::runAll() ? 0 : 1;
+	}
+
 	ShowWindow(GetConsoleWindow(), SW_HIDE); // Hide the console window
 
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
@@ -0,0 +1,84 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Joel Chu (c.weiyuan)
+@team:   MonkeHood
+@course: CSD2401
+@file:   AnimationSystemECS.cpp
+@brief:  This source file defines the functions in AnimationSystemECS class.
+		 The clips come from the assets manager and are shared, only the
+		 frame and time of each entity are kept in its AnimationComponent.
+		 Joel Chu (c.weiyuan): Defined the functions in AnimationSystemECS class.
+							   100%
+*//*___________________________________________________________________________-*/
+#include "AnimationSystemECS.h"
+#include "EnemyComponent.h"
+#include "PlayerComponent.h"
+#include "PumpComponent.h"
+#include "PhysicsComponent.h"
+#include "GUIGameViewport.h"
+#include "GlobalCoordinator.h"
+
+void AnimationSystemECS::initialise() {
+	defaultClip = assetsManager.GetAnimationClipHandle(AssetsManager::defaultAnimationClip);
+}
+
+void AnimationSystemECS::cleanup() {}
+
+void AnimationSystemECS::update(float dt) {
+	bool paused = GameViewWindow::getPaused();
+
+	//The system signature keeps this to entities with an AnimationComponent
+	for (auto entity : entities) {
+		auto& animation = ecsCoordinator.getComponent<AnimationComponent>(entity);
+		if (!isAnimating(entity)) {
+			animation.isPlaying = false;
+			continue;
+		}
+
+		if (animation.clip == invalidAnimationClipHandle) {
+			animation.clip = defaultClip;
+		}
+
+		const AnimationClip* clip = assetsManager.GetAnimationClip(animation.clip);
+		if (!clip) {
+			animation.isPlaying = false;
+			continue;
+		}
+
+		if (!paused) {
+			clip->Advance(animation.currentFrame, animation.timeAccumulator, dt);
+		}
+		animation.frameUV = clip->GetFrameUV(animation.currentFrame);
+		animation.isPlaying = true;
+	}
+}
+
+bool AnimationSystemECS::isAnimating(Entity entity) {
+	bool hasMovement = ecsCoordinator.hasComponent<PhysicsComponent>(entity);
+	bool isPlayer = ecsCoordinator.hasComponent<PlayerComponent>(entity);
+	bool isEnemy = ecsCoordinator.hasComponent<EnemyComponent>(entity);
+	bool isPumping = ecsCoordinator.hasComponent<PumpComponent>(entity) &&
+		ecsCoordinator.getComponent<PumpComponent>(entity).isAnimate;
+
+	return isPumping || (isPlayer && hasMovement) || (isEnemy && hasMovement);
+}
+
+//Pumps can start blowing bubbles at any time, so they get one whether or
+//not they are animating yet
+void AnimationSystemECS::attachAnimation(Entity entity) {
+	if (ecsCoordinator.hasComponent<AnimationComponent>(entity)) {
+		return;
+	}
+
+	bool hasMovement = ecsCoordinator.hasComponent<PhysicsComponent>(entity);
+	bool isCharacter = ecsCoordinator.hasComponent<PlayerComponent>(entity) ||
+		ecsCoordinator.hasComponent<EnemyComponent>(entity);
+
+	if (ecsCoordinator.hasComponent<PumpComponent>(entity) || (isCharacter && hasMovement)) {
+		ecsCoordinator.addComponent(entity, AnimationComponent{});
+	}
+}
+
+std::string AnimationSystemECS::getSystemECS() {
+	return "AnimationSystemECS";
+}
@@ -0,0 +1,44 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Joel Chu (c.weiyuan)
+@team:   MonkeHood
+@course: CSD2401
+@file:   AnimationSystemECS.h
+@brief:  This header file inherits the System class from ECS base system class.
+		 This class advances the animation of every animated entity once a
+		 frame, so GraphicSystemECS only has to hand each entity's current
+		 frame to the sprite batch.
+		 Joel Chu (c.weiyuan): Declared class AnimationSystemECS with its
+							   functions, inherited from System class.
+							   100%
+*//*___________________________________________________________________________-*/
+#pragma once
+#include "ECSCoordinator.h"
+#include "AnimationComponent.h"
+
+class AnimationSystemECS : public System
+{
+public:
+	AnimationSystemECS() : defaultClip(invalidAnimationClipHandle) {}
+
+	//Looks up the clip entities play when they have not been given one
+	void initialise() override;
+	void cleanup() override;
+
+	//Advances the playback state of every animated entity by dt and stores
+	//the UVs of its current frame
+	void update(float dt) override;
+
+	std::string getSystemECS() override;
+
+	//Whether the entity animates this frame: moving players and enemies,
+	//and pumps that are blowing bubbles
+	static bool isAnimating(Entity entity);
+
+	//Gives an entity that can animate the AnimationComponent it plays with.
+	//Called when entities are loaded or created, update never adds one
+	static void attachAnimation(Entity entity);
+
+private:
+	AnimationClipHandle defaultClip;
+};
@@ -17,46 +17,25 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "GlobalCoordinator.h"
 #include "PhyColliSystemECS.h"
 
+//Collisions are reported through onTriggerEnter, nothing to poll here
 void CollectableBehaviour::update(Entity entity) {
-	//get player entity based on ifPlayer component
-	
-	auto PhysicsSystemRef = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
-	auto collisionSystem = PhysicsSystemRef->getCollisionSystem();
+	(void)entity;
+}
 
-
-	for (auto& playerEntity : ecsCoordinator.getAllLiveEntities()) {
-		if (ecsCoordinator.hasComponent<PlayerComponent>(playerEntity)) {
-
-			//get the position of the player and the collectable
-			auto& playerTransform = ecsCoordinator.getComponent<TransformComponent>(playerEntity);
-			myMath::Vector2D& playerPos = playerTransform.position;
-			float radius = playerTransform.scale.GetX() * 0.5f;
-
-			CollisionSystemECS::OBB playerOBB = collisionSystem.createOBBFromEntity(playerEntity);
-			CollisionSystemECS::OBB collectOBB = collisionSystem.createOBBFromEntity(entity);
-
-			myMath::Vector2D normal{};
-			float penetration{};
-
-			bool isColliding = collisionSystem.checkCircleOBBCollision(playerPos, radius, collectOBB, normal, penetration);
-
-			if (isColliding) {
-				std::cout << "COLLIDED" << std::endl;
-				//player grow in size and mass
-				playerTransform.scale.SetX(playerTransform.scale.GetX() + 50.0f);
-				playerTransform.scale.SetY(playerTransform.scale.GetY() + 50.0f);
-				auto& playerPhysics = ecsCoordinator.getComponent<PhysicsComponent>(playerEntity);
-				playerPhysics.mass += 0.5f;
-
-				GLFWFunctions::collectAudio = true;
-			
-
-				ecsCoordinator.destroyEntity(entity);
-				GLFWFunctions::collectableCount--;
-			}
-		}
+void CollectableBehaviour::onTriggerEnter(Entity entity, Entity other) {
+	if (!ecsCoordinator.hasComponent<PlayerComponent>(other)) {
+		return;
 	}
 
+	//player grow in size and mass
+	auto& playerTransform = ecsCoordinator.getComponent<TransformComponent>(other);
+	playerTransform.scale.SetX(playerTransform.scale.GetX() + 50.0f);
+	playerTransform.scale.SetY(playerTransform.scale.GetY() + 50.0f);
+	auto& playerPhysics = ecsCoordinator.getComponent<PhysicsComponent>(other);
+	playerPhysics.mass += 0.5f;
 
+	GLFWFunctions::collectAudio = true;
 
-}
\ No newline at end of file
+	ecsCoordinator.destroyEntity(entity);
+	GLFWFunctions::collectableCount--;
+}
@@ -16,4 +16,7 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 class CollectableBehaviour : public BehaviourECS {
 public:
 	void update(Entity entity) override;
+
+	bool usesTriggerEvents() const override { return true; }
+	void onTriggerEnter(Entity entity, Entity other) override;
 };
\ No newline at end of file
@@ -6,6 +6,8 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 @file:   EffectPumpBehaviour.h
 @brief:  This header file includes the EffectPumpBehaviour class which is used
 		 by the logicSystemECS to handle the behaviour of the pump entities.
+		 The push itself comes from the pump's ForceFieldComponent, the
+		 behaviour only switches the field on and off.
 		 Joel Chu (c.weiyuan): declared the EffectPumpBehaviour class
 							   100%
 *//*___________________________________________________________________________-*/
@@ -18,11 +20,10 @@ public:
 	void update(Entity entity) override;
 
 	EffectPumpBehaviour()
-		: hasForceAdded(false), timer(0.0f), offDuration(5.0f), onDuration(5.0f) {}
+		: timer(0.0f), offDuration(5.0f), onDuration(5.0f) {}
 
 
 private:
-	bool hasForceAdded;
 	float timer;
 	float offDuration;
 	float onDuration;
@@ -17,6 +17,7 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "EnemyBehaviour.h"
 #include "GlobalCoordinator.h"
 #include "PhyColliSystemECS.h"
+#include <limits>
 
 EnemyBehaviour::EnemyBehaviour() {
 	currentState = PATROL;
@@ -27,6 +28,7 @@ EnemyBehaviour::EnemyBehaviour() {
 	waypoints.push_back(myMath::Vector2D(300, 100));
 	waypoints.push_back(myMath::Vector2D(400, 100));
 
+	closestDistance = std::numeric_limits<float>::max();
 }
 
 void EnemyBehaviour::switchState(STATE newState) {  
@@ -78,20 +80,33 @@ int& EnemyBehaviour::getCurrentWaypointIndex() {
 	return currentWaypointIndex;
 }
 
+void EnemyBehaviour::nextWaypoint() {
+    currentWaypointIndex++;
+    if (currentWaypointIndex >= static_cast<int>(waypoints.size())) {
+        currentWaypointIndex = 0; // Loop back to the first waypoint
+    }
+
+    closestDistance = std::numeric_limits<float>::max();
+    stuckTime = 0.f;
+}
+
+// Sets the velocity the enemy steers towards to reach its current waypoint.
+// The physics system works out the steering force from it every fixed step,
+// integrates it together with every other moving body and resolves the
+// enemy's contacts with the level. A waypoint the enemy stops getting closer
+// to, e.g. one behind a wall, is skipped after a while.
 void EnemyBehaviour::updatePatrolState(Entity entity) {
-    auto PhysicsSystemRef = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
     auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
     auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(entity);
     auto& currentWaypoints = getWaypoints();
     int& currentWPIndex = getCurrentWaypointIndex();
-    ForceManager forceManager = ecsCoordinator.getComponent<PhysicsComponent>(entity).forceManager;
 
     // Set the current waypoint target
     myMath::Vector2D target = currentWaypoints[currentWPIndex];
 
     // Compute direction towards the target
     myMath::Vector2D direction = target - transform.position;
-    float length = static_cast<float>(std::sqrt(std::pow(direction.GetX(), 2) + std::pow(direction.GetY(), 2)));
+    float length = myMath::LengthVector2D(direction);
 
     // If close enough to the waypoint, move to the next one
     const float waypointThreshold = 1.0f;
@@ -101,52 +116,35 @@ void EnemyBehaviour::updatePatrolState(Entity entity) {
         transform.position.SetY(target.GetY());
 
         // Reset forces and velocity
-        physics.accumulatedForce.SetX(0.f);
-        physics.accumulatedForce.SetY(0.f);
+        physics.forceManager.ClearForce(physics);
         physics.velocity.SetX(0.f);
         physics.velocity.SetY(0.f);
 
-        // Move to the next waypoint
-        currentWPIndex++;
-        if (currentWPIndex >= currentWaypoints.size()) {
-            currentWPIndex = 0; // Loop back to the first waypoint
-        }
-
-        target = currentWaypoints[currentWPIndex];
-        direction = target - transform.position;
-        length = static_cast<float>(std::sqrt(std::pow(direction.GetX(), 2) + std::pow(direction.GetY(), 2)));
-
+        nextWaypoint();
     }
-
-    // Normalize direction if length is not zero
-    if (length != 0) {
-        direction.SetX(direction.GetX() / static_cast<float>(length));
-        direction.SetY(direction.GetY() / static_cast<float>(length));
+    else if (length < closestDistance - waypointThreshold) {
+        closestDistance = length;
+        stuckTime = 0.f;
     }
-
-    // Apply movement force if not at the waypoint
-    if (length >= waypointThreshold) {
-        const float movementForceMagnitude = 5.0f; // Example value
-        myMath::Vector2D movementForce = direction * movementForceMagnitude;
-        forceManager.AddForce(entity, movementForce);
+    else {
+        stuckTime += GLFWFunctions::delta_time;
+        if (stuckTime > waypointTimeout) {
+            nextWaypoint();
+        }
     }
 
-    // Physics calculations
-    float invMass = physics.mass > 0.f ? 1.f / physics.mass : 0.f;
-    physics.acceleration = physics.accumulatedForce * invMass;
+    target = currentWaypoints[currentWPIndex];
+    direction = target - transform.position;
+    length = myMath::LengthVector2D(direction);
 
-    // Update velocity
-    physics.velocity.SetX(physics.velocity.GetX() + physics.acceleration.GetX() * GLFWFunctions::delta_time);
-    physics.velocity.SetY(physics.velocity.GetY() + physics.acceleration.GetY() * GLFWFunctions::delta_time);
-
-    const float maxSpeed = 0.2f; // Example max speed
-    if (physics.velocity.GetX() > maxSpeed) physics.velocity.SetX(maxSpeed);
-    if (physics.velocity.GetX() < -maxSpeed) physics.velocity.SetX(-maxSpeed);
-    if (physics.velocity.GetY() > maxSpeed) physics.velocity.SetY(maxSpeed);
-    if (physics.velocity.GetY() < -maxSpeed) physics.velocity.SetY(-maxSpeed);
+    if (length < waypointThreshold) {
+        physics.desiredVelocity = myMath::Vector2D(0.f, 0.f);
+        return;
+    }
 
-    // Apply velocity to position
-    transform.position.SetX(transform.position.GetX() + physics.velocity.GetX());
-    transform.position.SetY(transform.position.GetY() + physics.velocity.GetY());
+    direction = direction / length;
 
+    // Full speed along the direction
+    float patrolSpeed = physics.maxVelocity > 0.f ? physics.maxVelocity : defaultPatrolSpeed;
+    physics.desiredVelocity = direction * patrolSpeed;
 }
@@ -39,7 +39,17 @@ public:
 	void updatePatrolState(Entity entity);
 
 private:
+	// Move on to the next waypoint and start timing the way there
+	void nextWaypoint();
+
+	// Patrol speed for enemies whose PhysicsComponent sets no maxVelocity
+	static constexpr float defaultPatrolSpeed = 12.f;
+	// Seconds without getting any closer before a blocked waypoint is skipped
+	static constexpr float waypointTimeout = 2.f;
+
 	STATE currentState;
 	std::vector<myMath::Vector2D> waypoints;
 	int currentWaypointIndex = 0;
+	float closestDistance;		// nearest the enemy has come to the current waypoint
+	float stuckTime = 0.f;		// time since it last got closer
 };
\ No newline at end of file
@@ -18,35 +18,26 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "GlobalCoordinator.h"
 #include "PhyColliSystemECS.h"
 
+//Collisions are reported through the trigger events, nothing to poll here
 void ExitBehaviour::update(Entity entity) {
-	if (GLFWFunctions::collectableCount == 0) {
-		auto playerEntity = ecsCoordinator.getEntityFromID("player");
-		auto PhysicsSystemRef = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
-		auto collisionSystem = PhysicsSystemRef->getCollisionSystem();
-
-
-		for (auto& findPlayer : ecsCoordinator.getAllLiveEntities()) {
-			if (ecsCoordinator.hasComponent<PlayerComponent>(findPlayer)) {
-				playerEntity = findPlayer;
-				break;
-			}
-		}
-
-		//get the position of the player and the collectable
-		auto& playerTransform = ecsCoordinator.getComponent<TransformComponent>(playerEntity);
-		myMath::Vector2D& playerPos = playerTransform.position;
-		float radius = playerTransform.scale.GetX() * 0.5f;
-
-		CollisionSystemECS::OBB playerOBB = collisionSystem.createOBBFromEntity(playerEntity);
-		CollisionSystemECS::OBB exitOBB = collisionSystem.createOBBFromEntity(entity);
-
-		myMath::Vector2D normal{};
-		float penetration{};
+	(void)entity;
+}
+
+void ExitBehaviour::onTriggerEnter(Entity entity, Entity other) {
+	onTriggerStay(entity, other);
+}
+
+//The exit only counts once every collectable has been picked up
+void ExitBehaviour::onTriggerStay(Entity entity, Entity other) {
+	(void)entity;
+	if (ecsCoordinator.hasComponent<PlayerComponent>(other)) {
+		GLFWFunctions::exitCollision = (GLFWFunctions::collectableCount == 0);
+	}
+}
 
-		bool isColliding = collisionSystem.checkCircleOBBCollision(playerPos, radius, exitOBB, normal, penetration);
-		GLFWFunctions::exitCollision = isColliding;
-		if (isColliding) {
-			//std::cout << "Game Won" << std::endl;
-		}
+void ExitBehaviour::onTriggerExit(Entity entity, Entity other) {
+	(void)entity;
+	if (ecsCoordinator.hasComponent<PlayerComponent>(other)) {
+		GLFWFunctions::exitCollision = false;
 	}
-}
\ No newline at end of file
+}
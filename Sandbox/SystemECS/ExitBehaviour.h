@@ -16,4 +16,9 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 class ExitBehaviour : public BehaviourECS {
 public:
 	void update(Entity entity) override;
+
+	bool usesTriggerEvents() const override { return true; }
+	void onTriggerEnter(Entity entity, Entity other) override;
+	void onTriggerStay(Entity entity, Entity other) override;
+	void onTriggerExit(Entity entity, Entity other) override;
 };
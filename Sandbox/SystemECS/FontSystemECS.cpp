@@ -12,6 +12,8 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
         - Developed default and parameterized constructors to initialize FontSystemECS with or without custom font size.
         - Implemented initialise() to manage the initialization of FontSystem, including font loading with size control.
         - Added update() to iterate over font entities and render text based on entity components and delta time.
+        - Flushed the sprite batch after queueing the text so all of it is drawn together,
+          and let the font system drop the layouts of text that is no longer shown.
         - Implemented cleanup() to release resources and reset FontSystemECS to a clean state.
         - Created getSystemECS() to return the system type as a string for ECS identification purposes.
 
@@ -73,6 +75,11 @@ void FontSystemECS::update(float dt) {
         }
     }
 
+    // Graphics has already flushed this frame, so draw the queued text now,
+    // one draw call per font atlas
+    graphicsSystem.FlushSprites();
+    fontSystem->endFrame();
+
 }
 
 void FontSystemECS::cleanup() {
@@ -11,6 +11,7 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 *//*____________________________________________________________________________-*/
 #pragma once
 #include "vector2D.h"
+#include "ECSDefinitions.h"
 
 class Force
 {
@@ -29,15 +30,28 @@ private:
 	float magnitude;
 };
 
+struct PhysicsComponent;
+struct TransformComponent;
+
 class ForceManager
 {
 public:
 
+	// Look the entity's components up once and forward to the versions below.
+	// Adding a force to a sleeping body wakes its island
 	void AddForce(Entity player, const myMath::Vector2D& appliedForce);
 
 	void ClearForce(Entity player);
 
-	void ApplyForce(Entity player, myMath::Vector2D direction, float magnitude);
+	void ApplyForce(Entity player, myMath::Vector2D direction, float magnitude, float dt);
+
+	// Work on components the caller already holds, used by the physics step
+	// for every body at once
+	static void AddForce(PhysicsComponent& physics, const myMath::Vector2D& appliedForce);
+
+	static void ClearForce(PhysicsComponent& physics);
+
+	static void ApplyForce(PhysicsComponent& physics, TransformComponent& transform, const myMath::Vector2D& direction, float targetForce, float dt);
 
-	float ResultantForce(myMath::Vector2D direction, myMath::Vector2D normal, float maxAccForce);
+	static float ResultantForce(const myMath::Vector2D& direction, const myMath::Vector2D& normal, float maxAccForce);
 };
\ No newline at end of file
@@ -25,12 +25,15 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "BehaviourComponent.h"
 #include "BackgroundComponent.h"
 #include "UIComponent.h"
+#include "PhyColliSystemECS.h"
 
 #include "GlobalCoordinator.h"
 #include "GraphicsSystem.h"
+#include "GLStateCache.h"
 #include "Debug.h"
 #include "GUIConsole.h"
 #include "vector"
+#include <algorithm>
 
 bool gameover = false;
 
@@ -72,49 +75,57 @@ void createTextEntity(
 }
 
 //std::unique_ptr<EntityManager> entityManager;
-//Initialise currently does not do anything
+//Initialise starts the threads that record the sprites, one per hardware thread
 void GraphicSystemECS::initialise() {
-
+    recordPool.resize(0);
 }
 
 //Update function to update the graphics system
 //uses functions from GraphicsSystem class to update, draw
 //and render objects.
 void GraphicSystemECS::update(float dt) {
+    (void)dt; // Animations are advanced by AnimationSystemECS
+    auto physicsSystem = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
+
+    // The bind counts in the debug window cover one frame, from this call to the next
+    GLStateCache::BeginFrame();
 
+    // With the editor open, the sprites and text of this frame go into the viewport panel's texture
+    graphicsSystem.UpdateViewport();
+    graphicsSystem.BeginScene();
+
+    SpriteCuller& spriteCuller = graphicsSystem.GetSpriteCuller();
+    spriteCuller.beginFrame();
+    drawList.clear();
 
     for (auto entity : ecsCoordinator.getAllLiveEntities()) {
         // Check if the entity has a transform component
         auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
         Console::GetLog() << "Entity: " << entity << " Position: " << transform.position.GetX() << ", " << transform.position.GetY() << std::endl;
 
-        // Check if the entity has an animation component
-        auto& animation = ecsCoordinator.getComponent<AnimationComponent>(entity);
-        Console::GetLog() << "Entity: " << entity << " Animation: " << (animation.isAnimated ? "True" : "False") << std::endl;
+        // Check if the entity has an animation component. Asking for a missing one
+        // would hand back another entity's, so check first
+        if (ecsCoordinator.hasComponent<AnimationComponent>(entity)) {
+            auto& animation = ecsCoordinator.getComponent<AnimationComponent>(entity);
+            Console::GetLog() << "Entity: " << entity << " Animation: " << (animation.isAnimated ? "True" : "False") << std::endl;
+        }
 
         auto entitySig = ecsCoordinator.getEntitySignature(entity);
 
-        bool isPlayer = ecsCoordinator.hasComponent<PlayerComponent>(entity);
-        bool isEnemy = ecsCoordinator.hasComponent<EnemyComponent>(entity);
-        bool hasMovement = ecsCoordinator.hasComponent<PhysicsComponent>(entity);
-        bool isBackground = ecsCoordinator.hasComponent<BackgroundComponent>(entity);
-        bool isPlatform = ecsCoordinator.hasComponent<ClosestPlatform>(entity);
         bool isButton = ecsCoordinator.hasComponent<ButtonComponent>(entity);
-		bool isCollectable = ecsCoordinator.hasComponent<CollectableComponent>(entity);
-		bool isPump = ecsCoordinator.hasComponent<PumpComponent>(entity);
-		bool isExit = ecsCoordinator.hasComponent<ExitComponent>(entity);
         bool isUI = ecsCoordinator.hasComponent<UIComponent>(entity);
-        bool isAnimate = false;
+        bool isTilemap = ecsCoordinator.hasComponent<TilemapComponent>(entity);
 
-        if (ecsCoordinator.hasComponent<PumpComponent>(entity)) {
-            const auto& pumpComponent = ecsCoordinator.getComponent<PumpComponent>(entity);
-            isAnimate = pumpComponent.isAnimate;
-        }
+        // Physics runs on a fixed step, so draw bodies between their last two steps
+        renderPositions[entity] = physicsSystem->getInterpolatedPosition(entity, transform);
 
-        // Use hasMovement for the update parameter
-        graphicsSystem.Update(dt / 10.0f, (isAnimate&& isPump) || (isPlayer && hasMovement) || (isEnemy && hasMovement)); // Use hasMovement instead of true
-        myMath::Matrix3x3 identityMatrix = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f };
-        transform.mdl_xform = graphicsSystem.UpdateObject(transform.position, transform.scale, transform.orientation, cameraSystem.getViewMatrix());
+        // Screen space sprites are always drawn, and tilemaps cull their own chunks
+        if (isButton || isUI || isTilemap) {
+            drawList.push_back(entity);
+        }
+        else {
+            spriteCuller.update(entity, SpriteCuller::GetSpriteBounds(renderPositions[entity], transform.scale, transform.orientation));
+        }
 
         // Compute view matrix
         if (GLFWFunctions::allow_camera_movement) { // Press F2 to allow camera movement
@@ -167,83 +178,177 @@ void GraphicSystemECS::update(float dt) {
 		{
 			GLFWFunctions::collectableCount = 0;
 		}
-        
-        // TODO:: Update AABB component inside game loop
-        // Press F1 to draw out debug AABB
-        if (GLFWFunctions::debug_flag && !ecsCoordinator.hasComponent<FontComponent>(entity) && !ecsCoordinator.hasComponent<PlayerComponent>(entity)) {
-            if (ecsCoordinator.getEntityID(entity) == "quitButton" || ecsCoordinator.getEntityID(entity) == "retryButton")
-            {
-                graphicsSystem.drawDebugOBB(ecsCoordinator.getComponent<TransformComponent>(entity), identityMatrix);
-            }
+    }
 
-            else
-            {
-                graphicsSystem.drawDebugOBB(ecsCoordinator.getComponent<TransformComponent>(entity), cameraSystem.getViewMatrix());
+    // Only the sprites in the camera's view are transformed and submitted. The
+    // camera has moved by now, so all of them use this frame's view
+    myMath::Matrix3x3 viewMatrix = cameraSystem.getViewMatrix();
+    SpriteCuller::Bounds viewBounds = SpriteCuller::GetViewBounds(viewMatrix, static_cast<float>(GLFWFunctions::windowWidth), static_cast<float>(GLFWFunctions::windowHeight));
+    spriteCuller.queryVisible(viewBounds, visibleEntities);
+    drawList.insert(drawList.end(), visibleEntities.begin(), visibleEntities.end());
+    std::sort(drawList.begin(), drawList.end());
+
+    spriteJobs.clear();
+    for (auto entity : drawList) {
+        prepareEntity(entity, viewMatrix, viewBounds);
+    }
+
+    // The sprites are transformed and recorded on the worker pool, each slice
+    // of the draw list into its own list of the render queue. The queue gathers
+    // the lists in slice order, so the frame comes out the same however the
+    // slices were scheduled
+    size_t lists = std::clamp((spriteJobs.size() + minJobsPerList - 1) / minJobsPerList, size_t(1), recordPool.getWorkerCount());
+    graphicsSystem.GetSpriteBatch().getQueue().setListCount(lists);
+    recordPool.parallelFor(lists, 1, [this, lists, &viewMatrix](size_t begin, size_t end, size_t) {
+        for (size_t list = begin; list < end; list++) {
+            size_t last = spriteJobs.size() * (list + 1) / lists;
+            for (size_t job = spriteJobs.size() * list / lists; job < last; job++) {
+                recordSprites(spriteJobs[job], viewMatrix, list);
             }
         }
-		else if (GLFWFunctions::debug_flag && ecsCoordinator.hasComponent<PlayerComponent>(entity)) {
-			graphicsSystem.drawDebugCircle(ecsCoordinator.getComponent<TransformComponent>(entity), cameraSystem.getViewMatrix());
-		}
-        if (isAnimate && GLFWFunctions::isPumpOn) {
-            graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("bubbles 3.png"), transform.mdl_xform);
-        }
-        // Drawing based on entity components
-        if (isEnemy) {
-            graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("goldfish"), transform.mdl_xform);
-        }
-        else if (isPlayer) {
-            graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("mossball"), transform.mdl_xform);
-        }
-        else if (isPump && !isAnimate) {
-            graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("airVent"), transform.mdl_xform);
+    });
+
+    // Every sprite of the frame is drawn here, one draw call per texture in each layer
+    graphicsSystem.FlushSprites();
+}
+
 
+//Pick the sprites of one entity that is drawn this frame and queue its debug
+//outline and tilemap. The sprites are transformed and recorded afterwards by
+//recordSprites, on the worker pool
+void GraphicSystemECS::prepareEntity(Entity entity, const myMath::Matrix3x3& viewMatrix, const SpriteCuller::Bounds& viewBounds) {
+    auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+
+    bool isPlayer = ecsCoordinator.hasComponent<PlayerComponent>(entity);
+    bool isEnemy = ecsCoordinator.hasComponent<EnemyComponent>(entity);
+    bool isBackground = ecsCoordinator.hasComponent<BackgroundComponent>(entity);
+    bool isPlatform = ecsCoordinator.hasComponent<ClosestPlatform>(entity);
+    bool isButton = ecsCoordinator.hasComponent<ButtonComponent>(entity);
+	bool isCollectable = ecsCoordinator.hasComponent<CollectableComponent>(entity);
+	bool isPump = ecsCoordinator.hasComponent<PumpComponent>(entity);
+	bool isExit = ecsCoordinator.hasComponent<ExitComponent>(entity);
+    bool isUI = ecsCoordinator.hasComponent<UIComponent>(entity);
+    bool isTilemap = ecsCoordinator.hasComponent<TilemapComponent>(entity);
+    bool isAnimate = false;
+
+    if (ecsCoordinator.hasComponent<PumpComponent>(entity)) {
+        const auto& pumpComponent = ecsCoordinator.getComponent<PumpComponent>(entity);
+        isAnimate = pumpComponent.isAnimate;
+    }
+
+    // Frame picked for this entity by AnimationSystemECS, if it animates
+    const AnimationFrameUV* animationFrame = nullptr;
+    if (ecsCoordinator.hasComponent<AnimationComponent>(entity)) {
+        const auto& animation = ecsCoordinator.getComponent<AnimationComponent>(entity);
+        if (animation.isPlaying) {
+            animationFrame = &animation.frameUV;
         }
-        else if (isPlatform) {
-            graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("woodtile"), transform.mdl_xform);
+    }
+
+    myMath::Matrix3x3 identityMatrix = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f };
+
+    // Buttons and UI are placed on screen, everything else in the world
+    SpriteJob job{};
+    job.transform = &transform;
+    job.screenSpace = isButton || isUI;
+    job.position = job.screenSpace ? transform.position : renderPositions[entity];
+    auto addSprite = [&job](const AtlasSprite& sprite, SpriteLayer layer, const AnimationFrameUV* frame = nullptr) {
+        job.sprites[job.spriteCount++] = { sprite, layer, frame };
+    };
+
+    // TODO:: Update AABB component inside game loop
+    // Press F1 to draw out debug AABB
+    // Debug outlines are drawn in one go after every sprite, so sprites never cover them
+    if (GLFWFunctions::debug_flag && !ecsCoordinator.hasComponent<FontComponent>(entity) && !ecsCoordinator.hasComponent<PlayerComponent>(entity)) {
+        myMath::Matrix3x3 debugView = cameraSystem.getViewMatrix();
+        if (ecsCoordinator.getEntityID(entity) == "quitButton" || ecsCoordinator.getEntityID(entity) == "retryButton")
+        {
+            debugView = identityMatrix;
         }
-        else if (isButton) {
-            transform.mdl_xform = graphicsSystem.UpdateObject(transform.position, transform.scale, transform.orientation, identityMatrix);
 
-            if (ecsCoordinator.getEntityID(entity) == "quitButton") {
-                graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("buttonQuit"), transform.mdl_xform);
-            }
+        graphicsSystem.drawDebugOBB(transform, debugView);
+    }
+	else if (GLFWFunctions::debug_flag && ecsCoordinator.hasComponent<PlayerComponent>(entity)) {
+        myMath::Matrix3x3 debugView = cameraSystem.getViewMatrix();
+        graphicsSystem.drawDebugCircle(transform, debugView);
+	}
+    if (isAnimate && GLFWFunctions::isPumpOn) {
+        addSprite(assetsManager.GetSprite("bubbles 3.png"), SpriteLayer::EFFECTS, animationFrame);
+    }
+    // Drawing based on entity components
+    if (isEnemy) {
+        addSprite(assetsManager.GetSprite("goldfish"), SpriteLayer::CHARACTERS, animationFrame);
+    }
+    else if (isPlayer) {
+        addSprite(assetsManager.GetSprite("mossball"), SpriteLayer::CHARACTERS, animationFrame);
+    }
+    else if (isPump && !isAnimate) {
+        addSprite(assetsManager.GetSprite("airVent"), SpriteLayer::PROPS);
 
-            else if (ecsCoordinator.getEntityID(entity) == "retryButton")
-            {
-                graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("buttonRetry"), transform.mdl_xform);
-            }
+    }
+    else if (isPlatform) {
+        addSprite(assetsManager.GetSprite("woodtile"), SpriteLayer::LEVEL);
+    }
+    else if (isTilemap) {
+        // Chunks keep their own meshes, so they are drawn when the batch reaches the level layer
+        myMath::Vector2D origin = transform.position;
+        graphicsSystem.GetSpriteBatch().submitCustom(static_cast<int>(SpriteLayer::LEVEL), [entity, origin, viewMatrix, viewBounds]() {
+            graphicsSystem.DrawTilemap(entity, ecsCoordinator.getComponent<TilemapComponent>(entity), origin, viewMatrix, viewBounds);
+        });
+    }
+    else if (isButton) {
+        if (ecsCoordinator.getEntityID(entity) == "quitButton") {
+            addSprite(assetsManager.GetSprite("buttonQuit"), SpriteLayer::UI);
         }
-        else if (isCollectable) {
-            graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("collectMoss"), transform.mdl_xform);
+
+        else if (ecsCoordinator.getEntityID(entity) == "retryButton")
+        {
+            addSprite(assetsManager.GetSprite("buttonRetry"), SpriteLayer::UI);
+        }
+    }
+    else if (isCollectable) {
+        addSprite(assetsManager.GetSprite("collectMoss"), SpriteLayer::PROPS);
+    }
+    else if (isExit) {
+        addSprite(assetsManager.GetSprite("exitFilter"), SpriteLayer::PROPS);
+    }
+    else if (isBackground) {
+        addSprite(assetsManager.GetSprite("background"), SpriteLayer::BACKGROUND);
+    }
+    else if (isUI) {
+        if (GLFWFunctions::collectableCount == 0) {
+            addSprite(assetsManager.GetSprite("UI Counter-3"), SpriteLayer::UI);
         }
-        else if (isExit) {
-            graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("exitFilter"), transform.mdl_xform);
+        else if (GLFWFunctions::collectableCount == 1) {
+            addSprite(assetsManager.GetSprite("UI Counter-2"), SpriteLayer::UI);
         }
-        else if (isBackground) {
-            graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("background"), transform.mdl_xform);
+        else if (GLFWFunctions::collectableCount == 2) {
+            addSprite(assetsManager.GetSprite("UI Counter-1"), SpriteLayer::UI);
         }
-        else if (isUI) {
-            transform.mdl_xform = graphicsSystem.UpdateObject(transform.position, transform.scale, transform.orientation, identityMatrix);
-
-            if (GLFWFunctions::collectableCount == 0) {
-                graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("UI Counter-3"), transform.mdl_xform);
-            }
-            else if (GLFWFunctions::collectableCount == 1) {
-                graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("UI Counter-2"), transform.mdl_xform);
-            }
-            else if (GLFWFunctions::collectableCount == 2) {
-                graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("UI Counter-1"), transform.mdl_xform);
-            }
-            else if (GLFWFunctions::collectableCount >= 3) {
-                graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture("UI Counter-0"), transform.mdl_xform);
-            }
+        else if (GLFWFunctions::collectableCount >= 3) {
+            addSprite(assetsManager.GetSprite("UI Counter-0"), SpriteLayer::UI);
         }
+    }
 
-        else if (ecsCoordinator.hasComponent<TransformComponent>(entity) &&
-                 ecsCoordinator.hasComponent<BehaviourComponent>(entity) &&
-                 ecsCoordinator.getEntitySignature(entity).count() == 2) {
-                 graphicsSystem.DrawObject(GraphicsSystem::DrawMode::TEXTURE, assetsManager.GetTexture(ecsCoordinator.getEntityID(entity)), transform.mdl_xform);
+    else if (ecsCoordinator.hasComponent<TransformComponent>(entity) &&
+             ecsCoordinator.hasComponent<BehaviourComponent>(entity) &&
+             ecsCoordinator.getEntitySignature(entity).count() == 2) {
+             addSprite(assetsManager.GetSprite(ecsCoordinator.getEntityID(entity)), SpriteLayer::PROPS);
        }
+
+    spriteJobs.push_back(job);
+}
+
+//Transform the sprites picked by prepareEntity and record them into a list of
+//the render queue. Only touches the job's own transform and the given list
+void GraphicSystemECS::recordSprites(const SpriteJob& job, const myMath::Matrix3x3& viewMatrix, size_t list) {
+    static const myMath::Matrix3x3 identityMatrix = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f };
+
+    TransformComponent& transform = *job.transform;
+    transform.mdl_xform = graphicsSystem.UpdateObject(job.position, transform.scale, transform.orientation, job.screenSpace ? identityMatrix : viewMatrix);
+
+    for (int i = 0; i < job.spriteCount; i++) {
+        graphicsSystem.DrawSprite(job.sprites[i].sprite, transform.mdl_xform, job.sprites[i].layer, job.sprites[i].frame, list);
     }
 }
 
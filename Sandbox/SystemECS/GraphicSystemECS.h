@@ -8,7 +8,8 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 		 This class is used to handle the communication between ECS and graphic
 		 system.
 		 Joel Chu (c.weiyuan): Declared class GraphicSystemECS with its functions.
-							   inherited from System class.
+							   inherited from System class. Only entities in
+							   the camera's view are drawn.
 							   100%
 *//*___________________________________________________________________________-*/
 #pragma once
@@ -17,6 +18,8 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "EntityManager.h"
 #include "GraphicsSystem.h"
 #include "CameraSystem2D.h"
+#include "TransformComponent.h"
+#include "WorkerPool.h"
 
 class GraphicSystemECS : public System
 {
@@ -36,4 +39,35 @@ public:
 	std::string getSystemECS() override;
 
 private:
+	//Sprites of one entity, picked on the main thread and recorded on a worker
+	struct SpriteDraw {
+		AtlasSprite sprite;
+		SpriteLayer layer;
+		const AnimationFrameUV* frame;
+	};
+
+	struct SpriteJob {
+		TransformComponent* transform;
+		myMath::Vector2D position;
+		bool screenSpace;
+		SpriteDraw sprites[2];
+		int spriteCount;
+	};
+
+	//Pick the sprites of an entity that is drawn this frame, and queue its
+	//debug outline and tilemap, which cannot be recorded from a worker
+	void prepareEntity(Entity entity, const myMath::Matrix3x3& viewMatrix, const SpriteCuller::Bounds& viewBounds);
+
+	//Transform the sprites of a job and record them into a list of the render queue
+	static void recordSprites(const SpriteJob& job, const myMath::Matrix3x3& viewMatrix, size_t list);
+
+	//Interpolated position of each entity this frame, by entity
+	std::vector<myMath::Vector2D> renderPositions = std::vector<myMath::Vector2D>(MAX_ENTITIES);
+	std::vector<Entity> drawList;
+	std::vector<Entity> visibleEntities;
+	std::vector<SpriteJob> spriteJobs;
+
+	//Fewer jobs than this are not worth a list of their own
+	static constexpr size_t minJobsPerList = 64;
+	WorkerPool recordPool;
 };
\ No newline at end of file
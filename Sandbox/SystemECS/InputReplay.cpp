@@ -0,0 +1,264 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   InputReplay.cpp
+@brief:  This source file contains the implementation of the InputReplay class,
+         recording keyboard state per simulation tick to JSON and replaying
+         it headlessly for regression checks and physics benchmarking.
+         Lee Jing Wen (jingwen.lee): Defined the InputReplay class
+                                     100%
+*//*____________________________________________________________________________-*/
+
+#include "InputReplay.h"
+#include "GlobalCoordinator.h"
+#include "LogicSystemECS.h"
+#include "PhyColliSystemECS.h"
+#include "GUIGameViewport.h"
+#include "GUIConsole.h"
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+
+bool InputReplay::recording = false;
+bool InputReplay::replayRequested = false;
+bool InputReplay::wasDeterministic = false;
+unsigned long long InputReplay::tick = 0;
+std::string InputReplay::scenePath;
+std::vector<InputReplay::KeyEvent> InputReplay::events;
+std::unordered_map<Key, bool> InputReplay::previousKeys;
+
+namespace
+{
+    std::string hashToString(uint64_t hash)
+    {
+        std::ostringstream stream;
+        stream << std::hex << std::setw(16) << std::setfill('0') << hash;
+        return stream.str();
+    }
+}
+
+bool InputReplay::isControlKey(Key key)
+{
+    return key == Key::F5 || key == Key::F6;
+}
+
+std::string InputReplay::getCurrentScenePath()
+{
+    int scene = GameViewWindow::getSceneNum();
+    return scene != 0 ? FilePathManager::GetSaveJSONPath(scene) : FilePathManager::GetEntitiesJSONPath();
+}
+
+void InputReplay::restartScene(std::string const& path)
+{
+    for (auto entity : ecsCoordinator.getAllLiveEntities())
+    {
+        ecsCoordinator.destroyEntity(entity);
+    }
+
+    // Ids are recycled first in first out, so without this the reloaded scene
+    // gets different ids every time and bodies are stepped in another order
+    if (!ecsCoordinator.resetEntityIDs())
+    {
+        Console::GetLog() << "Warning: entity ids could not be reset, the replay may not match the recording" << std::endl;
+    }
+
+    // Gameplay flags that live outside the ECS also feed the simulation
+    GLFWFunctions::isPumpOn = true;
+    GLFWFunctions::exitCollision = false;
+
+    auto physicsSystem = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
+    physicsSystem->ResetSimulation();
+    physicsSystem->LoadPhysicsConfigFromJSON(FilePathManager::GetPhysicsPath());
+
+    ecsCoordinator.LoadEntityFromJSON(ecsCoordinator, path);
+}
+
+// Only changes are stored, so a held key costs one event when pressed and
+// one when released regardless of how many ticks it is held for
+void InputReplay::beginTick()
+{
+    if (replayRequested)
+    {
+        replayRequested = false;
+        runHeadless(FilePathManager::GetReplayJSONPath());
+    }
+
+    if (!recording)
+    {
+        return;
+    }
+
+    for (auto const& [key, pressed] : *GLFWFunctions::keyState)
+    {
+        if (isControlKey(key))
+        {
+            continue;
+        }
+
+        auto it = previousKeys.find(key);
+        bool wasPressed = it != previousKeys.end() && it->second;
+        if (pressed != wasPressed)
+        {
+            events.push_back({ tick, key, pressed });
+            previousKeys[key] = pressed;
+        }
+    }
+
+    tick++;
+}
+
+void InputReplay::toggleRecording()
+{
+    if (recording)
+    {
+        stopRecording();
+    }
+    else
+    {
+        startRecording();
+    }
+}
+
+// The scene is reloaded so the recording starts from a state the replay can
+// reproduce exactly
+void InputReplay::startRecording()
+{
+    wasDeterministic = PhysicsSystemECS::IsDeterministic();
+    scenePath = getCurrentScenePath();
+    restartScene(scenePath);
+    PhysicsSystemECS::SetDeterministic(true);
+
+    events.clear();
+    previousKeys.clear();
+    tick = 0;
+    recording = true;
+
+    Console::GetLog() << "Input recording started on " << scenePath << std::endl;
+}
+
+void InputReplay::stopRecording()
+{
+    recording = false;
+    PhysicsSystemECS::SetDeterministic(wasDeterministic);
+
+    uint64_t hash = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->ComputeStateHash();
+
+    nlohmann::json eventArray = nlohmann::json::array();
+    for (auto const& event : events)
+    {
+        eventArray.push_back({ { "tick", event.tick }, { "key", static_cast<int>(event.key) }, { "pressed", event.pressed } });
+    }
+
+    nlohmann::json jsonObj;
+    jsonObj["replay"]["scene"] = scenePath;
+    jsonObj["replay"]["fixedDeltaTime"] = PhysicsSystemECS::GetFixedDeltaTime();
+    jsonObj["replay"]["ticks"] = tick;
+    jsonObj["replay"]["finalHash"] = hashToString(hash);
+    jsonObj["replay"]["events"] = eventArray;
+
+    std::string filename = FilePathManager::GetReplayJSONPath();
+    std::ofstream outputFile(filename);
+    if (!outputFile.is_open())
+    {
+        Console::GetLog() << "Error: could not save to file " << filename << std::endl;
+        return;
+    }
+    outputFile << jsonObj.dump(2);
+
+    Console::GetLog() << "Input recording saved: " << tick << " ticks, " << events.size()
+                      << " key events, final hash " << hashToString(hash) << std::endl;
+
+    // Replayed at the start of the next tick, a recording that does not
+    // reproduce its own hash is useless as a regression check
+    replayRequested = true;
+}
+
+bool InputReplay::runHeadless(std::string const& filename)
+{
+    if (recording)
+    {
+        Console::GetLog() << "Error: cannot replay while recording" << std::endl;
+        return false;
+    }
+
+    JSONSerializer serializer;
+
+    // checks if the JSON file can be opened
+    if (!serializer.Open(filename))
+    {
+        Console::GetLog() << "Error: could not open file " << filename << std::endl;
+        return false;
+    }
+
+    nlohmann::json jsonObj = serializer.GetJSONObject();
+    if (!jsonObj.contains("replay"))
+    {
+        Console::GetLog() << "Error: " << filename << " is not an input recording" << std::endl;
+        return false;
+    }
+
+    nlohmann::json const& replay = jsonObj["replay"];
+    std::string replayScene = replay.value("scene", std::string{});
+    unsigned long long ticks = replay.value("ticks", 0ull);
+    std::string expectedHash = replay.value("finalHash", std::string{});
+    float recordedDeltaTime = replay.value("fixedDeltaTime", PhysicsSystemECS::GetFixedDeltaTime());
+
+    std::vector<KeyEvent> replayEvents;
+    for (auto const& event : replay.value("events", nlohmann::json::array()))
+    {
+        replayEvents.push_back({ event["tick"].get<unsigned long long>(), static_cast<Key>(event["key"].get<int>()), event["pressed"].get<bool>() });
+    }
+
+    if (recordedDeltaTime != PhysicsSystemECS::GetFixedDeltaTime())
+    {
+        Console::GetLog() << "Warning: replay was recorded at a different fixed timestep, results will differ" << std::endl;
+    }
+
+    // The live input and timing are put back once the replay is done
+    std::unordered_map<Key, bool> liveKeys = *GLFWFunctions::keyState;
+    bool liveDeterministic = PhysicsSystemECS::IsDeterministic();
+    float liveDeltaTime = GLFWFunctions::delta_time;
+
+    restartScene(replayScene);
+    PhysicsSystemECS::SetDeterministic(true);
+    GLFWFunctions::keyState->clear();
+
+    auto logicSystem = ecsCoordinator.getSpecificSystem<LogicSystemECS>();
+    auto physicsSystem = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
+    float dt = PhysicsSystemECS::GetFixedDeltaTime();
+
+    size_t nextEvent = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (unsigned long long replayTick = 0; replayTick < ticks; replayTick++)
+    {
+        while (nextEvent < replayEvents.size() && replayEvents[nextEvent].tick == replayTick)
+        {
+            (*GLFWFunctions::keyState)[replayEvents[nextEvent].key] = replayEvents[nextEvent].pressed;
+            nextEvent++;
+        }
+
+        GLFWFunctions::frameNumber++;
+        GLFWFunctions::delta_time = dt;
+        logicSystem->update(dt);
+        physicsSystem->update(dt);
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    double totalMs = std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::string hash = hashToString(physicsSystem->ComputeStateHash());
+    bool matches = hash == expectedHash;
+
+    *GLFWFunctions::keyState = liveKeys;
+    PhysicsSystemECS::SetDeterministic(liveDeterministic);
+    GLFWFunctions::delta_time = liveDeltaTime;
+
+    Console::GetLog() << "Replay: " << ticks << " ticks in " << totalMs << " ms ("
+                      << (ticks > 0 ? totalMs / static_cast<double>(ticks) : 0.0) << " ms/tick), final hash " << hash
+                      << (matches ? " matches the recording" : " differs from the recording (" + expectedHash + ")") << std::endl;
+
+    return matches;
+}
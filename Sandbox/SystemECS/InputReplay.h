@@ -0,0 +1,67 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   InputReplay.h
+@brief:  This header file contains the declaration of the InputReplay class. It
+         records the keyboard state changes of every simulation tick while the
+         physics system runs in deterministic mode, and replays a recording
+         without rendering to benchmark the simulation and compare its final
+         state hash against the recorded one.
+         Lee Jing Wen (jingwen.lee): Declared the InputReplay class
+                                     100%
+*//*____________________________________________________________________________-*/
+#pragma once
+#include "GlfwFunctions.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class InputReplay
+{
+public:
+    // Called by the system manager once per tick, before logic and physics
+    static void beginTick();
+
+    // Start a recording from a freshly reloaded scene, or stop and save it.
+    // A saved recording is replayed on the next tick to check it reproduces
+    // its own hash
+    static void toggleRecording();
+    static bool isRecording() { return recording; }
+
+    // Run the saved recording at the start of the next tick
+    static void requestReplay() { replayRequested = true; }
+
+    // Reload the recorded scene and step logic and physics through every
+    // recorded tick without rendering. Returns true when the final state
+    // hash matches the one stored with the recording
+    static bool runHeadless(std::string const& filename);
+
+private:
+    struct KeyEvent {
+        unsigned long long tick;
+        Key key;
+        bool pressed;
+    };
+
+    static void startRecording();
+    static void stopRecording();
+
+    // Destroy every entity and load the scene again with fresh simulation state
+    // and entity ids
+    static void restartScene(std::string const& scenePath);
+
+    static std::string getCurrentScenePath();
+
+    // Keys that drive the recorder itself are never recorded
+    static bool isControlKey(Key key);
+
+    static bool recording;
+    static bool replayRequested;
+    static bool wasDeterministic;
+    static unsigned long long tick;
+    static std::string scenePath;
+    static std::vector<KeyEvent> events;
+    static std::unordered_map<Key, bool> previousKeys;
+};
@@ -26,6 +26,7 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 
 #include "Debug.h"
 #include "GUIConsole.h"
+#include <algorithm>
 
 void LogicSystemECS::initialise() {}
 
@@ -48,10 +49,44 @@ void LogicSystemECS::update(float dt) {
 
 void LogicSystemECS::assignBehaviour(Entity entity, std::shared_ptr<BehaviourECS> behaviour) {
 	behaviours[entity] = behaviour;
+
+	bool hasTrigger = ecsCoordinator.hasComponent<TriggerComponent>(entity);
+	if (behaviour->usesTriggerEvents() && !hasTrigger) {
+		ecsCoordinator.addComponent(entity, TriggerComponent{});
+	}
+	else if (!behaviour->usesTriggerEvents() && hasTrigger) {
+		ecsCoordinator.removeComponent<TriggerComponent>(entity);
+	}
 }
 
 void LogicSystemECS::unassignBehaviour(Entity entity) {
 	behaviours.erase(entity);
+
+	if (ecsCoordinator.hasComponent<TriggerComponent>(entity)) {
+		ecsCoordinator.removeComponent<TriggerComponent>(entity);
+	}
+}
+
+void LogicSystemECS::dispatchTriggerEvent(TriggerEvent event, Entity trigger, Entity other) {
+	auto it = behaviours.find(trigger);
+	if (it == behaviours.end()) {
+		return;
+	}
+
+	//Keep the behaviour alive in case the event unassigns or destroys it
+	std::shared_ptr<BehaviourECS> behaviour = it->second;
+
+	switch (event) {
+	case TriggerEvent::ENTER:
+		behaviour->onTriggerEnter(trigger, other);
+		break;
+	case TriggerEvent::STAY:
+		behaviour->onTriggerStay(trigger, other);
+		break;
+	case TriggerEvent::EXIT:
+		behaviour->onTriggerExit(trigger, other);
+		break;
+	}
 }
 
 
@@ -75,48 +110,59 @@ void MouseBehaviour::update(Entity entity) {
 	(void)entity;
 }
 
-void MouseBehaviour::onMouseClick(GLFWwindow* window, double mouseX, double mouseY)
+std::vector<Entity> MouseBehaviour::buttonsUnderCursor(double mouseX, double mouseY)
 {
-	auto allEntities = ecsCoordinator.getAllLiveEntities();
-
-	for (auto& entity : allEntities)
+	std::vector<Entity> candidates;
+	ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->QueryScreenPoint(
+		myMath::Vector2D(static_cast<float>(mouseX), static_cast<float>(mouseY)), candidates,
+		[](Entity entity) { return ecsCoordinator.hasComponent<ButtonComponent>(entity); });
+
+	//the point query uses the full button, the clickable area is smaller
+	std::vector<Entity> buttons;
+	for (auto& entity : candidates)
 	{
-		if (ecsCoordinator.hasComponent<ButtonComponent>(entity))
+		if (mouseIsOverButton(mouseX, mouseY, ecsCoordinator.getComponent<TransformComponent>(entity)))
 		{
-			TransformComponent& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
-
-			if (mouseIsOverButton(mouseX, mouseY, transform))
-			{
-				handleButtonClick(window, entity);
-			}
+			buttons.push_back(entity);
 		}
 	}
+	return buttons;
+}
+
+void MouseBehaviour::onMouseClick(GLFWwindow* window, double mouseX, double mouseY)
+{
+	for (auto& entity : buttonsUnderCursor(mouseX, mouseY))
+	{
+		handleButtonClick(window, entity);
+	}
 }
 
 void MouseBehaviour::onMouseHover(double mouseX, double mouseY)
 {
-	auto allEntities = ecsCoordinator.getAllLiveEntities();
+	std::vector<Entity> currentButtons = buttonsUnderCursor(mouseX, mouseY);
 
-	for (auto& entity : allEntities)
+	//only buttons the cursor left need their scale restored
+	for (auto& entity : hoveredButtons)
 	{
-		if (ecsCoordinator.hasComponent<ButtonComponent>(entity))
+		bool stillHovered = std::find(currentButtons.begin(), currentButtons.end(), entity) != currentButtons.end();
+		if (!stillHovered && ecsCoordinator.hasComponent<ButtonComponent>(entity))
 		{
 			TransformComponent& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
 			ButtonComponent& button = ecsCoordinator.getComponent<ButtonComponent>(entity);
-
-			if (mouseIsOverButton(mouseX, mouseY, transform))
-			{
-				transform.scale.SetX(button.hoveredScale.GetX());
-				transform.scale.SetY(button.hoveredScale.GetY());
-			}
-
-			else
-			{
-				transform.scale.SetX(button.originalScale.GetX());
-				transform.scale.SetY(button.originalScale.GetY());
-			}
+			transform.scale.SetX(button.originalScale.GetX());
+			transform.scale.SetY(button.originalScale.GetY());
 		}
 	}
+
+	for (auto& entity : currentButtons)
+	{
+		TransformComponent& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+		ButtonComponent& button = ecsCoordinator.getComponent<ButtonComponent>(entity);
+		transform.scale.SetX(button.hoveredScale.GetX());
+		transform.scale.SetY(button.hoveredScale.GetY());
+	}
+
+	hoveredButtons.swap(currentButtons);
 }
 
 bool MouseBehaviour::mouseIsOverButton(double mouseX, double mouseY, TransformComponent& transform)
@@ -23,6 +23,16 @@ class BehaviourECS {
 public:
 	virtual ~BehaviourECS() = default;
 	virtual void update(Entity entity) = 0;
+
+	//Behaviours that react to things touching them return true here, the
+	//entity then gets a TriggerComponent and receives the events below
+	virtual bool usesTriggerEvents() const { return false; }
+
+	//Sent by the physics system when a moving body (other) starts touching,
+	//keeps touching or stops touching the trigger entity
+	virtual void onTriggerEnter(Entity entity, Entity other) { (void)entity; (void)other; }
+	virtual void onTriggerStay(Entity entity, Entity other) { (void)entity; (void)other; }
+	virtual void onTriggerExit(Entity entity, Entity other) { (void)entity; (void)other; }
 };
 
 class MouseBehaviour : public BehaviourECS {
@@ -34,6 +44,12 @@ public:
 private:
 	bool mouseIsOverButton(double mouseX, double mouseY, TransformComponent& transform);
 	void handleButtonClick(GLFWwindow* window, Entity entity);
+
+	//Buttons found under the cursor through the physics point query
+	std::vector<Entity> buttonsUnderCursor(double mouseX, double mouseY);
+
+	//Buttons currently shown at their hovered scale
+	std::vector<Entity> hoveredButtons;
 };
 
 class LogicSystemECS : public System
@@ -58,6 +74,9 @@ public:
 	void ApplyForce(Entity entity, const myMath::Vector2D& appliedForce);
 
 	void unassignBehaviour(Entity entity);
+
+	//Forward a trigger event to the behaviour of the trigger entity
+	void dispatchTriggerEvent(TriggerEvent event, Entity trigger, Entity other);
 	
 	bool hasBehaviour(Entity entity) { return behaviours.find(entity) != behaviours.end(); }
 
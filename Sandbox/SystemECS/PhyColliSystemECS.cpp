@@ -23,14 +23,40 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "GraphicsComponent.h"
 #include "PhysicsComponent.h"
 #include "PlayerComponent.h"
+#include "EnemyComponent.h"
+#include "TriggerComponent.h"
+#include "ColliderComponent.h"
+#include "TilemapComponent.h"
+#include "Tilemap.h"
+#include "ForceFieldComponent.h"
+#include "UIComponent.h"
+#include "LogicSystemECS.h"
 
 #include "GlobalCoordinator.h"
 #include "GraphicsSystem.h"
 #include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <chrono>
 #include "AudioSystem.h"
 
 #define M_PI   3.14159265358979323846264338327950288f
 
+float PhysicsSystemECS::fixedDeltaTime = 1.f / 120.f;
+int PhysicsSystemECS::maxSubsteps = 8;
+bool PhysicsSystemECS::deterministic = false;
+float PhysicsSystemECS::ccdMotionThreshold = 0.5f;
+float PhysicsSystemECS::sleepVelocityThreshold = 1.f;
+int PhysicsSystemECS::sleepStepCount = 60;
+int PhysicsSystemECS::solverIterations = 8;
+float PhysicsSystemECS::baumgarte = 0.8f;
+float PhysicsSystemECS::penetrationSlop = 0.05f;
+float PhysicsSystemECS::contactFriction = 0.f;
+float PhysicsSystemECS::steeringResponse = 4.f;
+float PhysicsSystemECS::broadphaseCellSize = 200.f;
+int PhysicsSystemECS::workerThreads = 0;
 float PhysicsSystemECS::friction;
 float PhysicsSystemECS::threshold;
 bool PhysicsSystemECS::alrJumped;
@@ -43,6 +69,24 @@ bool PhysicsSystemECS::isSliding;
 PhysicsSystemECS::PhysicsSystemECS() : eventSource("PlayerEventSource"), eventObserver(std::make_shared<PlayerActionListener>())
 {
     isColliding = false;
+    stepStats = {};
+    broadphaseFrame = ~0ull;
+    broadphaseStep = 0;
+    broadphaseDirty = true;
+    movedSteps = 0;
+    triggerStep = ~0ull;
+    triggerListsVersion = 0;
+    bodyListsDirty = true;
+    bodyListsVersion = 0;
+    staticCollisionDirty = true;
+    staticEntityCount = 0;
+    awakeBodyCount = 0;
+    islandListsVersion = ~0ull;
+    islandsDirty = true;
+    islandsIdle = false;
+    accumulator = 0.f;
+    interpolationAlpha = 1.f;
+    interpolationSettled = false;
     eventSource.Register(MessageId::FALL, eventObserver);
     eventSource.Register(MessageId::JUMP, eventObserver);
 }
@@ -55,45 +99,115 @@ void PhysicsSystemECS::initialise()
 void PhysicsSystemECS::cleanup() {
     eventSource.Unregister(MessageId::FALL, eventObserver);
     eventSource.Unregister(MessageId::JUMP, eventObserver);
+    ResetSimulation();
+}
+
+void PhysicsSystemECS::ResetSimulation()
+{
+    interpolationStates.clear();
+    contactCache.clear();
+    bodyContactCache.clear();
+    solverBodies.clear();
+    solverIslands.clear();
+    islandContacts.clear();
+    islandGrid.clear();
+    triggerOverlaps.clear();
+    triggerOrder.clear();
+    triggerSnapshots.clear();
+    fieldSnapshots.clear();
+    triggerStep = ~0ull;
+    bodyListsDirty = true;
+    broadphase.clear();
+    screenBroadphase.clear();
+    broadphaseFrame = ~0ull;
+    broadphaseDirty = true;
+    staticWorld.clear();
+    staticCollisionDirty = true;
+    islands.clear();
+    islandOfBody.clear();
+    sleepSnapshots.clear();
+    awakeBodyCount = 0;
+    islandListsVersion = ~0ull;
+    islandsDirty = true;
+    islandsIdle = false;
+    accumulator = 0.f;
+    interpolationAlpha = 1.f;
+    interpolationSettled = false;
+
+    // Contact flags of the old scene would fire or swallow the first
+    // collision sound and jump gate of the new one
+    isColliding = false;
+    GLFWFunctions::firstCollision = false;
 }
 
 // Find the closest platform to the player
 Entity PhysicsSystemECS::FindClosestPlatform(Entity player)
 {
-    float closestDistance = 100000.f;  // Initialize to a large number
-
     myMath::Vector2D playerPos = ecsCoordinator.getComponent<TransformComponent>(player).position;
-    int count = 0;
-    int isClosest = 0;
-    Entity closestPlatform = player;
-    for (auto& platform : entities)
-    {
-        if (platform == player)
-        {
-            continue;
-        }
-        bool hasClosestPlatform = ecsCoordinator.hasComponent<ClosestPlatform>(platform);
 
-        if (hasClosestPlatform)
+    std::vector<Entity> nearest;
+    KNearest(playerPos, 1, nearest, [player](Entity entity)
         {
-            count++;
-            myMath::Vector2D platformPos = ecsCoordinator.getComponent<TransformComponent>(platform).position;           
-            float distance = std::sqrt(
-                std::pow(playerPos.GetX() - platformPos.GetX(), 2.f) +
-                std::pow(playerPos.GetY() - platformPos.GetY(), 2.f)
-            ); 
+            return entity != player && ecsCoordinator.hasComponent<ClosestPlatform>(entity);
+        });
 
-            if (distance < closestDistance)
-            {
-                closestDistance = distance;
-                ecsCoordinator.getComponent<ClosestPlatform>(platform).isClosest = true;
-                isClosest = count;
-                closestPlatform = platform;
-            }
+    if (nearest.empty())
+    {
+        return player;
+    }
+
+    ecsCoordinator.getComponent<ClosestPlatform>(nearest.front()).isClosest = true;
+    return nearest.front();
+}
+
+// Continuous collision for the player. Only runs when the step moved the
+// player further than a fraction of its radius, since slower motion cannot
+// skip over a platform between two discrete checks.
+void PhysicsSystemECS::sweepBody(SolverBody& body, WorkerScratch& scratch)
+{
+    TransformComponent& transform = *body.transform;
+    const myMath::Vector2D& startPos = body.startPosition;
+    float radius = body.radius;
+    myMath::Vector2D motion = transform.position - startPos;
+
+    if (myMath::LengthVector2D(motion) <= radius * ccdMotionThreshold)
+    {
+        return;
+    }
+
+    float earliestToi = 1.f;
+    myMath::Vector2D hitNormal{};
+    bool hasHit = false;
+
+    myMath::Vector2D sweepMin(std::min(startPos.GetX(), transform.position.GetX()) - radius, std::min(startPos.GetY(), transform.position.GetY()) - radius);
+    myMath::Vector2D sweepMax(std::max(startPos.GetX(), transform.position.GetX()) + radius, std::max(startPos.GetY(), transform.position.GetY()) + radius);
+
+    std::vector<Entity> shapes;
+    staticWorld.queryRegion({ sweepMin, sweepMax }, shapes);
+    scratch.broadphasePairs += shapes.size();
+    scratch.narrowphaseTests += shapes.size();
+
+    for (auto& shapeIndex : shapes)
+    {
+        const StaticCollisionWorld::Shape& shape = staticWorld.getShape(shapeIndex);
+        CollisionSystemECS::OBB platformOBB = collisionSystem.createOBB(shape.center, shape.halfExtents, shape.rotation);
+        float toi{};
+        myMath::Vector2D normal{};
+
+        if (collisionSystem.sweepCircleOBB(startPos, transform.position, radius, platformOBB, toi, normal) && toi < earliestToi)
+        {
+            earliestToi = toi;
+            hitNormal = normal;
+            hasHit = true;
         }
     }
 
-    return closestPlatform;
+    if (hasHit)
+    {
+        // Rest on the surface and drop the velocity into it, same as a discrete contact
+        transform.position = startPos + motion * earliestToi;
+        collisionSystem.CollisionResponse(transform, *body.physics, hitNormal, 0.f);
+    }
 }
 
 // Clamp the player's velocity
@@ -131,15 +245,22 @@ myMath::Vector2D PhysicsSystemECS::directionalVector(float angle)
 // Add applied force to accumulatedForce
 void ForceManager::AddForce(Entity player, const myMath::Vector2D& appliedForce)
 {
-    myMath::Vector2D& accForce = ecsCoordinator.getComponent<PhysicsComponent>(player).accumulatedForce;
+    auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(player);
+    if (physics.isSleeping)
+    {
+        ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->WakeBody(player);
+    }
 
-    accForce.SetX(accForce.GetX() + appliedForce.GetX());
-    accForce.SetY(accForce.GetY() + appliedForce.GetY());
+    AddForce(physics, appliedForce);
+}
 
+void ForceManager::AddForce(PhysicsComponent& physics, const myMath::Vector2D& appliedForce)
+{
+    physics.accumulatedForce += appliedForce;
 }
 
 // Calculate the resultant force
-float ForceManager::ResultantForce(myMath::Vector2D direction, myMath::Vector2D normal, float maxAccForce)
+float ForceManager::ResultantForce(const myMath::Vector2D& direction, const myMath::Vector2D& normal, float maxAccForce)
 {
     float dotProduct = myMath::DotProductVector2D(direction, -normal);
     float angle = std::acos(dotProduct); // Angle in radians
@@ -151,127 +272,363 @@ float ForceManager::ResultantForce(myMath::Vector2D direction, myMath::Vector2D
 
 // Clear the force (Reset to 0
 void ForceManager::ClearForce(Entity player) {
-    myMath::Vector2D& accForce = ecsCoordinator.getComponent<PhysicsComponent>(player).accumulatedForce;
-    accForce.SetX(0.f);
-    accForce.SetY(0.f);
+    ClearForce(ecsCoordinator.getComponent<PhysicsComponent>(player));
+}
+
+void ForceManager::ClearForce(PhysicsComponent& physics) {
+    physics.accumulatedForce = myMath::Vector2D(0.f, 0.f);
 }
 
 // Apply force to the player
-void ForceManager::ApplyForce(Entity player, myMath::Vector2D direction, float targetForce)
+void ForceManager::ApplyForce(Entity player, myMath::Vector2D direction, float targetForce, float dt)
 {
-    myMath::Vector2D& playerPos = ecsCoordinator.getComponent<TransformComponent>(player).position;
-
-    myMath::Vector2D& vel = ecsCoordinator.getComponent<PhysicsComponent>(player).velocity;
-    myMath::Vector2D& acceleration = ecsCoordinator.getComponent<PhysicsComponent>(player).acceleration;
-    myMath::Vector2D& accForce = ecsCoordinator.getComponent<PhysicsComponent>(player).accumulatedForce;
+    ApplyForce(ecsCoordinator.getComponent<PhysicsComponent>(player), ecsCoordinator.getComponent<TransformComponent>(player), direction, targetForce, dt);
+}
 
-    float mass = ecsCoordinator.getComponent<PhysicsComponent>(player).mass;
-    float dampen = ecsCoordinator.getComponent<PhysicsComponent>(player).dampening;
-    float maxVelocity = ecsCoordinator.getComponent<PhysicsComponent>(player).maxVelocity;
-    float& prevForce = ecsCoordinator.getComponent<PhysicsComponent>(player).prevForce;
+void ForceManager::ApplyForce(PhysicsComponent& physics, TransformComponent& transform, const myMath::Vector2D& direction, float targetForce, float dt)
+{
+    myMath::Vector2D& vel = physics.velocity;
 
-    if (prevForce != targetForce) {
-        accForce.SetX(targetForce);
-        accForce.SetY(targetForce);
+    if (physics.prevForce != targetForce) {
+        physics.accumulatedForce = myMath::Vector2D(targetForce, targetForce);
     }
 
-    float invMass = mass > 0.f ? 1.f / mass : 0.f;
-    acceleration = accForce * invMass;
-
-    vel.SetX(vel.GetX() + direction.GetX() * acceleration.GetX());
-    vel.SetY(vel.GetY() + direction.GetY() * acceleration.GetY());
+    float invMass = physics.mass > 0.f ? 1.f / physics.mass : 0.f;
+    physics.acceleration = physics.accumulatedForce * invMass;
 
-    Console::GetLog() << "force:" << acceleration.GetX() << " " << acceleration.GetY() << std::endl;
+    vel.SetX(vel.GetX() + direction.GetX() * physics.acceleration.GetX());
+    vel.SetY(vel.GetY() + direction.GetY() * physics.acceleration.GetY());
 
     //Dampening
-    vel.SetX(vel.GetX() * dampen);
-    vel.SetY(vel.GetY() * dampen);
+    vel *= physics.dampening;
 
     float speed = myMath::LengthVector2D(vel);
-    if (speed > maxVelocity) {
+    if (speed > physics.maxVelocity) {
         myMath::NormalizeVector2D(vel, vel);
-        vel = vel * maxVelocity;
+        vel = vel * physics.maxVelocity;
     }
 
-    ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->clampVelocity(player, maxVelocity);
-
-    Console::GetLog() << "vel: " << vel.GetX() << " " << vel.GetY() << std::endl;
-
-    playerPos.SetX(playerPos.GetX() + (vel.GetX() * GLFWFunctions::delta_time));
-    playerPos.SetY(playerPos.GetY() + (vel.GetY() * GLFWFunctions::delta_time));
+    transform.position += vel * dt;
 }
 
-// Handle OBB collision
-void PhysicsSystemECS::HandleCircleOBBCollision(Entity player, Entity platform)
+// Gravity, the push from the closest platform and the player's own force,
+// integrated into the body's velocity and position. Only the body's own
+// components are touched, the gameplay flags are raised after all bodies
+// are done.
+void PhysicsSystemECS::integrateBody(SolverBody& body, float dt, WorkerScratch& scratch)
 {
-    myMath::Vector2D& playerPos = ecsCoordinator.getComponent<TransformComponent>(player).position;
-    //myMath::Vector2D& accForce          = ecsCoordinator.getComponent<PhysicsComponent>(player).accumulatedForce;
-    float radius = ecsCoordinator.getComponent<TransformComponent>(player).scale.GetX() * 0.5f;
-    float rotation = ecsCoordinator.getComponent<TransformComponent>(player).orientation.GetX();
-    myMath::Vector2D direction = directionalVector(rotation);
-    myMath::Vector2D gravity = ecsCoordinator.getComponent<PhysicsComponent>(player).gravityScale;
-    float mass = ecsCoordinator.getComponent<PhysicsComponent>(player).mass;
-    float maxAccForce = ecsCoordinator.getComponent<PhysicsComponent>(player).maxAccumulatedForce;
-    float& targetForce = ecsCoordinator.getComponent<PhysicsComponent>(player).targetForce;
-    float& prevForce = ecsCoordinator.getComponent<PhysicsComponent>(player).prevForce;
-    Force force = ecsCoordinator.getComponent<PhysicsComponent>(player).force;
-    ForceManager forceManager = ecsCoordinator.getComponent<PhysicsComponent>(player).forceManager;
-    CollisionSystemECS::OBB playerOBB = collisionSystem.createOBBFromEntity(player);
-    CollisionSystemECS::OBB platformOBB = collisionSystem.createOBBFromEntity(platform);
+    if (body.steered)
+    {
+        integrateSteeredBody(body, dt);
+        return;
+    }
+
+    PhysicsComponent& physics = *body.physics;
+    TransformComponent& transform = *body.transform;
+    myMath::Vector2D direction = directionalVector(transform.orientation.GetX());
 
     myMath::Vector2D normal{};
     float penetration{};
 
-    force.SetDirection(direction);
+    body.touchingPlatform = false;
+    if (body.hasSurface)
+    {
+        body.touchingPlatform = collisionSystem.checkCircleOBBCollision(transform.position, body.radius, body.platformOBB, normal, penetration);
+        scratch.narrowphaseTests++;
+    }
+
+    ForceManager::AddForce(physics, physics.gravityScale * physics.mass * dt);
+
+    if (body.touchingPlatform)
+    {
+        if (-normal.GetX() == direction.GetX() && -normal.GetY() == direction.GetY())
+        {
+            ForceManager::ClearForce(physics);
+        }
+
+        physics.targetForce = ForceManager::ResultantForce(direction, normal, physics.maxAccumulatedForce);
+    }
+
+    ForceManager::ApplyForce(physics, transform, direction, physics.targetForce, dt);
+
+    physics.prevForce = physics.targetForce;
+}
+
+// Steered bodies take no gravity and no push from the platforms, their
+// behaviour's steering force already aims the velocity where it should be.
+// The force is used up by the step that integrates it
+void PhysicsSystemECS::integrateSteeredBody(SolverBody& body, float dt)
+{
+    PhysicsComponent& physics = *body.physics;
+    TransformComponent& transform = *body.transform;
+
+    // Steering goes through the same force sum as fields and AddForce, but
+    // from this step's velocity so it is applied at the fixed rate
+    physics.accumulatedForce += (physics.desiredVelocity - physics.velocity) * (physics.mass * steeringResponse);
+
+    float invMass = physics.mass > 0.f ? 1.f / physics.mass : 0.f;
+    physics.acceleration = physics.accumulatedForce * invMass;
+    physics.velocity += physics.acceleration * dt;
 
-    isColliding = collisionSystem.checkCircleOBBCollision(playerPos, radius, platformOBB, normal, penetration);
+    float speed = myMath::LengthVector2D(physics.velocity);
+    if (physics.maxVelocity > 0.f && speed > physics.maxVelocity)
+    {
+        physics.velocity = physics.velocity * (physics.maxVelocity / speed);
+    }
+
+    transform.position += physics.velocity * dt;
+
+    ForceManager::ClearForce(physics);
+}
+
+// Fields are few and cheap to place, so the grid is filled again every step
+// a body moves and moving or toggled fields need no bookkeeping. While every
+// body sleeps only the snapshots are compared
+void PhysicsSystemECS::gatherForceFields()
+{
+    fieldStates.clear();
+    fieldGrid.clear();
+    fieldSnapshots.clear();
+
+    std::vector<Entity> sleepers;
+    for (auto& entity : forceFieldEntities)
+    {
+        fieldSnapshots.push_back(takeVolumeSnapshot(entity));
+
+        auto& field = ecsCoordinator.getComponent<ForceFieldComponent>(entity);
+        if (!field.enabled || field.strength == 0.f)
+        {
+            continue;
+        }
+
+        auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+
+        FieldState state{};
+        state.type = field.type;
+        state.falloff = field.falloff;
+        state.strength = field.strength;
+        state.radius = field.radius;
+        state.center = transform.position;
+        state.affects = field.affects;
+
+        SpatialGrid::Bounds bounds{};
+        if (field.type == ForceFieldType::DIRECTIONAL)
+        {
+            state.obb = collisionSystem.createOBBFromEntity(entity);
+            state.direction = state.obb.axes[0] * field.direction.GetX() + state.obb.axes[1] * field.direction.GetY();
+            state.reach = std::fabs(myMath::DotProductVector2D(state.direction, state.obb.axes[0])) * state.obb.halfExtents.GetX() +
+                          std::fabs(myMath::DotProductVector2D(state.direction, state.obb.axes[1])) * state.obb.halfExtents.GetY();
+            bounds = getEntityBounds(entity);
+        }
+        else
+        {
+            myMath::Vector2D extent(field.radius, field.radius);
+            bounds = { transform.position - extent, transform.position + extent };
+        }
+
+        fieldGrid.update(static_cast<Entity>(fieldStates.size()), bounds);
+        fieldStates.push_back(state);
+
+        uint8_t affects = field.affects;
+        QueryRegion(bounds.min, bounds.max, sleepers, [this, affects](Entity body)
+            {
+                return isDynamicBody(body) && (getFieldKind(body) & affects) && IsSleeping(body);
+            });
+    }
+
+    for (auto& body : sleepers)
+    {
+        WakeBody(body);
+    }
+}
+
+uint8_t PhysicsSystemECS::getFieldKind(Entity body)
+{
+    if (ecsCoordinator.hasComponent<PlayerComponent>(body))
+    {
+        return FIELD_AFFECTS_PLAYER;
+    }
+    return ecsCoordinator.hasComponent<EnemyComponent>(body) ? FIELD_AFFECTS_ENEMY : FIELD_AFFECTS_OTHER;
+}
 
-    forceManager.AddForce(player, gravity * mass * GLFWFunctions::delta_time);
+bool PhysicsSystemECS::fieldsChanged() const
+{
+    if (fieldSnapshots.size() != forceFieldEntities.size())
+    {
+        return true;
+    }
 
-    if (isColliding)
+    for (size_t i = 0; i < fieldSnapshots.size(); i++)
     {
-        alrJumped = true;
-        if (-normal.GetX() == force.GetDirection().GetX() && -normal.GetY() == force.GetDirection().GetY())
+        if (fieldSnapshots[i].entity != forceFieldEntities[i] || volumeChanged(fieldSnapshots[i]))
         {
-            forceManager.ClearForce(player);
+            return true;
         }
+    }
+    return false;
+}
+
+PhysicsSystemECS::VolumeSnapshot PhysicsSystemECS::takeVolumeSnapshot(Entity entity)
+{
+    auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+
+    VolumeSnapshot snapshot{};
+    snapshot.entity = entity;
+    snapshot.position = transform.position;
+    snapshot.orientation = transform.orientation;
+    snapshot.scale = transform.scale;
+    if (ecsCoordinator.hasComponent<ForceFieldComponent>(entity))
+    {
+        snapshot.field = ecsCoordinator.getComponent<ForceFieldComponent>(entity);
+    }
+    return snapshot;
+}
+
+bool PhysicsSystemECS::volumeChanged(const VolumeSnapshot& snapshot)
+{
+    auto& transform = ecsCoordinator.getComponent<TransformComponent>(snapshot.entity);
+    if (snapshot.position.GetX() != transform.position.GetX() || snapshot.position.GetY() != transform.position.GetY() ||
+        snapshot.orientation.GetX() != transform.orientation.GetX() ||
+        snapshot.scale.GetX() != transform.scale.GetX() || snapshot.scale.GetY() != transform.scale.GetY())
+    {
+        return true;
+    }
+
+    if (!ecsCoordinator.hasComponent<ForceFieldComponent>(snapshot.entity))
+    {
+        return false;
+    }
+
+    auto& field = ecsCoordinator.getComponent<ForceFieldComponent>(snapshot.entity);
+    return field.enabled != snapshot.field.enabled || field.type != snapshot.field.type ||
+           field.falloff != snapshot.field.falloff || field.strength != snapshot.field.strength ||
+           field.radius != snapshot.field.radius || field.affects != snapshot.field.affects ||
+           field.direction.GetX() != snapshot.field.direction.GetX() || field.direction.GetY() != snapshot.field.direction.GetY();
+}
+
+void PhysicsSystemECS::applyForceFields(SolverBody& body, float dt, WorkerScratch& scratch)
+{
+    if (fieldStates.empty())
+    {
+        return;
+    }
+
+    const myMath::Vector2D& position = body.transform->position;
+    myMath::Vector2D extent(body.radius, body.radius);
+
+    scratch.fields.clear();
+    fieldGrid.queryRegion({ position - extent, position + extent }, scratch.fields);
 
-        targetForce = forceManager.ResultantForce(force.GetDirection(), normal, maxAccForce);
+    // Summed in field order, not cell order, so the result never depends on the grid
+    std::sort(scratch.fields.begin(), scratch.fields.end());
+
+    myMath::Vector2D acceleration(0.f, 0.f);
+    for (auto& field : scratch.fields)
+    {
+        if (fieldStates[field].affects & body.fieldKind)
+        {
+            acceleration += sampleForceField(fieldStates[field], position, body.radius);
+        }
     }
 
-    forceManager.ApplyForce(player, force.GetDirection(), targetForce);
+    body.physics->velocity += acceleration * dt;
+}
 
-    prevForce = targetForce;
+// A body is inside a field when its collider reaches into the field's area.
+// Falloff runs from the field's source: the back of a directional field's
+// box, or the center of a radial or vortex field
+myMath::Vector2D PhysicsSystemECS::sampleForceField(const FieldState& field, const myMath::Vector2D& point, float bodyRadius)
+{
+    myMath::Vector2D offset = point - field.center;
+    myMath::Vector2D push(0.f, 0.f);
+    float distance = 0.f;
 
-    if (isColliding)
+    if (field.type == ForceFieldType::DIRECTIONAL)
     {
-        if (GLFWFunctions::firstCollision == false)
+        if (std::fabs(myMath::DotProductVector2D(offset, field.obb.axes[0])) > field.obb.halfExtents.GetX() + bodyRadius ||
+            std::fabs(myMath::DotProductVector2D(offset, field.obb.axes[1])) > field.obb.halfExtents.GetY() + bodyRadius)
         {
-            GLFWFunctions::bumpAudio = true;
-            GLFWFunctions::firstCollision = true;
-            std::cout << "First time collide with platform" << std::endl;
+            return push;
         }
-        collisionSystem.CollisionResponse(player, normal, penetration);
+
+        push = field.direction;
+        distance = field.reach > 0.f ? (myMath::DotProductVector2D(offset, field.direction) + field.reach) / (2.f * field.reach) : 0.f;
     }
     else
     {
-        GLFWFunctions::firstCollision = false;
+        float length = myMath::LengthVector2D(offset);
+        if (length > field.radius + bodyRadius || length <= 0.f || field.radius <= 0.f)
+        {
+            return push;
+        }
+
+        myMath::Vector2D outward = offset / length;
+        push = field.type == ForceFieldType::RADIAL ? outward : myMath::Vector2D(-outward.GetY(), outward.GetX());
+        distance = length / field.radius;
+    }
+
+    distance = std::max(0.f, std::min(distance, 1.f));
+
+    float scale = 1.f;
+    if (field.falloff == ForceFieldFalloff::LINEAR)
+    {
+        scale = 1.f - distance;
+    }
+    else if (field.falloff == ForceFieldFalloff::QUADRATIC)
+    {
+        scale = (1.f - distance) * (1.f - distance);
     }
 
+    return push * (field.strength * scale);
 }
 
+// Platform contact flags read by the player behaviour and the bump sound.
+// Bodies are visited in the same order as before the step went wide, so the
+// last player decides isColliding
+void PhysicsSystemECS::updateContactFlags()
+{
+    for (auto& body : solverBodies)
+    {
+        if (body.steered)
+        {
+            continue;
+        }
+
+        isColliding = body.touchingPlatform;
+
+        if (isColliding)
+        {
+            alrJumped = true;
+            if (GLFWFunctions::firstCollision == false)
+            {
+                GLFWFunctions::bumpAudio = true;
+                GLFWFunctions::firstCollision = true;
+            }
+        }
+        else
+        {
+            GLFWFunctions::firstCollision = false;
+        }
+    }
+}
 
 // COLLISION SYSTEM
 // OBB collision detection
 // SAT for OBB vs Circle
 CollisionSystemECS::OBB CollisionSystemECS::createOBBFromEntity(Entity entity)
 {
-    OBB obb{};
     auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
 
-    obb.center = transform.position;
-    obb.halfExtents = transform.scale * 0.5f;
-    obb.rotation = transform.orientation.GetX() * (M_PI / 180.0f);
+    return createOBB(transform.position, transform.scale * 0.5f, transform.orientation.GetX() * (M_PI / 180.0f));
+}
+
+CollisionSystemECS::OBB CollisionSystemECS::createOBB(const myMath::Vector2D& center, const myMath::Vector2D& halfExtents, float rotation)
+{
+    OBB obb{};
+
+    obb.center = center;
+    obb.halfExtents = halfExtents;
+    obb.rotation = rotation;
 
     // Calculate local axes
     obb.axes[0] = myMath::Vector2D(cos(obb.rotation), sin(obb.rotation));
@@ -379,122 +736,2237 @@ bool CollisionSystemECS::checkOBBCollisionSAT(const OBB& obb1, const OBB& obb2,
     return true;
 }
 
-// Collision response for OBB
-void CollisionSystemECS::CollisionResponse(Entity player, myMath::Vector2D normal, float penetration)
+// Swept circle vs OBB
+// Works in the OBB's local space, where the circle sweeping past the box is the
+// same as its center ray-casting against the box grown by the radius. The slab
+// test gives the entry face; if the entry point lies past a face's extent the
+// ray is in a rounded corner region and is tested against that corner's circle.
+bool CollisionSystemECS::sweepCircleOBB(const myMath::Vector2D& start, const myMath::Vector2D& end, float radius, const OBB& obb, float& toi, myMath::Vector2D& normal)
 {
-    myMath::Vector2D& playerPos = ecsCoordinator.getComponent<TransformComponent>(player).position;
-    myMath::Vector2D& vel = ecsCoordinator.getComponent<PhysicsComponent>(player).velocity;
-
-    myMath::Vector2D tangent(-normal.GetY(), normal.GetX()); // Tangent vector along platform
-    float tangentVelocity = myMath::DotProductVector2D(vel, tangent); // Velocity along tangent
-    vel = tangent * tangentVelocity;
+    myMath::Vector2D relStart = start - obb.center;
+    myMath::Vector2D motion = end - start;
 
-    playerPos.SetX(playerPos.GetX() + normal.GetX() * penetration);
-    playerPos.SetY(playerPos.GetY() + normal.GetY() * penetration);
-}
+    float p[2] = { myMath::DotProductVector2D(relStart, obb.axes[0]), myMath::DotProductVector2D(relStart, obb.axes[1]) };
+    float v[2] = { myMath::DotProductVector2D(motion, obb.axes[0]), myMath::DotProductVector2D(motion, obb.axes[1]) };
+    float half[2] = { obb.halfExtents.GetX(), obb.halfExtents.GetY() };
 
-int count = 0;
-Entity playerEntity = {};
-Entity closestPlatformEntity = {};
+    float tEnter = 0.f;
+    float tExit = 1.f;
+    int enterAxis = -1;
+    float enterSign = 0.f;
 
-// Update function for Physics System
-void PhysicsSystemECS::update(float dt)
-{
-    (void)dt;
-    count = 0;
-    for (auto& entity : entities)
+    for (int i = 0; i < 2; i++)
     {
-        if (ecsCoordinator.hasComponent<PlayerComponent>(entity)) {
-            playerEntity = entity;
-            count++;
+        float extent = half[i] + radius;
+
+        if (std::fabs(v[i]) < 1e-6f)
+        {
+            if (std::fabs(p[i]) > extent)
+            {
+                return false;
+            }
+            continue;
         }
 
-        if (ecsCoordinator.hasComponent<ClosestPlatform>(entity))
+        float t1 = (-extent - p[i]) / v[i];
+        float t2 = (extent - p[i]) / v[i];
+        float sign = v[i] > 0.f ? -1.f : 1.f;
+        if (t1 > t2)
         {
-            count++;
+            std::swap(t1, t2);
+        }
+
+        if (t1 > tEnter)
+        {
+            tEnter = t1;
+            enterAxis = i;
+            enterSign = sign;
+        }
+        tExit = std::min(tExit, t2);
+
+        if (tEnter > tExit)
+        {
+            return false;
         }
     }
 
-    if (count > 1)
+    // Already overlapping at the start, the discrete test handles that case
+    if (enterAxis == -1)
     {
-        closestPlatformEntity = FindClosestPlatform(playerEntity);
-        HandleCircleOBBCollision(playerEntity, closestPlatformEntity);
+        return false;
     }
 
-    std::vector<Entity> collidingPlatforms;
-    // Count entities and find the player entity
-    Entity playEntity = NULL;
-    for (auto& entity : entities)
+    int otherAxis = 1 - enterAxis;
+    float hit[2] = { p[0] + v[0] * tEnter, p[1] + v[1] * tEnter };
+
+    if (std::fabs(hit[otherAxis]) <= half[otherAxis])
     {
-        if (ecsCoordinator.hasComponent<PlayerComponent>(entity))
-        {
-            playEntity = entity;
-        }
+        float localNormal[2] = { 0.f, 0.f };
+        localNormal[enterAxis] = enterSign;
+
+        toi = tEnter;
+        normal = obb.axes[0] * localNormal[0] + obb.axes[1] * localNormal[1];
+        return true;
     }
 
-    // Early exit if no player is found
-    if (playEntity == NULL) return;
+    // Corner region: solve |p + v*t - corner| = radius for the first root
+    float corner[2] = { hit[0] < 0.f ? -half[0] : half[0], hit[1] < 0.f ? -half[1] : half[1] };
+    float m[2] = { p[0] - corner[0], p[1] - corner[1] };
 
-    // Get the player position and radius
-    auto& playerTransform = ecsCoordinator.getComponent<TransformComponent>(playEntity);
-    myMath::Vector2D playerPos = playerTransform.position;
-    float playerRadius = playerTransform.scale.GetX() * 0.5f;
+    float a = v[0] * v[0] + v[1] * v[1];
+    float b = m[0] * v[0] + m[1] * v[1];
+    float c = m[0] * m[0] + m[1] * m[1] - radius * radius;
+    float discriminant = b * b - a * c;
 
-    // Detect all colliding platforms
-    for (auto& entity : entities)
+    if (discriminant < 0.f)
     {
-        if (ecsCoordinator.hasComponent<ClosestPlatform>(entity))
-        {
+        return false;
+    }
 
-            // Check for collision between player and platform
-            CollisionSystemECS::OBB platformOBB = collisionSystem.createOBBFromEntity(entity);
-            myMath::Vector2D normal{};
-            float penetration{};
-            bool isCollide = collisionSystem.checkCircleOBBCollision(playerPos, playerRadius, platformOBB, normal, penetration);
+    float t = (-b - std::sqrt(discriminant)) / a;
+    if (t < 0.f || t > 1.f)
+    {
+        return false;
+    }
+
+    float contact[2] = { m[0] + v[0] * t, m[1] + v[1] * t };
+    myMath::Vector2D localNormal(contact[0] / radius, contact[1] / radius);
+
+    toi = t;
+    normal = obb.axes[0] * localNormal.GetX() + obb.axes[1] * localNormal.GetY();
+    return true;
+}
+
+// Ray vs OBB using the slab test in the OBB's local space
+bool CollisionSystemECS::raycastOBB(const myMath::Vector2D& origin, const myMath::Vector2D& direction, float maxDistance, const OBB& obb, float& distance, myMath::Vector2D& normal)
+{
+    myMath::Vector2D relOrigin = origin - obb.center;
+    float p[2] = { myMath::DotProductVector2D(relOrigin, obb.axes[0]), myMath::DotProductVector2D(relOrigin, obb.axes[1]) };
+    float d[2] = { myMath::DotProductVector2D(direction, obb.axes[0]), myMath::DotProductVector2D(direction, obb.axes[1]) };
+    float half[2] = { obb.halfExtents.GetX(), obb.halfExtents.GetY() };
+
+    float tEnter = 0.f;
+    float tExit = maxDistance;
+    int enterAxis = -1;
+    float enterSign = 0.f;
 
-            if (isCollide)
+    for (int i = 0; i < 2; i++)
+    {
+        if (std::fabs(d[i]) < 1e-6f)
+        {
+            if (std::fabs(p[i]) > half[i])
             {
-                collidingPlatforms.push_back(entity);
+                return false;
             }
+            continue;
         }
-    }
 
-    // Resolve collisions
-    if (collidingPlatforms.size() > 1)
-    {
-        for (auto& platformEntity : collidingPlatforms)
+        float t1 = (-half[i] - p[i]) / d[i];
+        float t2 = (half[i] - p[i]) / d[i];
+        float sign = d[i] > 0.f ? -1.f : 1.f;
+        if (t1 > t2)
+        {
+            std::swap(t1, t2);
+        }
+
+        if (t1 > tEnter)
         {
-            HandleCircleOBBCollision(playerEntity, platformEntity);
+            tEnter = t1;
+            enterAxis = i;
+            enterSign = sign;
+        }
+        tExit = std::min(tExit, t2);
+
+        if (tEnter > tExit)
+        {
+            return false;
         }
     }
 
+    distance = tEnter;
 
+    // Starting inside the box counts as a hit straight away
+    if (enterAxis == -1)
+    {
+        normal = -direction;
+        return true;
+    }
 
+    normal = enterAxis == 0 ? obb.axes[0] * enterSign : obb.axes[1] * enterSign;
+    return true;
 }
 
-// Load physics config from JSON
-void PhysicsSystemECS::LoadPhysicsConfigFromJSON(std::string const& filename)
+// Point inside OBB test
+bool CollisionSystemECS::containsPoint(const OBB& obb, const myMath::Vector2D& point)
 {
-    JSONSerializer serializer;
+    myMath::Vector2D local = point - obb.center;
+    return std::fabs(myMath::DotProductVector2D(local, obb.axes[0])) <= obb.halfExtents.GetX() &&
+           std::fabs(myMath::DotProductVector2D(local, obb.axes[1])) <= obb.halfExtents.GetY();
+}
 
-    // checks if the JSON file can be opened
-    if (!serializer.Open(filename))
+// SHAPES
+// Every collider is placed in world space as a Shape, and any two shapes are
+// tested through the dispatch table below. Circles and capsules against each
+// other are solved exactly from closest points; anything involving an OBB or a
+// polygon falls back to SAT over the candidate axes of the pair.
+namespace
+{
+    // Closest point to p on the segment a-b
+    myMath::Vector2D closestPointOnSegment(const myMath::Vector2D& p, const myMath::Vector2D& a, const myMath::Vector2D& b)
     {
-        Console::GetLog() << "Error: could not open file " << filename << std::endl;
-        return;
+        myMath::Vector2D ab = b - a;
+        float lengthSqr = myMath::DotProductVector2D(ab, ab);
+        if (lengthSqr <= 1e-12f)
+        {
+            return a;
+        }
+
+        float t = std::max(0.f, std::min(1.f, myMath::DotProductVector2D(p - a, ab) / lengthSqr));
+        return a + ab * t;
     }
 
-    // retrieve the JSON object from the JSON file
-    nlohmann::json currentObj = serializer.GetJSONObject();
+    // Closest points between the segments p1-q1 and p2-q2
+    void closestPointsBetweenSegments(const myMath::Vector2D& p1, const myMath::Vector2D& q1,
+                                      const myMath::Vector2D& p2, const myMath::Vector2D& q2,
+                                      myMath::Vector2D& c1, myMath::Vector2D& c2)
+    {
+        myMath::Vector2D d1 = q1 - p1;
+        myMath::Vector2D d2 = q2 - p2;
+        myMath::Vector2D r = p1 - p2;
+        float a = myMath::DotProductVector2D(d1, d1);
+        float e = myMath::DotProductVector2D(d2, d2);
+        float f = myMath::DotProductVector2D(d2, r);
+        float s = 0.f;
+        float t = 0.f;
+
+        if (a <= 1e-12f && e <= 1e-12f)
+        {
+            c1 = p1;
+            c2 = p2;
+            return;
+        }
 
-    // read all of the data from the JSON object, assign every read
-    // data to every elements that needs to be initialized
-    serializer.ReadFloat(friction, "physics.friction");
-    serializer.ReadFloat(threshold, "physics.threshold");
-    serializer.ReadBool(alrJumped, "physics.alrJumped");
-    serializer.ReadBool(isFalling, "physics.isFalling");
-    serializer.ReadBool(isSliding, "physics.isSliding");
+        if (a <= 1e-12f)
+        {
+            t = std::max(0.f, std::min(1.f, f / e));
+        }
+        else
+        {
+            float c = myMath::DotProductVector2D(d1, r);
+            if (e <= 1e-12f)
+            {
+                s = std::max(0.f, std::min(1.f, -c / a));
+            }
+            else
+            {
+                float b = myMath::DotProductVector2D(d1, d2);
+                float denom = a * e - b * b;
+
+                // Parallel segments have no single closest pair, any s will do
+                s = denom > 1e-12f ? std::max(0.f, std::min(1.f, (b * f - c * e) / denom)) : 0.f;
+                t = (b * s + f) / e;
+
+                if (t < 0.f)
+                {
+                    t = 0.f;
+                    s = std::max(0.f, std::min(1.f, -c / a));
+                }
+                else if (t > 1.f)
+                {
+                    t = 1.f;
+                    s = std::max(0.f, std::min(1.f, (b - c) / a));
+                }
+            }
+        }
+
+        c1 = p1 + d1 * s;
+        c2 = p2 + d2 * t;
+    }
+
+    // Two spheres swept along the closest points of their cores
+    bool roundedContact(const myMath::Vector2D& pointA, float radiusA, const myMath::Vector2D& pointB, float radiusB,
+                        myMath::Vector2D& normal, float& penetration)
+    {
+        myMath::Vector2D diff = pointA - pointB;
+        float distSqr = myMath::DotProductVector2D(diff, diff);
+        float reach = radiusA + radiusB;
+
+        if (distSqr > reach * reach)
+        {
+            return false;
+        }
+
+        float dist = std::sqrt(distSqr);
+        normal = dist > 0.f ? diff / dist : myMath::Vector2D(0.f, 1.f);
+        penetration = reach - dist;
+        return true;
+    }
+
+    void projectShape(const CollisionSystemECS::Shape& shape, const myMath::Vector2D& axis, float& min, float& max)
+    {
+        switch (shape.type)
+        {
+        case ColliderShape::CIRCLE:
+        {
+            float center = myMath::DotProductVector2D(shape.center, axis);
+            min = center - shape.radius;
+            max = center + shape.radius;
+            break;
+        }
+        case ColliderShape::CAPSULE:
+        {
+            float p0 = myMath::DotProductVector2D(shape.segment[0], axis);
+            float p1 = myMath::DotProductVector2D(shape.segment[1], axis);
+            min = std::min(p0, p1) - shape.radius;
+            max = std::max(p0, p1) + shape.radius;
+            break;
+        }
+        default:
+        {
+            min = max = myMath::DotProductVector2D(shape.vertices[0], axis);
+            for (int i = 1; i < shape.vertexCount; i++)
+            {
+                float projection = myMath::DotProductVector2D(shape.vertices[i], axis);
+                min = std::min(min, projection);
+                max = std::max(max, projection);
+            }
+            break;
+        }
+        }
+    }
+
+    // Test one SAT axis. Returns false when the axis separates the shapes,
+    // otherwise keeps the axis if it has the smallest overlap so far, facing
+    // the way that pushes a out of b. Degenerate axes are skipped
+    bool testAxis(const CollisionSystemECS::Shape& a, const CollisionSystemECS::Shape& b, myMath::Vector2D axis,
+                  myMath::Vector2D& normal, float& penetration)
+    {
+        float length = myMath::LengthVector2D(axis);
+        if (length <= 1e-6f)
+        {
+            return true;
+        }
+        axis = axis / length;
+
+        float minA, maxA, minB, maxB;
+        projectShape(a, axis, minA, maxA);
+        projectShape(b, axis, minB, maxB);
+
+        if (minA > maxB || minB > maxA)
+        {
+            return false;
+        }
+
+        // a below b along the axis leaves by going down, a above b by going up
+        float pushDown = maxA - minB;
+        float pushUp = maxB - minA;
+        float depth = std::min(pushDown, pushUp);
+
+        if (depth < penetration)
+        {
+            penetration = depth;
+            normal = pushUp < pushDown ? axis : -axis;
+        }
+        return true;
+    }
+
+    // Edge normals of a convex shape's vertex loop
+    bool testEdgeAxes(const CollisionSystemECS::Shape& convex, const CollisionSystemECS::Shape& a, const CollisionSystemECS::Shape& b,
+                      myMath::Vector2D& normal, float& penetration)
+    {
+        for (int i = 0; i < convex.vertexCount; i++)
+        {
+            myMath::Vector2D edge = convex.vertices[(i + 1) % convex.vertexCount] - convex.vertices[i];
+            if (!testAxis(a, b, myMath::Vector2D(edge.GetY(), -edge.GetX()), normal, penetration))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+// Rows are the first shape, columns the second. Pairs without a function of
+// their own reuse the mirrored one with the arguments swapped
+const CollisionSystemECS::DispatchEntry CollisionSystemECS::dispatchTable[static_cast<int>(ColliderShape::COUNT)][static_cast<int>(ColliderShape::COUNT)] =
+{
+    //             CIRCLE                                       OBB                                          CAPSULE                                      POLYGON
+    /* CIRCLE  */ { { &CollisionSystemECS::circleCircle, false },  { &CollisionSystemECS::circleOBB, false },     { &CollisionSystemECS::circleCapsule, false },  { &CollisionSystemECS::circlePolygon, false } },
+    /* OBB     */ { { &CollisionSystemECS::circleOBB, true },      { &CollisionSystemECS::obbOBB, false },        { &CollisionSystemECS::capsuleConvex, true },   { &CollisionSystemECS::convexConvex, false } },
+    /* CAPSULE */ { { &CollisionSystemECS::circleCapsule, true },  { &CollisionSystemECS::capsuleConvex, false }, { &CollisionSystemECS::capsuleCapsule, false }, { &CollisionSystemECS::capsuleConvex, false } },
+    /* POLYGON */ { { &CollisionSystemECS::circlePolygon, true },  { &CollisionSystemECS::convexConvex, false },  { &CollisionSystemECS::capsuleConvex, true },   { &CollisionSystemECS::convexConvex, false } }
+};
+
+// Collider offsets and shapes are in the entity's local space, so they turn
+// with its orientation. Collider sizes are absolute and ignore the scale.
+CollisionSystemECS::Shape CollisionSystemECS::createShapeFromEntity(Entity entity)
+{
+    if (!ecsCoordinator.hasComponent<ColliderComponent>(entity))
+    {
+        return createOBBShape(createOBBFromEntity(entity));
+    }
+
+    auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+    auto& collider = ecsCoordinator.getComponent<ColliderComponent>(entity);
+
+    float rotation = transform.orientation.GetX() * (M_PI / 180.0f);
+    myMath::Vector2D axisX(std::cos(rotation), std::sin(rotation));
+    myMath::Vector2D axisY(-std::sin(rotation), std::cos(rotation));
+    myMath::Vector2D center = transform.position + axisX * collider.offset.GetX() + axisY * collider.offset.GetY();
+
+    switch (collider.shape)
+    {
+    case ColliderShape::CIRCLE:
+        return createCircleShape(center, collider.GetRadius(transform.scale));
+
+    case ColliderShape::CAPSULE:
+    {
+        Shape shape{};
+        shape.type = ColliderShape::CAPSULE;
+        shape.center = center;
+        shape.radius = collider.GetRadius(transform.scale);
+        shape.segment[0] = center - axisY * collider.halfLength;
+        shape.segment[1] = center + axisY * collider.halfLength;
+        return shape;
+    }
+
+    case ColliderShape::POLYGON:
+    {
+        if (collider.vertexCount < 3)
+        {
+            break;
+        }
+
+        Shape shape{};
+        shape.type = ColliderShape::POLYGON;
+        shape.center = center;
+        shape.vertexCount = std::min(collider.vertexCount, MAX_POLYGON_VERTICES);
+        for (int i = 0; i < shape.vertexCount; i++)
+        {
+            shape.vertices[i] = center + axisX * collider.vertices[i].GetX() + axisY * collider.vertices[i].GetY();
+        }
+        return shape;
+    }
+
+    case ColliderShape::OBB:
+        return createOBBShape(createOBB(center, collider.halfExtents, rotation));
+
+    default:
+        break;
+    }
+
+    return createOBBShape(createOBBFromEntity(entity));
+}
+
+CollisionSystemECS::Shape CollisionSystemECS::createCircleShape(const myMath::Vector2D& center, float radius)
+{
+    Shape shape{};
+    shape.type = ColliderShape::CIRCLE;
+    shape.center = center;
+    shape.radius = radius;
+    return shape;
+}
+
+CollisionSystemECS::Shape CollisionSystemECS::createOBBShape(const OBB& obb)
+{
+    Shape shape{};
+    shape.type = ColliderShape::OBB;
+    shape.center = obb.center;
+    shape.obb = obb;
+    shape.vertexCount = 4;
+    getOBBVertices(obb, shape.vertices);
+    return shape;
+}
+
+void CollisionSystemECS::getShapeBounds(const Shape& shape, myMath::Vector2D& min, myMath::Vector2D& max)
+{
+    switch (shape.type)
+    {
+    case ColliderShape::CIRCLE:
+    {
+        myMath::Vector2D extent(shape.radius, shape.radius);
+        min = shape.center - extent;
+        max = shape.center + extent;
+        break;
+    }
+    case ColliderShape::CAPSULE:
+    {
+        myMath::Vector2D extent(shape.radius, shape.radius);
+        min = myMath::Vector2D(std::min(shape.segment[0].GetX(), shape.segment[1].GetX()), std::min(shape.segment[0].GetY(), shape.segment[1].GetY())) - extent;
+        max = myMath::Vector2D(std::max(shape.segment[0].GetX(), shape.segment[1].GetX()), std::max(shape.segment[0].GetY(), shape.segment[1].GetY())) + extent;
+        break;
+    }
+    default:
+    {
+        min = max = shape.vertices[0];
+        for (int i = 1; i < shape.vertexCount; i++)
+        {
+            min = myMath::Vector2D(std::min(min.GetX(), shape.vertices[i].GetX()), std::min(min.GetY(), shape.vertices[i].GetY()));
+            max = myMath::Vector2D(std::max(max.GetX(), shape.vertices[i].GetX()), std::max(max.GetY(), shape.vertices[i].GetY()));
+        }
+        break;
+    }
+    }
+}
+
+bool CollisionSystemECS::collide(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    const DispatchEntry& entry = dispatchTable[static_cast<int>(a.type)][static_cast<int>(b.type)];
+
+    if (!entry.swapped)
+    {
+        return (this->*entry.fn)(a, b, normal, penetration);
+    }
+
+    if (!(this->*entry.fn)(b, a, normal, penetration))
+    {
+        return false;
+    }
+    normal = -normal;
+    return true;
+}
+
+bool CollisionSystemECS::circleCircle(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    return roundedContact(a.center, a.radius, b.center, b.radius, normal, penetration);
+}
+
+bool CollisionSystemECS::circleOBB(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    return checkCircleOBBCollision(a.center, a.radius, b.obb, normal, penetration);
+}
+
+bool CollisionSystemECS::circleCapsule(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    myMath::Vector2D closest = closestPointOnSegment(a.center, b.segment[0], b.segment[1]);
+    return roundedContact(a.center, a.radius, closest, b.radius, normal, penetration);
+}
+
+bool CollisionSystemECS::capsuleCapsule(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    myMath::Vector2D closestA{};
+    myMath::Vector2D closestB{};
+    closestPointsBetweenSegments(a.segment[0], a.segment[1], b.segment[0], b.segment[1], closestA, closestB);
+    return roundedContact(closestA, a.radius, closestB, b.radius, normal, penetration);
+}
+
+bool CollisionSystemECS::obbOBB(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    penetration = std::numeric_limits<float>::max();
+    if (!checkOBBCollisionSAT(a.obb, b.obb, normal, penetration))
+    {
+        return false;
+    }
+
+    // The SAT test's normal points from the first box to the second
+    normal = -normal;
+    return true;
+}
+
+// Besides the polygon's edges, the only other axis that can separate a circle
+// from it runs from the nearest vertex to the circle's center
+bool CollisionSystemECS::circlePolygon(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    penetration = std::numeric_limits<float>::max();
+
+    int nearest = 0;
+    float nearestDistSqr = std::numeric_limits<float>::max();
+    for (int i = 0; i < b.vertexCount; i++)
+    {
+        float distSqr = myMath::SquareDistanceVector2D(a.center, b.vertices[i]);
+        if (distSqr < nearestDistSqr)
+        {
+            nearestDistSqr = distSqr;
+            nearest = i;
+        }
+    }
+
+    return testEdgeAxes(b, a, b, normal, penetration) &&
+           testAxis(a, b, a.center - b.vertices[nearest], normal, penetration);
+}
+
+// A capsule adds its segment's normal, and for every vertex the axis from the
+// segment's closest point to it, which covers the rounded ends
+bool CollisionSystemECS::capsuleConvex(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    penetration = std::numeric_limits<float>::max();
+
+    if (!testEdgeAxes(b, a, b, normal, penetration))
+    {
+        return false;
+    }
+
+    myMath::Vector2D segment = a.segment[1] - a.segment[0];
+    if (!testAxis(a, b, myMath::Vector2D(-segment.GetY(), segment.GetX()), normal, penetration))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < b.vertexCount; i++)
+    {
+        myMath::Vector2D closest = closestPointOnSegment(b.vertices[i], a.segment[0], a.segment[1]);
+        if (!testAxis(a, b, b.vertices[i] - closest, normal, penetration))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CollisionSystemECS::convexConvex(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration)
+{
+    penetration = std::numeric_limits<float>::max();
+    return testEdgeAxes(a, a, b, normal, penetration) && testEdgeAxes(b, a, b, normal, penetration);
+}
+
+// Collision response for OBB
+void CollisionSystemECS::CollisionResponse(Entity player, myMath::Vector2D normal, float penetration)
+{
+    CollisionResponse(ecsCoordinator.getComponent<TransformComponent>(player), ecsCoordinator.getComponent<PhysicsComponent>(player), normal, penetration);
+}
+
+void CollisionSystemECS::CollisionResponse(TransformComponent& transform, PhysicsComponent& physics, const myMath::Vector2D& normal, float penetration)
+{
+    myMath::Vector2D& playerPos = transform.position;
+    myMath::Vector2D& vel = physics.velocity;
+
+    myMath::Vector2D tangent(-normal.GetY(), normal.GetX()); // Tangent vector along platform
+    float tangentVelocity = myMath::DotProductVector2D(vel, tangent); // Velocity along tangent
+    vel = tangent * tangentVelocity;
+
+    playerPos.SetX(playerPos.GetX() + normal.GetX() * penetration);
+    playerPos.SetY(playerPos.GetY() + normal.GetY() * penetration);
+}
+
+// Update function for Physics System
+// Frame time is banked in an accumulator and consumed in fixed steps, so the
+// simulation no longer depends on the render frame rate. The number of steps
+// per frame is capped; any time beyond the cap is dropped instead of making
+// the next frame even slower.
+// In deterministic mode the frame time is ignored and every update is one
+// step, so nothing depends on how long the frame took.
+void PhysicsSystemECS::update(float dt)
+{
+    refreshBodyLists();
+    RefreshStaticCollision();
+
+    if (deterministic)
+    {
+        accumulator = fixedDeltaTime;
+    }
+    else
+    {
+        accumulator += dt;
+
+        float maxAccumulated = fixedDeltaTime * static_cast<float>(maxSubsteps);
+        if (accumulator > maxAccumulated)
+        {
+            accumulator = maxAccumulated;
+        }
+    }
+
+    while (accumulator >= fixedDeltaTime)
+    {
+        buildIslands();
+
+        // Nothing moves while every body sleeps. The states are stored once
+        // more so they catch up with the last step, then left alone
+        bool storeTransforms = !islandsIdle || !interpolationSettled;
+        if (storeTransforms)
+        {
+            storePreviousTransforms();
+        }
+        step(fixedDeltaTime);
+        updateSleepState();
+        if (storeTransforms)
+        {
+            storeCurrentTransforms();
+            interpolationSettled = islandsIdle;
+        }
+        accumulator -= fixedDeltaTime;
+    }
+
+    interpolationAlpha = deterministic ? 1.f : accumulator / fixedDeltaTime;
+
+    updateTriggers();
+}
+
+// Runs once per frame after stepping, since the behaviours receiving the
+// events work in frame time. Each trigger is only tested against the moving
+// bodies, which is where every gameplay overlap comes from.
+// When no step moved a body and no trigger moved since the last test, the
+// overlaps cannot have changed and they only get their stay events again.
+void PhysicsSystemECS::updateTriggers()
+{
+    refreshBodyLists();
+
+    struct PendingEvent {
+        TriggerEvent event;
+        Entity trigger;
+        Entity other;
+    };
+    std::vector<PendingEvent> events;
+
+    bool retest = triggerListsVersion != bodyListsVersion || triggerStep != movedSteps;
+    for (size_t i = 0; i < triggerSnapshots.size() && !retest; i++)
+    {
+        retest = volumeChanged(triggerSnapshots[i]);
+    }
+
+    if (!retest)
+    {
+        for (auto& key : triggerOrder)
+        {
+            events.push_back({ TriggerEvent::STAY, static_cast<Entity>(key >> 32), static_cast<Entity>(key & 0xFFFFFFFFu) });
+        }
+    }
+    else
+    {
+        triggerListsVersion = bodyListsVersion;
+        triggerStep = movedSteps;
+        triggerSnapshots.clear();
+        for (auto& trigger : triggerEntities)
+        {
+            triggerSnapshots.push_back(takeVolumeSnapshot(trigger));
+        }
+
+        std::unordered_set<uint64_t> currentOverlaps;
+        triggerOrder.clear();
+
+        // The broadphase only hands back triggers near each body
+        std::vector<Entity> triggers;
+        for (size_t i = 0; i < triggerBodies.size() && !triggerEntities.empty(); i++)
+        {
+            Entity body = triggerBodies[i];
+            triggers.clear();
+            OverlapShape(getBodyShape(body), triggers, [](Entity entity)
+                {
+                    return ecsCoordinator.hasComponent<TriggerComponent>(entity);
+                });
+
+            for (auto& trigger : triggers)
+            {
+                uint64_t key = (static_cast<uint64_t>(trigger) << 32) | static_cast<uint64_t>(body);
+                currentOverlaps.insert(key);
+                triggerOrder.push_back(key);
+                events.push_back({ triggerOverlaps.count(key) ? TriggerEvent::STAY : TriggerEvent::ENTER, trigger, body });
+            }
+        }
+
+        // Hash set order is not stable, exits go out sorted by trigger then body
+        std::vector<uint64_t> exits;
+        for (auto& key : triggerOverlaps)
+        {
+            if (currentOverlaps.count(key) == 0)
+            {
+                exits.push_back(key);
+            }
+        }
+        std::sort(exits.begin(), exits.end());
+
+        for (auto& key : exits)
+        {
+            events.push_back({ TriggerEvent::EXIT, static_cast<Entity>(key >> 32), static_cast<Entity>(key & 0xFFFFFFFFu) });
+        }
+
+        triggerOverlaps.swap(currentOverlaps);
+    }
+
+    // Events are sent after testing since a behaviour may destroy its entity
+    auto logicSystem = ecsCoordinator.getSpecificSystem<LogicSystemECS>();
+    for (auto& pending : events)
+    {
+        if (entities.find(pending.trigger) == entities.end())
+        {
+            continue;
+        }
+        logicSystem->dispatchTriggerEvent(pending.event, pending.trigger, pending.other);
+    }
+}
+
+// Record where every physics body is before a step
+void PhysicsSystemECS::storePreviousTransforms()
+{
+    for (auto& entity : physicsBodies)
+    {
+        interpolationStates[entity].prevPosition = ecsCoordinator.getComponent<TransformComponent>(entity).position;
+    }
+}
+
+// Record where every physics body ended up after a step
+void PhysicsSystemECS::storeCurrentTransforms()
+{
+    for (auto& entity : physicsBodies)
+    {
+        interpolationStates[entity].currPosition = ecsCoordinator.getComponent<TransformComponent>(entity).position;
+    }
+}
+
+// Blend between the previous and current step. If something other than the
+// physics step has moved the entity since (editor, behaviours, level load),
+// the stored states are stale and the live position is used as is.
+myMath::Vector2D PhysicsSystemECS::getInterpolatedPosition(Entity entity, const TransformComponent& transform) const
+{
+    auto it = interpolationStates.find(entity);
+    if (it == interpolationStates.end())
+    {
+        return transform.position;
+    }
+
+    const InterpolationState& state = it->second;
+    if (state.currPosition.GetX() != transform.position.GetX() || state.currPosition.GetY() != transform.position.GetY())
+    {
+        return transform.position;
+    }
+
+    return state.prevPosition + (state.currPosition - state.prevPosition) * interpolationAlpha;
+}
+
+bool PhysicsSystemECS::isDynamicBody(Entity entity) const
+{
+    return ecsCoordinator.hasComponent<PhysicsComponent>(entity) && !ecsCoordinator.hasComponent<ClosestPlatform>(entity);
+}
+
+void PhysicsSystemECS::entityChanged(Entity entity)
+{
+    (void)entity;
+    bodyListsDirty = true;
+}
+
+// The lists keep the entity set's order, so every pass walks the bodies in
+// the same order it did when it went through every entity
+void PhysicsSystemECS::refreshBodyLists()
+{
+    if (!bodyListsDirty)
+    {
+        return;
+    }
+    bodyListsDirty = false;
+    bodyListsVersion++;
+    broadphaseDirty = true;
+
+    physicsBodies.clear();
+    dynamicBodies.clear();
+    triggerBodies.clear();
+    forceFieldEntities.clear();
+    triggerEntities.clear();
+    screenEntities.clear();
+
+    for (auto& entity : entities)
+    {
+        bool isTrigger = ecsCoordinator.hasComponent<TriggerComponent>(entity);
+        if (ecsCoordinator.hasComponent<PhysicsComponent>(entity))
+        {
+            physicsBodies.push_back(entity);
+            if (isDynamicBody(entity))
+            {
+                dynamicBodies.push_back(entity);
+                if (!isTrigger)
+                {
+                    triggerBodies.push_back(entity);
+                }
+            }
+        }
+
+        if (!ecsCoordinator.hasComponent<TransformComponent>(entity))
+        {
+            continue;
+        }
+        if (ecsCoordinator.hasComponent<ForceFieldComponent>(entity))
+        {
+            forceFieldEntities.push_back(entity);
+        }
+        if (isTrigger)
+        {
+            triggerEntities.push_back(entity);
+        }
+        if (IsScreenSpace(entity))
+        {
+            screenEntities.push_back(entity);
+        }
+    }
+}
+
+bool PhysicsSystemECS::IsSleeping(Entity entity) const
+{
+    return ecsCoordinator.hasComponent<PhysicsComponent>(entity) && ecsCoordinator.getComponent<PhysicsComponent>(entity).isSleeping;
+}
+
+// Platforms never move, so they do not join islands together. Two dynamic
+// bodies share an island when their bounding circles touch.
+void PhysicsSystemECS::buildIslands()
+{
+    // With every body asleep the islands can only change when a body is woken,
+    // a sleeper is moved from outside, a field changes or entities come and go.
+    // Until then the last islands still hold and only the sleepers are looked at
+    refreshBodyLists();
+    islandsIdle = awakeBodyCount == 0 && !islandsDirty && islandListsVersion == bodyListsVersion && !fieldsChanged();
+    if (islandsIdle)
+    {
+        for (auto& snapshot : sleepSnapshots)
+        {
+            if (isDisturbed(snapshot.first))
+            {
+                islandsIdle = false;
+                break;
+            }
+        }
+    }
+    if (islandsIdle)
+    {
+        return;
+    }
+    islandsDirty = false;
+    islandListsVersion = bodyListsVersion;
+
+    const std::vector<Entity>& bodies = dynamicBodies;
+
+    // Union-find over the bodies
+    std::vector<size_t> parent(bodies.size());
+    for (size_t i = 0; i < parent.size(); i++)
+    {
+        parent[i] = i;
+    }
+
+    auto findRoot = [&parent](size_t i)
+    {
+        while (parent[i] != i)
+        {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    };
+
+    // Bounding circles go into their own grid so each body is only paired
+    // with the bodies in nearby cells instead of every other body
+    if (islandGrid.getCellSize() != broadphaseCellSize)
+    {
+        islandGrid.setCellSize(broadphaseCellSize);
+    }
+
+    std::unordered_map<Entity, size_t> indexOfBody;
+    std::vector<float> radii(bodies.size());
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        auto& transform = ecsCoordinator.getComponent<TransformComponent>(bodies[i]);
+        radii[i] = getBoundingRadius(bodies[i]);
+        indexOfBody[bodies[i]] = i;
+
+        myMath::Vector2D extent(radii[i], radii[i]);
+        islandGrid.update(bodies[i], { transform.position - extent, transform.position + extent });
+    }
+
+    std::vector<Entity> candidates;
+    islandGrid.getEntities(candidates);
+    for (auto& entity : candidates)
+    {
+        if (indexOfBody.find(entity) == indexOfBody.end())
+        {
+            islandGrid.remove(entity);
+        }
+    }
+
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        auto& transformA = ecsCoordinator.getComponent<TransformComponent>(bodies[i]);
+        myMath::Vector2D extent(radii[i], radii[i]);
+
+        candidates.clear();
+        islandGrid.queryRegion({ transformA.position - extent, transformA.position + extent }, candidates);
+
+        for (auto& other : candidates)
+        {
+            // Each pair is tested once, from its lower index
+            size_t j = indexOfBody[other];
+            if (j <= i)
+            {
+                continue;
+            }
+            stepStats.broadphasePairs++;
+
+            auto& transformB = ecsCoordinator.getComponent<TransformComponent>(bodies[j]);
+            float reach = radii[i] + radii[j];
+
+            if (myMath::SquareDistanceVector2D(transformA.position, transformB.position) <= reach * reach)
+            {
+                parent[findRoot(i)] = findRoot(j);
+            }
+        }
+    }
+
+    islands.clear();
+    islandOfBody.clear();
+
+    std::unordered_map<size_t, size_t> islandOfRoot;
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        size_t root = findRoot(i);
+        auto it = islandOfRoot.find(root);
+        if (it == islandOfRoot.end())
+        {
+            it = islandOfRoot.emplace(root, islands.size()).first;
+            islands.emplace_back();
+        }
+        islands[it->second].push_back(bodies[i]);
+        islandOfBody[bodies[i]] = it->second;
+    }
+
+    // An island wakes when any member is awake (an awake body touched a
+    // sleeping one) or a sleeping member was moved or turned from outside
+    for (auto& island : islands)
+    {
+        bool disturbed = false;
+        for (auto& body : island)
+        {
+            if (!IsSleeping(body) || isDisturbed(body))
+            {
+                disturbed = true;
+                break;
+            }
+        }
+
+        if (disturbed)
+        {
+            for (auto& body : island)
+            {
+                auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(body);
+                physics.isSleeping = false;
+                sleepSnapshots.erase(body);
+            }
+        }
+    }
+}
+
+bool PhysicsSystemECS::isDisturbed(Entity body) const
+{
+    auto snapshot = sleepSnapshots.find(body);
+    if (snapshot == sleepSnapshots.end())
+    {
+        return true;
+    }
+
+    // A behaviour asked the body to move again
+    auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(body);
+    if (physics.desiredVelocity.GetX() != 0.f || physics.desiredVelocity.GetY() != 0.f)
+    {
+        return true;
+    }
+
+    auto& transform = ecsCoordinator.getComponent<TransformComponent>(body);
+    return snapshot->second.position.GetX() != transform.position.GetX() ||
+           snapshot->second.position.GetY() != transform.position.GetY() ||
+           snapshot->second.orientation.GetX() != transform.orientation.GetX() ||
+           snapshot->second.orientation.GetY() != transform.orientation.GetY();
+}
+
+// A body counts as idle while its speed stays under the threshold. An island
+// only sleeps once every member has been idle for sleepStepCount steps.
+void PhysicsSystemECS::updateSleepState()
+{
+    if (islandsIdle)
+    {
+        return;
+    }
+
+    awakeBodyCount = 0;
+    for (auto& island : islands)
+    {
+        bool islandIdle = true;
+        for (auto& body : island)
+        {
+            auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(body);
+            if (physics.isSleeping)
+            {
+                continue;
+            }
+
+            // A body still steering somewhere is not idle, even when it is blocked
+            bool steering = physics.desiredVelocity.GetX() != 0.f || physics.desiredVelocity.GetY() != 0.f;
+            if (!steering && myMath::LengthVector2D(physics.velocity) < sleepVelocityThreshold)
+            {
+                physics.idleSteps++;
+            }
+            else
+            {
+                physics.idleSteps = 0;
+            }
+
+            if (physics.idleSteps < sleepStepCount)
+            {
+                islandIdle = false;
+            }
+        }
+
+        if (!islandIdle)
+        {
+            continue;
+        }
+
+        for (auto& body : island)
+        {
+            auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(body);
+            if (physics.isSleeping)
+            {
+                continue;
+            }
+
+            auto& transform = ecsCoordinator.getComponent<TransformComponent>(body);
+            physics.isSleeping = true;
+            physics.velocity = myMath::Vector2D(0.f, 0.f);
+            sleepSnapshots[body] = { transform.position, transform.orientation };
+        }
+    }
+
+    for (auto& island : islands)
+    {
+        for (auto& body : island)
+        {
+            if (!IsSleeping(body))
+            {
+                awakeBodyCount++;
+            }
+        }
+    }
+}
+
+// Bodies with no mass still integrate but are left out of the contact
+// solver, which cannot move them
+void PhysicsSystemECS::prepareSolverBodies(const std::vector<Entity>& bodies)
+{
+    solverBodies.clear();
+    solverIslands.clear();
+
+    // Without static collision there is no surface to find, and the closest
+    // platform lookup would hand back the body itself
+    bool hasStaticShapes = staticWorld.getShapeCount() > 0;
+
+    std::unordered_map<size_t, size_t> jobOfIsland;
+    for (auto& entity : bodies)
+    {
+        SolverBody body{};
+        body.entity = entity;
+        body.transform = &ecsCoordinator.getComponent<TransformComponent>(entity);
+        body.physics = &ecsCoordinator.getComponent<PhysicsComponent>(entity);
+        body.radius = getBodyRadius(entity);
+        body.startPosition = body.transform->position;
+        body.invMass = body.physics->mass > 0.f ? 1.f / body.physics->mass : 0.f;
+        body.steered = ecsCoordinator.hasComponent<EnemyComponent>(entity);
+        body.fieldKind = getFieldKind(entity);
+
+        // Only the player is pushed along by its closest surface
+        body.hasSurface = !body.steered && hasStaticShapes;
+        if (body.hasSurface)
+        {
+            body.platformOBB = findClosestSurface(entity, body.radius);
+        }
+
+        if (body.physics->mass <= 0.f)
+        {
+            solverBodies.push_back(std::move(body));
+            continue;
+        }
+
+        // Bodies outside any island get a job of their own
+        auto island = islandOfBody.find(entity);
+        size_t job = solverIslands.size();
+        if (island != islandOfBody.end())
+        {
+            job = jobOfIsland.emplace(island->second, solverIslands.size()).first->second;
+        }
+        if (job == solverIslands.size())
+        {
+            solverIslands.emplace_back();
+        }
+
+        solverIslands[job].push_back(solverBodies.size());
+        solverBodies.push_back(std::move(body));
+    }
+}
+
+// Each worker writes only to its own scratch buffer. The buffers are joined
+// and sorted by contact key afterwards, so the cache is updated in the same
+// order however many workers there are and whichever pairs each one got.
+void PhysicsSystemECS::detectContacts()
+{
+    contactPairs.clear();
+    bool hasStaticShapes = staticWorld.getShapeCount() > 0;
+
+    std::vector<Entity> shapes;
+    for (size_t i = 0; i < solverBodies.size(); i++)
+    {
+        if (solverBodies[i].physics->mass <= 0.f)
+        {
+            continue;
+        }
+
+        // The body has moved since it was gathered. The shape is also needed
+        // for the body pairs when there is no static collision
+        solverBodies[i].shape = getBodyShape(solverBodies[i].entity);
+        if (!hasStaticShapes)
+        {
+            continue;
+        }
+
+        SpatialGrid::Bounds bounds{};
+        collisionSystem.getShapeBounds(solverBodies[i].shape, bounds.min, bounds.max);
+
+        shapes.clear();
+        staticWorld.queryRegion(bounds, shapes);
+        for (auto& shapeIndex : shapes)
+        {
+            contactPairs.push_back({ i, shapeIndex });
+        }
+    }
+    stepStats.broadphasePairs += contactPairs.size();
+
+    workerPool.parallelFor(contactPairs.size(), 64, [this](size_t begin, size_t end, size_t worker)
+        {
+            WorkerScratch& scratch = workerScratch[worker];
+            for (size_t i = begin; i < end; i++)
+            {
+                const ContactPair& pair = contactPairs[i];
+                const SolverBody& body = solverBodies[pair.body];
+                const StaticCollisionWorld::Shape& shape = staticWorld.getShape(pair.shape);
+                CollisionSystemECS::Shape platformShape = collisionSystem.createOBBShape(collisionSystem.createOBB(shape.center, shape.halfExtents, shape.rotation));
+
+                myMath::Vector2D normal{};
+                float penetration{};
+                scratch.narrowphaseTests++;
+
+                if (collisionSystem.collide(body.shape, platformShape, normal, penetration))
+                {
+                    uint64_t key = (static_cast<uint64_t>(body.entity) << 32) | static_cast<uint64_t>(pair.shape);
+                    scratch.contacts.push_back({ key, pair.body, pair.shape, normal, penetration });
+                }
+            }
+        });
+
+    std::vector<ContactPoint> contacts;
+    for (auto& scratch : workerScratch)
+    {
+        contacts.insert(contacts.end(), scratch.contacts.begin(), scratch.contacts.end());
+    }
+    std::sort(contacts.begin(), contacts.end(), [](const ContactPoint& a, const ContactPoint& b) { return a.key < b.key; });
+    stepStats.contacts += contacts.size();
+
+    // Contacts of bodies that sat this step out are kept for when they wake
+    std::unordered_set<Entity> stepping;
+    for (auto& body : solverBodies)
+    {
+        if (body.physics->mass > 0.f)
+        {
+            stepping.insert(body.entity);
+        }
+    }
+    for (auto& [key, contact] : contactCache)
+    {
+        if (stepping.count(contact.body))
+        {
+            contact.touched = false;
+        }
+    }
+
+    for (auto& point : contacts)
+    {
+        auto [it, inserted] = contactCache.try_emplace(point.key);
+        ContactManifold& contact = it->second;
+
+        // A contact whose normal swung round (rolled over a corner) is a new
+        // contact as far as the old impulses are concerned
+        if (inserted || myMath::DotProductVector2D(contact.normal, point.normal) < 0.9f)
+        {
+            contact.normalImpulse = 0.f;
+            contact.tangentImpulse = 0.f;
+        }
+
+        contact.body = solverBodies[point.body].entity;
+        contact.shape = point.shape;
+        contact.normal = point.normal;
+        contact.penetration = point.penetration;
+        contact.touched = true;
+        solverBodies[point.body].contacts.push_back(&contact);
+    }
+
+    // Drop contacts that separated
+    for (auto it = contactCache.begin(); it != contactCache.end();)
+    {
+        if (!it->second.touched && stepping.count(it->second.body))
+        {
+            it = contactCache.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // Touching bodies always share an island, so each island is paired up by
+    // one worker and the islands never write to the same list
+    islandContactPoints.resize(solverIslands.size());
+    workerPool.parallelFor(solverIslands.size(), 1, [this](size_t begin, size_t end, size_t worker)
+        {
+            for (size_t job = begin; job < end; job++)
+            {
+                detectBodyContacts(job, workerScratch[worker]);
+            }
+        });
+
+    for (auto& [key, contact] : bodyContactCache)
+    {
+        if (stepping.count(contact.bodyA) || stepping.count(contact.bodyB))
+        {
+            contact.touched = false;
+        }
+    }
+
+    islandContacts.resize(solverIslands.size());
+    for (size_t job = 0; job < solverIslands.size(); job++)
+    {
+        islandContacts[job].clear();
+        stepStats.contacts += islandContactPoints[job].size();
+
+        for (auto& point : islandContactPoints[job])
+        {
+            auto [it, inserted] = bodyContactCache.try_emplace(point.key);
+            BodyContact& contact = it->second;
+
+            if (inserted || myMath::DotProductVector2D(contact.normal, point.normal) < 0.9f)
+            {
+                contact.normalImpulse = 0.f;
+                contact.tangentImpulse = 0.f;
+            }
+
+            contact.bodyA = solverBodies[point.bodyA].entity;
+            contact.bodyB = solverBodies[point.bodyB].entity;
+            contact.solverA = point.bodyA;
+            contact.solverB = point.bodyB;
+            contact.normal = point.normal;
+            contact.penetration = point.penetration;
+            contact.touched = true;
+            islandContacts[job].push_back(&contact);
+        }
+    }
+
+    for (auto it = bodyContactCache.begin(); it != bodyContactCache.end();)
+    {
+        if (!it->second.touched && (stepping.count(it->second.bodyA) || stepping.count(it->second.bodyB)))
+        {
+            it = bodyContactCache.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+// Islands are small, so their bodies are swept along x instead of going
+// through a grid. Pairs are sorted by key so the cache sees them in the same
+// order whatever order the sweep found them in
+void PhysicsSystemECS::detectBodyContacts(size_t job, WorkerScratch& scratch)
+{
+    std::vector<BodyContactPoint>& points = islandContactPoints[job];
+    points.clear();
+
+    const std::vector<size_t>& island = solverIslands[job];
+    if (island.size() < 2)
+    {
+        return;
+    }
+
+    scratch.spans.clear();
+    for (auto& index : island)
+    {
+        BodySpan span{};
+        span.body = index;
+        collisionSystem.getShapeBounds(solverBodies[index].shape, span.bounds.min, span.bounds.max);
+        scratch.spans.push_back(span);
+    }
+    std::sort(scratch.spans.begin(), scratch.spans.end(), [](const BodySpan& a, const BodySpan& b)
+        {
+            return a.bounds.min.GetX() < b.bounds.min.GetX() || (a.bounds.min.GetX() == b.bounds.min.GetX() && a.body < b.body);
+        });
+
+    for (size_t i = 0; i < scratch.spans.size(); i++)
+    {
+        const SpatialGrid::Bounds& boundsA = scratch.spans[i].bounds;
+        for (size_t j = i + 1; j < scratch.spans.size() && scratch.spans[j].bounds.min.GetX() <= boundsA.max.GetX(); j++)
+        {
+            const SpatialGrid::Bounds& boundsB = scratch.spans[j].bounds;
+            if (boundsB.min.GetY() > boundsA.max.GetY() || boundsB.max.GetY() < boundsA.min.GetY())
+            {
+                continue;
+            }
+            scratch.broadphasePairs++;
+
+            size_t a = scratch.spans[i].body;
+            size_t b = scratch.spans[j].body;
+            if (solverBodies[a].entity > solverBodies[b].entity)
+            {
+                std::swap(a, b);
+            }
+
+            myMath::Vector2D normal{};
+            float penetration{};
+            scratch.narrowphaseTests++;
+
+            if (collisionSystem.collide(solverBodies[a].shape, solverBodies[b].shape, normal, penetration))
+            {
+                uint64_t key = (static_cast<uint64_t>(solverBodies[a].entity) << 32) | static_cast<uint64_t>(solverBodies[b].entity);
+                points.push_back({ key, a, b, normal, penetration });
+            }
+        }
+    }
+
+    std::sort(points.begin(), points.end(), [](const BodyContactPoint& a, const BodyContactPoint& b) { return a.key < b.key; });
+}
+
+// Body contacts are only made between bodies of the same island, so islands
+// never share a body or a contact. They are independent jobs and any split
+// gives the same result
+void PhysicsSystemECS::solveIslands()
+{
+    workerPool.parallelFor(solverIslands.size(), 1, [this](size_t begin, size_t end, size_t)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                solveIsland(i);
+            }
+        });
+}
+
+// Sequential impulse contact solver
+// Contacts are cached per body/platform and body/body pair and keep the
+// impulses they ended the last step with. Applying those up front (warm
+// starting) means a resting contact is already close to solved, so a few
+// iterations are enough even when the player is wedged between several
+// platforms or bodies are stacked on each other.
+// A body/body impulse is split between the two bodies by their inverse mass.
+void PhysicsSystemECS::solveIsland(size_t job)
+{
+    const std::vector<size_t>& island = solverIslands[job];
+    const std::vector<BodyContact*>& pairs = islandContacts[job];
+
+    // Warm start
+    for (auto& index : island)
+    {
+        SolverBody& body = solverBodies[index];
+        for (auto* contact : body.contacts)
+        {
+            myMath::Vector2D tangent(-contact->normal.GetY(), contact->normal.GetX());
+            body.physics->velocity += (contact->normal * contact->normalImpulse + tangent * contact->tangentImpulse) * body.invMass;
+        }
+    }
+    for (auto* contact : pairs)
+    {
+        SolverBody& bodyA = solverBodies[contact->solverA];
+        SolverBody& bodyB = solverBodies[contact->solverB];
+        myMath::Vector2D tangent(-contact->normal.GetY(), contact->normal.GetX());
+        myMath::Vector2D impulse = contact->normal * contact->normalImpulse + tangent * contact->tangentImpulse;
+        bodyA.physics->velocity += impulse * bodyA.invMass;
+        bodyB.physics->velocity -= impulse * bodyB.invMass;
+    }
+
+    for (int iteration = 0; iteration < solverIterations; iteration++)
+    {
+        for (auto& index : island)
+        {
+            SolverBody& body = solverBodies[index];
+            myMath::Vector2D& vel = body.physics->velocity;
+
+            for (auto* contact : body.contacts)
+            {
+                myMath::Vector2D tangent(-contact->normal.GetY(), contact->normal.GetX());
+
+                // Normal impulse, accumulated total may only push
+                float normalVelocity = myMath::DotProductVector2D(vel, contact->normal);
+                float oldNormalImpulse = contact->normalImpulse;
+                contact->normalImpulse = std::max(oldNormalImpulse - normalVelocity / body.invMass, 0.f);
+                vel += contact->normal * ((contact->normalImpulse - oldNormalImpulse) * body.invMass);
+
+                // Friction impulse, bounded by the normal impulse. The movement
+                // friction is a different thing and is not used here
+                float tangentVelocity = myMath::DotProductVector2D(vel, tangent);
+                float maxFriction = contactFriction * contact->normalImpulse;
+                float oldTangentImpulse = contact->tangentImpulse;
+                contact->tangentImpulse = std::clamp(oldTangentImpulse - tangentVelocity / body.invMass, -maxFriction, maxFriction);
+                vel += tangent * ((contact->tangentImpulse - oldTangentImpulse) * body.invMass);
+            }
+        }
+
+        for (auto* contact : pairs)
+        {
+            SolverBody& bodyA = solverBodies[contact->solverA];
+            SolverBody& bodyB = solverBodies[contact->solverB];
+            myMath::Vector2D& velA = bodyA.physics->velocity;
+            myMath::Vector2D& velB = bodyB.physics->velocity;
+            myMath::Vector2D tangent(-contact->normal.GetY(), contact->normal.GetX());
+            float pairInvMass = bodyA.invMass + bodyB.invMass;
+
+            float normalVelocity = myMath::DotProductVector2D(velA - velB, contact->normal);
+            float oldNormalImpulse = contact->normalImpulse;
+            contact->normalImpulse = std::max(oldNormalImpulse - normalVelocity / pairInvMass, 0.f);
+            myMath::Vector2D normalImpulse = contact->normal * (contact->normalImpulse - oldNormalImpulse);
+            velA += normalImpulse * bodyA.invMass;
+            velB -= normalImpulse * bodyB.invMass;
+
+            float tangentVelocity = myMath::DotProductVector2D(velA - velB, tangent);
+            float maxFriction = contactFriction * contact->normalImpulse;
+            float oldTangentImpulse = contact->tangentImpulse;
+            contact->tangentImpulse = std::clamp(oldTangentImpulse - tangentVelocity / pairInvMass, -maxFriction, maxFriction);
+            myMath::Vector2D tangentImpulse = tangent * (contact->tangentImpulse - oldTangentImpulse);
+            velA += tangentImpulse * bodyA.invMass;
+            velB -= tangentImpulse * bodyB.invMass;
+        }
+    }
+
+    // Push out of any remaining overlap, leaving a small slop so resting
+    // contacts stay touching and keep their cached impulses
+    for (auto& index : island)
+    {
+        SolverBody& body = solverBodies[index];
+        for (auto* contact : body.contacts)
+        {
+            float correction = std::max(contact->penetration - penetrationSlop, 0.f) * baumgarte;
+            body.transform->position += contact->normal * correction;
+        }
+    }
+    for (auto* contact : pairs)
+    {
+        SolverBody& bodyA = solverBodies[contact->solverA];
+        SolverBody& bodyB = solverBodies[contact->solverB];
+        float correction = std::max(contact->penetration - penetrationSlop, 0.f) * baumgarte / (bodyA.invMass + bodyB.invMass);
+        bodyA.transform->position += contact->normal * (correction * bodyA.invMass);
+        bodyB.transform->position -= contact->normal * (correction * bodyB.invMass);
+    }
+}
+
+// Wake the body and everything sharing its island
+void PhysicsSystemECS::WakeBody(Entity entity)
+{
+    islandsDirty = true;
+
+    auto it = islandOfBody.find(entity);
+    if (it == islandOfBody.end())
+    {
+        auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(entity);
+        physics.isSleeping = false;
+        physics.idleSteps = 0;
+        sleepSnapshots.erase(entity);
+        return;
+    }
+
+    for (auto& body : islands[it->second])
+    {
+        auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(body);
+        physics.isSleeping = false;
+        physics.idleSteps = 0;
+        sleepSnapshots.erase(body);
+    }
+}
+
+void PhysicsSystemECS::LoadStaticCollision(std::string const& scenePath)
+{
+    staticCachePath = StaticCollisionWorld::getCachePath(scenePath);
+    staticCollisionDirty = true;
+    RefreshStaticCollision();
+}
+
+void PhysicsSystemECS::NotifyTransformEdited(Entity entity)
+{
+    broadphaseDirty = true;
+    if (ecsCoordinator.hasComponent<ClosestPlatform>(entity) || ecsCoordinator.hasComponent<TilemapComponent>(entity))
+    {
+        staticCollisionDirty = true;
+    }
+}
+
+// Platforms are compared against the last bake once the editor marks them
+// dirty or entities are created or destroyed. Scene loads go through the cache
+// file, editor changes are only rebaked in memory since the scene on disk has
+// not changed.
+// Tilemaps are compared by their cached hash of solid tiles, their tiles
+// are only expanded into sources when a bake is actually needed.
+void PhysicsSystemECS::RefreshStaticCollision()
+{
+    if (!staticCollisionDirty && staticEntityCount == entities.size())
+    {
+        return;
+    }
+    staticCollisionDirty = false;
+    staticEntityCount = entities.size();
+
+    std::vector<StaticCollisionWorld::Source> sources;
+    std::vector<Entity>& tilemaps = tilemapEntities;
+    tilemaps.clear();
+    for (auto& entity : entities)
+    {
+        if (ecsCoordinator.hasComponent<ClosestPlatform>(entity))
+        {
+            auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+            sources.push_back({ entity, transform.position, transform.scale, transform.orientation.GetX(), ecsCoordinator.getEntityID(entity) });
+        }
+        else if (ecsCoordinator.hasComponent<TilemapComponent>(entity))
+        {
+            tilemaps.push_back(entity);
+        }
+    }
+
+    uint64_t fingerprint = StaticCollisionWorld::computeFingerprint(sources);
+    for (auto& entity : tilemaps)
+    {
+        auto& tilemap = ecsCoordinator.getComponent<TilemapComponent>(entity);
+        auto& origin = ecsCoordinator.getComponent<TransformComponent>(entity).position;
+        float values[3] = { origin.GetX(), origin.GetY(), tilemap.tileSize };
+        uint64_t tileHash = Tilemap::GetCollisionHash(tilemap);
+        std::string id = ecsCoordinator.getEntityID(entity);
+        uint64_t idLength = id.size();
+
+        fingerprint = StaticCollisionWorld::mixFingerprint(fingerprint, &idLength, sizeof(idLength));
+        fingerprint = StaticCollisionWorld::mixFingerprint(fingerprint, id.data(), id.size());
+        fingerprint = StaticCollisionWorld::mixFingerprint(fingerprint, values, sizeof(values));
+        fingerprint = StaticCollisionWorld::mixFingerprint(fingerprint, &tileHash, sizeof(tileHash));
+    }
+
+    if (staticWorld.isBaked() && staticWorld.getFingerprint() == fingerprint)
+    {
+        staticCachePath.clear();
+        return;
+    }
+
+    for (auto& entity : tilemaps)
+    {
+        Tilemap::AppendCollisionSources(ecsCoordinator.getComponent<TilemapComponent>(entity), entity, ecsCoordinator.getEntityID(entity),
+                                        ecsCoordinator.getComponent<TransformComponent>(entity).position, sources);
+    }
+
+    if (staticCachePath.empty())
+    {
+        staticWorld.bake(sources, fingerprint);
+    }
+    else if (staticWorld.load(staticCachePath, fingerprint, sources))
+    {
+        Console::GetLog() << "Static collision loaded from " << staticCachePath << std::endl;
+    }
+    else
+    {
+        staticWorld.bake(sources, fingerprint);
+        if (!staticWorld.save(staticCachePath))
+        {
+            Console::GetLog() << "Error: could not save to file " << staticCachePath << std::endl;
+        }
+        Console::GetLog() << "Static collision baked: " << staticWorld.getSourceCount() << " platforms into "
+                          << staticWorld.getShapeCount() << " shapes" << std::endl;
+    }
+
+    staticCachePath.clear();
+
+    // Cached contacts refer to shapes of the old bake
+    contactCache.clear();
+}
+
+namespace
+{
+    // Distance from a point to the nearest point of a box, 0 inside it
+    float distanceToOBB(const myMath::Vector2D& point, const CollisionSystemECS::OBB& obb)
+    {
+        myMath::Vector2D offset = point - obb.center;
+        float outside[2]{};
+        for (int i = 0; i < 2; i++)
+        {
+            float along = myMath::DotProductVector2D(offset, obb.axes[i]);
+            float half = i == 0 ? obb.halfExtents.GetX() : obb.halfExtents.GetY();
+            outside[i] = std::max(std::fabs(along) - half, 0.f);
+        }
+        return std::sqrt(outside[0] * outside[0] + outside[1] * outside[1]);
+    }
+}
+
+// Solid tiles are looked up within a tile of the body's edge, anything further
+// cannot be touched this step. The platform found by the broadphase wins unless
+// a tile is closer.
+CollisionSystemECS::OBB PhysicsSystemECS::findClosestSurface(Entity body, float radius)
+{
+    Entity closestPlatformEntity = FindClosestPlatform(body);
+    CollisionSystemECS::OBB closest = getPlatformOBB(closestPlatformEntity);
+    if (tilemapEntities.empty())
+    {
+        return closest;
+    }
+
+    const myMath::Vector2D& position = ecsCoordinator.getComponent<TransformComponent>(body).position;
+    float closestDistance = closestPlatformEntity == body ? std::numeric_limits<float>::max() : distanceToOBB(position, closest);
+
+    for (auto& entity : tilemapEntities)
+    {
+        if (!ecsCoordinator.hasComponent<TilemapComponent>(entity))
+        {
+            continue;
+        }
+
+        const TilemapComponent& tilemap = ecsCoordinator.getComponent<TilemapComponent>(entity);
+        const myMath::Vector2D& origin = ecsCoordinator.getComponent<TransformComponent>(entity).position;
+        myMath::Vector2D reach(radius + tilemap.tileSize, radius + tilemap.tileSize);
+
+        surfaceTiles.clear();
+        Tilemap::QuerySolidTiles(tilemap, origin, { position - reach, position + reach }, surfaceTiles);
+        for (auto& tile : surfaceTiles)
+        {
+            CollisionSystemECS::OBB tileOBB = collisionSystem.createOBB((tile.min + tile.max) * 0.5f, (tile.max - tile.min) * 0.5f, 0.f);
+            float distance = distanceToOBB(position, tileOBB);
+            if (distance < closestDistance)
+            {
+                closestDistance = distance;
+                closest = tileOBB;
+            }
+        }
+    }
+
+    return closest;
+}
+
+CollisionSystemECS::OBB PhysicsSystemECS::getPlatformOBB(Entity platform)
+{
+    int shapeIndex = staticWorld.getShapeOf(platform);
+    if (shapeIndex < 0)
+    {
+        return collisionSystem.createOBBFromEntity(platform);
+    }
+
+    const StaticCollisionWorld::Shape& shape = staticWorld.getShape(static_cast<size_t>(shapeIndex));
+    return collisionSystem.createOBB(shape.center, shape.halfExtents, shape.rotation);
+}
+
+SpatialGrid::Bounds PhysicsSystemECS::getEntityBounds(Entity entity)
+{
+    if (!ecsCoordinator.hasComponent<ColliderComponent>(entity))
+    {
+        auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+        float rotation = transform.orientation.GetX() * (M_PI / 180.0f);
+        float cosValue = std::fabs(std::cos(rotation));
+        float sinValue = std::fabs(std::sin(rotation));
+        float halfWidth = std::fabs(transform.scale.GetX()) * 0.5f;
+        float halfHeight = std::fabs(transform.scale.GetY()) * 0.5f;
+
+        myMath::Vector2D extent(cosValue * halfWidth + sinValue * halfHeight, sinValue * halfWidth + cosValue * halfHeight);
+        return { transform.position - extent, transform.position + extent };
+    }
+
+    SpatialGrid::Bounds bounds{};
+    collisionSystem.getShapeBounds(collisionSystem.createShapeFromEntity(entity), bounds.min, bounds.max);
+    return bounds;
+}
+
+// Bodies without a round collider keep using half their width, as they always have
+float PhysicsSystemECS::getBodyRadius(Entity entity) const
+{
+    if (ecsCoordinator.hasComponent<ColliderComponent>(entity))
+    {
+        auto& collider = ecsCoordinator.getComponent<ColliderComponent>(entity);
+        if (collider.shape == ColliderShape::CIRCLE || collider.shape == ColliderShape::CAPSULE)
+        {
+            return collider.GetRadius(ecsCoordinator.getComponent<TransformComponent>(entity).scale);
+        }
+    }
+    return ecsCoordinator.getComponent<TransformComponent>(entity).scale.GetX() * 0.5f;
+}
+
+CollisionSystemECS::Shape PhysicsSystemECS::getBodyShape(Entity entity)
+{
+    if (ecsCoordinator.hasComponent<ColliderComponent>(entity))
+    {
+        return collisionSystem.createShapeFromEntity(entity);
+    }
+    return collisionSystem.createCircleShape(ecsCoordinator.getComponent<TransformComponent>(entity).position, getBodyRadius(entity));
+}
+
+float PhysicsSystemECS::getBoundingRadius(Entity entity) const
+{
+    auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+    if (!ecsCoordinator.hasComponent<ColliderComponent>(entity))
+    {
+        return std::max(transform.scale.GetX(), transform.scale.GetY()) * 0.5f;
+    }
+
+    auto& collider = ecsCoordinator.getComponent<ColliderComponent>(entity);
+    float extent = 0.f;
+    switch (collider.shape)
+    {
+    case ColliderShape::CIRCLE:
+        extent = collider.GetRadius(transform.scale);
+        break;
+    case ColliderShape::CAPSULE:
+        extent = collider.halfLength + collider.GetRadius(transform.scale);
+        break;
+    case ColliderShape::OBB:
+        extent = myMath::LengthVector2D(collider.halfExtents);
+        break;
+    case ColliderShape::POLYGON:
+        for (int i = 0; i < std::min(collider.vertexCount, MAX_POLYGON_VERTICES); i++)
+        {
+            extent = std::max(extent, myMath::LengthVector2D(collider.vertices[i]));
+        }
+        break;
+    default:
+        break;
+    }
+    return extent + myMath::LengthVector2D(collider.offset);
+}
+
+bool PhysicsSystemECS::passesQuery(Entity entity, const QueryFilter& filter) const
+{
+    // The grids are only refreshed between steps, skip anything destroyed since
+    if (entities.find(entity) == entities.end())
+    {
+        return false;
+    }
+    return !filter || filter(entity);
+}
+
+// Only bodies are moved by the steps and by behaviours, and only screen
+// entities are resized by hovering, so between rebuilds only those two
+// lists are moved in the grids
+void PhysicsSystemECS::RefreshBroadphase()
+{
+    if (broadphaseFrame == GLFWFunctions::frameNumber && broadphaseStep == movedSteps)
+    {
+        return;
+    }
+    broadphaseFrame = GLFWFunctions::frameNumber;
+    broadphaseStep = movedSteps;
+
+    refreshBodyLists();
+    if (!broadphaseDirty && broadphase.getCellSize() == broadphaseCellSize)
+    {
+        for (auto& entity : dynamicBodies)
+        {
+            broadphase.update(entity, getEntityBounds(entity));
+        }
+        for (auto& entity : screenEntities)
+        {
+            screenBroadphase.update(entity, getEntityBounds(entity));
+        }
+        return;
+    }
+    broadphaseDirty = false;
+
+    broadphase.setCellSize(broadphaseCellSize);
+    screenBroadphase.setCellSize(broadphaseCellSize);
+
+    std::vector<Entity> tracked;
+    broadphase.getEntities(tracked);
+    for (auto& entity : tracked)
+    {
+        if (entities.find(entity) == entities.end() || !ecsCoordinator.hasComponent<TransformComponent>(entity) || IsScreenSpace(entity))
+        {
+            broadphase.remove(entity);
+        }
+    }
+
+    tracked.clear();
+    screenBroadphase.getEntities(tracked);
+    for (auto& entity : tracked)
+    {
+        if (entities.find(entity) == entities.end() || !ecsCoordinator.hasComponent<TransformComponent>(entity) || !IsScreenSpace(entity))
+        {
+            screenBroadphase.remove(entity);
+        }
+    }
+
+    for (auto& entity : entities)
+    {
+        if (ecsCoordinator.hasComponent<TransformComponent>(entity))
+        {
+            SpatialGrid& grid = IsScreenSpace(entity) ? screenBroadphase : broadphase;
+            grid.update(entity, getEntityBounds(entity));
+        }
+    }
+}
+
+bool PhysicsSystemECS::IsScreenSpace(Entity entity)
+{
+    return ecsCoordinator.hasComponent<ButtonComponent>(entity) ||
+           ecsCoordinator.hasComponent<UIComponent>(entity) ||
+           ecsCoordinator.hasComponent<FontComponent>(entity);
+}
+
+void PhysicsSystemECS::QueryScreenPoint(const myMath::Vector2D& point, std::vector<Entity>& results, const QueryFilter& filter)
+{
+    RefreshBroadphase();
+
+    std::vector<Entity> candidates;
+    screenBroadphase.queryRegion({ point, point }, candidates);
+
+    for (auto& entity : candidates)
+    {
+        if (passesQuery(entity, filter) && collisionSystem.containsPoint(collisionSystem.createOBBFromEntity(entity), point))
+        {
+            results.push_back(entity);
+        }
+    }
+}
+
+void PhysicsSystemECS::QueryScreenRegion(const myMath::Vector2D& min, const myMath::Vector2D& max, std::vector<Entity>& results, const QueryFilter& filter)
+{
+    RefreshBroadphase();
+
+    std::vector<Entity> candidates;
+    screenBroadphase.queryRegion({ min, max }, candidates);
+
+    for (auto& entity : candidates)
+    {
+        if (passesQuery(entity, filter))
+        {
+            results.push_back(entity);
+        }
+    }
+}
+
+bool PhysicsSystemECS::Raycast(const myMath::Vector2D& origin, const myMath::Vector2D& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter)
+{
+    RefreshBroadphase();
+
+    myMath::Vector2D dir{};
+    myMath::NormalizeVector2D(dir, direction);
+    myMath::Vector2D end = origin + dir * maxDistance;
+
+    std::vector<Entity> candidates;
+    broadphase.querySegment(origin, end, candidates);
+
+    bool hasHit = false;
+    hit.distance = maxDistance;
+
+    for (auto& entity : candidates)
+    {
+        if (!passesQuery(entity, filter))
+        {
+            continue;
+        }
+
+        CollisionSystemECS::OBB obb = collisionSystem.createOBBFromEntity(entity);
+        float distance{};
+        myMath::Vector2D normal{};
+
+        if (collisionSystem.raycastOBB(origin, dir, hit.distance, obb, distance, normal))
+        {
+            hit.entity = entity;
+            hit.distance = distance;
+            hit.normal = normal;
+            hit.point = origin + dir * distance;
+            hasHit = true;
+        }
+    }
+
+    return hasHit;
+}
+
+void PhysicsSystemECS::QueryPoint(const myMath::Vector2D& point, std::vector<Entity>& results, const QueryFilter& filter)
+{
+    RefreshBroadphase();
+
+    std::vector<Entity> candidates;
+    broadphase.queryRegion({ point, point }, candidates);
+
+    for (auto& entity : candidates)
+    {
+        if (passesQuery(entity, filter) && collisionSystem.containsPoint(collisionSystem.createOBBFromEntity(entity), point))
+        {
+            results.push_back(entity);
+        }
+    }
+}
+
+// Bounds-only query, for callers that do their own exact test
+void PhysicsSystemECS::QueryRegion(const myMath::Vector2D& min, const myMath::Vector2D& max, std::vector<Entity>& results, const QueryFilter& filter)
+{
+    RefreshBroadphase();
+
+    std::vector<Entity> candidates;
+    broadphase.queryRegion({ min, max }, candidates);
+
+    for (auto& entity : candidates)
+    {
+        if (passesQuery(entity, filter))
+        {
+            results.push_back(entity);
+        }
+    }
+}
+
+void PhysicsSystemECS::OverlapCircle(const myMath::Vector2D& center, float radius, std::vector<Entity>& results, const QueryFilter& filter)
+{
+    OverlapShape(collisionSystem.createCircleShape(center, radius), results, filter);
+}
+
+void PhysicsSystemECS::OverlapOBB(const CollisionSystemECS::OBB& obb, std::vector<Entity>& results, const QueryFilter& filter)
+{
+    OverlapShape(collisionSystem.createOBBShape(obb), results, filter);
+}
+
+// Each candidate is tested as its own collider shape
+void PhysicsSystemECS::OverlapShape(const CollisionSystemECS::Shape& shape, std::vector<Entity>& results, const QueryFilter& filter)
+{
+    RefreshBroadphase();
+
+    SpatialGrid::Bounds bounds{};
+    collisionSystem.getShapeBounds(shape, bounds.min, bounds.max);
+
+    std::vector<Entity> candidates;
+    broadphase.queryRegion(bounds, candidates);
+
+    for (auto& entity : candidates)
+    {
+        if (!passesQuery(entity, filter))
+        {
+            continue;
+        }
+
+        myMath::Vector2D normal{};
+        float penetration{};
+        if (collisionSystem.collide(shape, collisionSystem.createShapeFromEntity(entity), normal, penetration))
+        {
+            results.push_back(entity);
+        }
+    }
+}
+
+// Searches outwards ring by ring. Every entity is registered in each cell its
+// bounds overlap, which always includes the cell holding its center. So once
+// ring r has been searched, anything not seen yet has its center more than r
+// cells away and the search can stop when the k-th best is closer.
+void PhysicsSystemECS::KNearest(const myMath::Vector2D& point, size_t k, std::vector<Entity>& results, const QueryFilter& filter)
+{
+    RefreshBroadphase();
+
+    if (k == 0)
+    {
+        return;
+    }
+
+    std::vector<std::pair<float, Entity>> best;
+    std::unordered_set<Entity> seen;
+    std::vector<Entity> ringEntities;
+    int ringLimit = broadphase.getRingLimit(point);
+
+    for (int ring = 0; ring <= ringLimit; ring++)
+    {
+        ringEntities.clear();
+        broadphase.queryRing(point, ring, ringEntities);
+
+        for (auto& entity : ringEntities)
+        {
+            if (!seen.insert(entity).second || !passesQuery(entity, filter))
+            {
+                continue;
+            }
+
+            const myMath::Vector2D& position = ecsCoordinator.getComponent<TransformComponent>(entity).position;
+            best.push_back({ myMath::SquareDistanceVector2D(point, position), entity });
+        }
+
+        std::sort(best.begin(), best.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        if (best.size() > k)
+        {
+            best.resize(k);
+        }
+
+        float reach = static_cast<float>(ring) * broadphase.getCellSize();
+        if (best.size() == k && best.back().first <= reach * reach)
+        {
+            break;
+        }
+    }
+
+    for (auto& entry : best)
+    {
+        results.push_back(entry.second);
+    }
+}
+
+// Advance the simulation by a single fixed step
+void PhysicsSystemECS::step(float fixedDt)
+{
+    stepStats.steps++;
+
+    // Every body sleeps and no field changed, so there is nothing to move
+    if (islandsIdle)
+    {
+        return;
+    }
+
+    gatherForceFields();
+
+    std::vector<Entity> movers;
+    for (auto& entity : dynamicBodies)
+    {
+        // Nothing to simulate for a sleeping body, its island wakes it when needed
+        bool isMover = ecsCoordinator.hasComponent<PlayerComponent>(entity) || ecsCoordinator.hasComponent<EnemyComponent>(entity);
+        if (isMover && !IsSleeping(entity)) {
+            movers.push_back(entity);
+        }
+    }
+
+    prepareSolverBodies(movers);
+
+    auto parallelStart = std::chrono::steady_clock::now();
+
+    workerScratch.resize(workerPool.getWorkerCount());
+    for (auto& scratch : workerScratch)
+    {
+        scratch.contacts.clear();
+        scratch.broadphasePairs = 0;
+        scratch.narrowphaseTests = 0;
+    }
+
+    // Every body's forces are accumulated and integrated in one pass
+    workerPool.parallelFor(solverBodies.size(), 32, [this, fixedDt](size_t begin, size_t end, size_t worker)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                applyForceFields(solverBodies[i], fixedDt, workerScratch[worker]);
+                integrateBody(solverBodies[i], fixedDt, workerScratch[worker]);
+            }
+        });
+
+    updateContactFlags();
+
+    // Levels without platforms or tiles still move their bodies, there is
+    // just nothing static to sweep against
+    if (staticWorld.getShapeCount() > 0)
+    {
+        workerPool.parallelFor(solverBodies.size(), 32, [this](size_t begin, size_t end, size_t worker)
+            {
+                for (size_t i = begin; i < end; i++)
+                {
+                    sweepBody(solverBodies[i], workerScratch[worker]);
+                }
+            });
+    }
+
+    detectContacts();
+    solveIslands();
+
+    // Bodies have moved, the next query rebuilds the broadphase
+    movedSteps++;
+
+    for (auto& scratch : workerScratch)
+    {
+        stepStats.broadphasePairs += scratch.broadphasePairs;
+        stepStats.narrowphaseTests += scratch.narrowphaseTests;
+    }
+
+    stepStats.parallelNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - parallelStart).count();
+}
+
+void PhysicsSystemECS::SetWorkerThreads(int count)
+{
+    workerThreads = std::max(count, 0);
+    workerPool.resize(static_cast<size_t>(workerThreads));
+}
+
+// Entities are visited in id order and floats are hashed by their bit
+// patterns, so any difference at all between two runs changes the hash.
+// Entities are identified by the id they are saved with, not the runtime
+// entity, which depends on what was created and destroyed before the load
+uint64_t PhysicsSystemECS::ComputeStateHash() const
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    auto mix = [&hash](const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    auto mixFloat = [&mix](float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        mix(&bits, sizeof(bits));
+    };
+
+    for (auto& entity : entities)
+    {
+        if (!ecsCoordinator.hasComponent<TransformComponent>(entity))
+        {
+            continue;
+        }
+
+        std::string id = ecsCoordinator.getEntityID(entity);
+        mix(id.data(), id.size());
+
+        auto& transform = ecsCoordinator.getComponent<TransformComponent>(entity);
+        mixFloat(transform.position.GetX());
+        mixFloat(transform.position.GetY());
+        mixFloat(transform.orientation.GetX());
+        mixFloat(transform.orientation.GetY());
+        mixFloat(transform.scale.GetX());
+        mixFloat(transform.scale.GetY());
+
+        if (ecsCoordinator.hasComponent<PhysicsComponent>(entity))
+        {
+            auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(entity);
+            mixFloat(physics.velocity.GetX());
+            mixFloat(physics.velocity.GetY());
+            mixFloat(physics.acceleration.GetX());
+            mixFloat(physics.acceleration.GetY());
+            mixFloat(physics.accumulatedForce.GetX());
+            mixFloat(physics.accumulatedForce.GetY());
+        }
+    }
+
+    return hash;
+}
+
+// Load physics config from JSON
+void PhysicsSystemECS::LoadPhysicsConfigFromJSON(std::string const& filename)
+{
+    JSONSerializer serializer;
+
+    // checks if the JSON file can be opened
+    if (!serializer.Open(filename))
+    {
+        Console::GetLog() << "Error: could not open file " << filename << std::endl;
+        return;
+    }
+
+    // retrieve the JSON object from the JSON file
+    nlohmann::json currentObj = serializer.GetJSONObject();
+
+    // read all of the data from the JSON object, assign every read
+    // data to every elements that needs to be initialized
+    serializer.ReadFloat(friction, "physics.friction");
+    serializer.ReadFloat(threshold, "physics.threshold");
+    serializer.ReadBool(alrJumped, "physics.alrJumped");
+    serializer.ReadBool(isFalling, "physics.isFalling");
+    serializer.ReadBool(isSliding, "physics.isSliding");
+    serializer.ReadFloat(fixedDeltaTime, "physics.fixedDeltaTime");
+    serializer.ReadInt(maxSubsteps, "physics.maxSubsteps");
+    serializer.ReadBool(deterministic, "physics.deterministic");
+    serializer.ReadFloat(ccdMotionThreshold, "physics.ccdMotionThreshold");
+    serializer.ReadFloat(sleepVelocityThreshold, "physics.sleepVelocityThreshold");
+    serializer.ReadInt(sleepStepCount, "physics.sleepStepCount");
+    serializer.ReadInt(solverIterations, "physics.solverIterations");
+    serializer.ReadFloat(baumgarte, "physics.baumgarte");
+    serializer.ReadFloat(penetrationSlop, "physics.penetrationSlop");
+    serializer.ReadFloat(contactFriction, "physics.contactFriction");
+    serializer.ReadFloat(steeringResponse, "physics.steeringResponse");
+    serializer.ReadFloat(broadphaseCellSize, "physics.broadphaseCellSize");
+    serializer.ReadInt(workerThreads, "physics.workerThreads");
+
+    if (fixedDeltaTime <= 0.f || maxSubsteps < 1)
+    {
+        Console::GetLog() << "Error: invalid physics timestep in " << filename << ", using 120Hz" << std::endl;
+        fixedDeltaTime = 1.f / 120.f;
+        maxSubsteps = 8;
+    }
 
+    SetWorkerThreads(workerThreads);
 }
 
 // Save physics config to JSON
@@ -519,6 +2991,19 @@ void PhysicsSystemECS::SavePhysicsConfigFromJSON(std::string const& filename)
     serializer.WriteBool(alrJumped, "physics.alrJumped", filename);
     serializer.WriteBool(isFalling, "physics.isFalling", filename);
     serializer.WriteBool(isSliding, "physics.isSliding", filename);
+    serializer.WriteFloat(fixedDeltaTime, "physics.fixedDeltaTime", filename);
+    serializer.WriteInt(maxSubsteps, "physics.maxSubsteps", filename);
+    serializer.WriteBool(deterministic, "physics.deterministic", filename);
+    serializer.WriteFloat(ccdMotionThreshold, "physics.ccdMotionThreshold", filename);
+    serializer.WriteFloat(sleepVelocityThreshold, "physics.sleepVelocityThreshold", filename);
+    serializer.WriteInt(sleepStepCount, "physics.sleepStepCount", filename);
+    serializer.WriteInt(solverIterations, "physics.solverIterations", filename);
+    serializer.WriteFloat(baumgarte, "physics.baumgarte", filename);
+    serializer.WriteFloat(penetrationSlop, "physics.penetrationSlop", filename);
+    serializer.WriteFloat(contactFriction, "physics.contactFriction", filename);
+    serializer.WriteFloat(steeringResponse, "physics.steeringResponse", filename);
+    serializer.WriteFloat(broadphaseCellSize, "physics.broadphaseCellSize", filename);
+    serializer.WriteInt(workerThreads, "physics.workerThreads", filename);
 
 }
 
@@ -14,6 +14,15 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 #include "ECSCoordinator.h"
 #include "vector2D.h"
 #include "Force.h"
+#include "TransformComponent.h"
+#include "ColliderComponent.h"
+#include "ForceFieldComponent.h"
+#include "SpatialGrid.h"
+#include "StaticCollisionWorld.h"
+#include "WorkerPool.h"
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 class CollisionSystemECS
 {
@@ -30,6 +39,9 @@ public:
 	// Create OBB from entity
     OBB createOBBFromEntity(Entity entity);
 
+    // Create OBB from a center, half extents and rotation in radians
+    OBB createOBB(const myMath::Vector2D& center, const myMath::Vector2D& halfExtents, float rotation);
+
     // Project point onto axis
     float projectPoint(const myMath::Vector2D& point, const myMath::Vector2D& axis);
     
@@ -46,8 +58,65 @@ public:
 
     bool checkOBBCollisionSAT(const OBB& obb1, const OBB& obb2, myMath::Vector2D& normal, float& penetration);
 
+    // Swept circle vs OBB. On a hit, toi is the fraction of start->end travelled
+    // before first contact and normal points from the OBB towards the circle
+    bool sweepCircleOBB(const myMath::Vector2D& start, const myMath::Vector2D& end, float radius, const OBB& obb, float& toi, myMath::Vector2D& normal);
+
+    // Ray vs OBB, direction must be normalized. distance is along the ray
+    bool raycastOBB(const myMath::Vector2D& origin, const myMath::Vector2D& direction, float maxDistance, const OBB& obb, float& distance, myMath::Vector2D& normal);
+
+    // Point inside OBB test
+    bool containsPoint(const OBB& obb, const myMath::Vector2D& point);
+
     // Collision response for OBB
     void CollisionResponse(Entity player, myMath::Vector2D normal, float penetration);
+    void CollisionResponse(TransformComponent& transform, PhysicsComponent& physics, const myMath::Vector2D& normal, float penetration);
+
+    // A collider placed in the world. OBBs keep their OBB and also fill the
+    // vertices so they can be tested as a polygon
+    struct Shape {
+        ColliderShape type;
+        myMath::Vector2D center;
+        float radius;                   // circle and capsule
+        myMath::Vector2D segment[2];    // capsule core segment
+        OBB obb;                        // OBB
+        int vertexCount;                // OBB and polygon, counter clockwise
+        myMath::Vector2D vertices[MAX_POLYGON_VERTICES];
+    };
+
+    // World shape of an entity's collider, or of its transform OBB when it has none
+    Shape createShapeFromEntity(Entity entity);
+    Shape createCircleShape(const myMath::Vector2D& center, float radius);
+    Shape createOBBShape(const OBB& obb);
+
+    // Axis aligned bounds of a world shape
+    void getShapeBounds(const Shape& shape, myMath::Vector2D& min, myMath::Vector2D& max);
+
+    // Narrowphase for any pair of shapes, looked up in the shape pair dispatch
+    // table. On a hit the normal points from b towards a, so moving a along it
+    // by the penetration separates the two
+    bool collide(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+
+private:
+    // Specialised narrowphase functions, each expects its shapes in the order
+    // of its name. The dispatch table swaps the arguments for reversed pairs
+    bool circleCircle(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+    bool circleOBB(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+    bool circleCapsule(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+    bool circlePolygon(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+    bool obbOBB(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+    bool capsuleCapsule(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+    bool capsuleConvex(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+    bool convexConvex(const Shape& a, const Shape& b, myMath::Vector2D& normal, float& penetration);
+
+    using NarrowphaseFn = bool (CollisionSystemECS::*)(const Shape&, const Shape&, myMath::Vector2D&, float&);
+
+    struct DispatchEntry {
+        NarrowphaseFn fn;
+        bool swapped;
+    };
+
+    static const DispatchEntry dispatchTable[static_cast<int>(ColliderShape::COUNT)][static_cast<int>(ColliderShape::COUNT)];
 };
 
 class PhysicsSystemECS : public System
@@ -61,6 +130,9 @@ public:
 
     std::string getSystemECS() override;
 
+    // Marks the cached body, field and trigger lists for a rebuild
+    void entityChanged(Entity entity) override;
+
     // Getters and Setters
     bool GetAlrJumped() const { return alrJumped; }
     void SetAlrJumped(bool newAlrJumped) { alrJumped = newAlrJumped; }
@@ -69,12 +141,116 @@ public:
 
     bool getIsColliding() const { return isColliding; }
 
+    // Fixed timestep the simulation advances by, and how far the renderer is
+    // between the last two steps (0 = previous step, 1 = current step)
+    static float GetFixedDeltaTime() { return fixedDeltaTime; }
+    float GetInterpolationAlpha() const { return interpolationAlpha; }
+
+    // Deterministic mode runs exactly one fixed step per update no matter how
+    // long the frame took, so the same inputs always give the same results
+    static bool IsDeterministic() { return deterministic; }
+    static void SetDeterministic(bool enable) { deterministic = enable; }
+
+    // Forget all per-body simulation state (contacts, islands, interpolation),
+    // used when a scene is reloaded underneath the system
+    void ResetSimulation();
+
+    // FNV-1a hash over the exact bits of every body's transform and motion,
+    // for checking a replay ended in the same state as the recording
+    uint64_t ComputeStateHash() const;
+
+    // Advance the simulation by exactly one fixed step
+    void step(float fixedDt);
+
+    // Position to render an entity at, blended between the last two physics steps
+    myMath::Vector2D getInterpolatedPosition(Entity entity, const TransformComponent& transform) const;
+
+    size_t GetContactCount() const { return contactCache.size() + bodyContactCache.size(); }
+
+    // Threads the narrowphase and island solver are split across, including
+    // the one running the update. 0 uses one per hardware thread
+    static int GetWorkerThreads() { return workerThreads; }
+    void SetWorkerThreads(int count);
+    size_t GetWorkerCount() const { return workerPool.getWorkerCount(); }
+
+    // Work done by the steps since the counters were last reset
+    struct StepStats {
+        size_t steps;
+        size_t broadphasePairs;
+        size_t narrowphaseTests;
+        size_t contacts;
+        double parallelNs;      // time spent in the multithreaded contact phases
+    };
+
+    const StepStats& GetStepStats() const { return stepStats; }
+    void ResetStepStats() { stepStats = {}; }
+
+    // Result of a raycast against the world
+    struct RaycastHit {
+        Entity entity;
+        myMath::Vector2D point;
+        myMath::Vector2D normal;
+        float distance;
+    };
+
+    // Optional predicate that limits which entities a query reports
+    using QueryFilter = std::function<bool(Entity)>;
+
+    // Spatial queries over every world entity with a transform, backed by the
+    // broadphase grid. Overlaps test each entity's collider, raycasts and
+    // point queries treat entities as their OBB. Results are appended to the
+    // output vector
+    bool Raycast(const myMath::Vector2D& origin, const myMath::Vector2D& direction, float maxDistance, RaycastHit& hit, const QueryFilter& filter = nullptr);
+    void QueryPoint(const myMath::Vector2D& point, std::vector<Entity>& results, const QueryFilter& filter = nullptr);
+    void QueryRegion(const myMath::Vector2D& min, const myMath::Vector2D& max, std::vector<Entity>& results, const QueryFilter& filter = nullptr);
+    void OverlapCircle(const myMath::Vector2D& center, float radius, std::vector<Entity>& results, const QueryFilter& filter = nullptr);
+    void OverlapOBB(const CollisionSystemECS::OBB& obb, std::vector<Entity>& results, const QueryFilter& filter = nullptr);
+    void OverlapShape(const CollisionSystemECS::Shape& shape, std::vector<Entity>& results, const QueryFilter& filter = nullptr);
+
+    // The k entities whose centers are closest to the point, nearest first
+    void KNearest(const myMath::Vector2D& point, size_t k, std::vector<Entity>& results, const QueryFilter& filter = nullptr);
+
+    // Buttons, UI and text are placed in screen coordinates centered on the
+    // window, so they are kept in a grid of their own and only these two
+    // queries see them
+    static bool IsScreenSpace(Entity entity);
+    void QueryScreenPoint(const myMath::Vector2D& point, std::vector<Entity>& results, const QueryFilter& filter = nullptr);
+    void QueryScreenRegion(const myMath::Vector2D& min, const myMath::Vector2D& max, std::vector<Entity>& results, const QueryFilter& filter = nullptr);
+
+    // Bring the broadphase up to date with the transforms. Queries call this
+    // themselves. The grid is only rebuilt after entities change or are edited,
+    // otherwise the dynamic bodies and screen entities are moved once per
+    // frame and after every step that moved bodies
+    void RefreshBroadphase();
+
+    const SpatialGrid& getBroadphase() const { return broadphase; }
+
+    // Bake the platforms of a freshly loaded scene, reusing the collision
+    // cache stored next to the scene file when it is still valid
+    void LoadStaticCollision(std::string const& scenePath);
+
+    // Rebake the static collision if the platforms changed since the last bake.
+    // They are only compared again once marked dirty or the entity count changed
+    void RefreshStaticCollision();
+
+    // Platforms and tilemaps are static. Mark them dirty after moving, resizing
+    // or turning one, or changing its solid tiles, from outside the system
+    void MarkStaticCollisionDirty() { staticCollisionDirty = true; }
+
+    // Marks the static collision dirty when the edited entity is part of it,
+    // and the broadphase for any entity
+    void NotifyTransformEdited(Entity entity);
+
+    const StaticCollisionWorld& getStaticWorld() const { return staticWorld; }
+
+    // Wake a sleeping body together with the rest of its island
+    void WakeBody(Entity entity);
+
+    bool IsSleeping(Entity entity) const;
+
 	// Find closest platform to player
     Entity FindClosestPlatform(Entity player);
 
-    // Handle OBB collision
-    void HandleCircleOBBCollision(Entity player, Entity platform);
-
     // Calculate the directional vector based on the orientation of player
     myMath::Vector2D directionalVector(float angle);
 
@@ -89,6 +265,283 @@ public:
 
 
 private:
+    // Positions of a physics body at the start and end of the last fixed step
+    struct InterpolationState {
+        myMath::Vector2D prevPosition;
+        myMath::Vector2D currPosition;
+    };
+
+    void storePreviousTransforms();
+    void storeCurrentTransforms();
+
+    // Dynamic bodies are bodies with physics that are not platforms
+    bool isDynamicBody(Entity entity) const;
+
+    // Sort the entities into the lists the per-step passes walk, so they never
+    // go through every entity. Only runs after an entity changed
+    void refreshBodyLists();
+
+    // Group touching dynamic bodies into islands and wake any island that was
+    // disturbed since it went to sleep. Skipped while every body sleeps
+    void buildIslands();
+
+    // A sleeping body that was moved or turned from outside since it fell asleep
+    bool isDisturbed(Entity body) const;
+
+    // Count idle steps per body and put islands that stayed still to sleep
+    void updateSleepState();
+
+    // Test trigger volumes against the moving bodies and send enter, stay and
+    // exit events to the trigger behaviours
+    void updateTriggers();
+
+    // Axis aligned bounds of an entity's collider, used by the broadphase
+    SpatialGrid::Bounds getEntityBounds(Entity entity);
+
+    // Radius of a dynamic body, stored on its circle or capsule collider
+    float getBodyRadius(Entity entity) const;
+
+    // Shape a dynamic body moves as, a circle unless its collider says otherwise
+    CollisionSystemECS::Shape getBodyShape(Entity entity);
+
+    // Radius of a circle around the body's center that holds its whole collider
+    float getBoundingRadius(Entity entity) const;
+
+    // Entities that are still alive and pass the filter
+    bool passesQuery(Entity entity, const QueryFilter& filter) const;
+
+    // Static collision box of a platform, falls back to the platform's own OBB
+    // before the first bake
+    CollisionSystemECS::OBB getPlatformOBB(Entity platform);
+
+    // Closest surface to a body, its closest platform or a solid tile of a
+    // tilemap within reach, as the box that pushes it along and gates its jump
+    CollisionSystemECS::OBB findClosestSurface(Entity body, float radius);
+
+    // Gather the awake bodies of this step and group them by island
+    void prepareSolverBodies(const std::vector<Entity>& bodies);
+
+    // Test every body against the static shapes near it and against the other
+    // bodies of its island on the worker pool, then merge the contacts into
+    // the caches in key order
+    void detectContacts();
+
+    // Solve the contacts of each island on the worker pool
+    void solveIslands();
+
+    // Raise the platform contact flags of the bodies integrated this step
+    void updateContactFlags();
+
+    // Contact between a dynamic body and a baked static shape, kept across
+    // steps so the solver can start from the impulses it finished with last step
+    struct ContactManifold {
+        Entity body;
+        Entity shape;
+        myMath::Vector2D normal;
+        float penetration;
+        float normalImpulse;
+        float tangentImpulse;
+        bool touched;
+    };
+
+    // Contact between two dynamic bodies of the same island, kept across steps
+    // like the static contacts. The normal pushes bodyA away from bodyB
+    struct BodyContact {
+        Entity bodyA;
+        Entity bodyB;
+        size_t solverA;     // solver bodies of this step
+        size_t solverB;
+        myMath::Vector2D normal;
+        float penetration;
+        float normalImpulse;
+        float tangentImpulse;
+        bool touched;
+    };
+
+    // Where a sleeping body was when it fell asleep, to notice outside changes
+    struct SleepSnapshot {
+        myMath::Vector2D position;
+        myMath::Vector2D orientation;
+    };
+
+    // Placement of a field or trigger when it was last looked at, so idle
+    // steps and frames can tell whether anything needs testing again
+    struct VolumeSnapshot {
+        Entity entity;
+        myMath::Vector2D position;
+        myMath::Vector2D orientation;
+        myMath::Vector2D scale;
+        ForceFieldComponent field;
+    };
+
+    static VolumeSnapshot takeVolumeSnapshot(Entity entity);
+    static bool volumeChanged(const VolumeSnapshot& snapshot);
+
+    // Dynamic body as the contact phases see it. Components are looked up
+    // before the worker threads start, so they never go through the ECS
+    struct SolverBody {
+        Entity entity;
+        TransformComponent* transform;
+        PhysicsComponent* physics;
+        float radius;
+        myMath::Vector2D startPosition;
+        CollisionSystemECS::OBB platformOBB;    // closest platform, pushes the body along
+        bool hasSurface;                        // platformOBB is set, never in a level without static collision
+        bool touchingPlatform;
+        bool steered;                           // moved only by steering forces, e.g. enemies
+        uint8_t fieldKind;                      // ForceFieldAffects flag fields check against
+        CollisionSystemECS::Shape shape;
+        std::vector<ContactManifold*> contacts;
+        float invMass;
+    };
+
+    // A body and a static shape whose bounds overlap
+    struct ContactPair {
+        size_t body;
+        Entity shape;
+    };
+
+    // A touching pair found by the narrowphase
+    struct ContactPoint {
+        uint64_t key;
+        size_t body;
+        Entity shape;
+        myMath::Vector2D normal;
+        float penetration;
+    };
+
+    // Two touching bodies found by the narrowphase, bodyA has the lower entity
+    struct BodyContactPoint {
+        uint64_t key;
+        size_t bodyA;
+        size_t bodyB;
+        myMath::Vector2D normal;
+        float penetration;
+    };
+
+    // Bounds of a body along x for the sweep that pairs up an island
+    struct BodySpan {
+        SpatialGrid::Bounds bounds;
+        size_t body;
+    };
+
+    // Output of one worker, kept between steps to reuse the memory
+    struct WorkerScratch {
+        std::vector<ContactPoint> contacts;
+        std::vector<Entity> fields;
+        std::vector<BodySpan> spans;
+        size_t broadphasePairs;
+        size_t narrowphaseTests;
+    };
+
+    // A force field placed in the world for the current step
+    struct FieldState {
+        ForceFieldType type;
+        ForceFieldFalloff falloff;
+        float strength;
+        float radius;
+        myMath::Vector2D center;
+        CollisionSystemECS::OBB obb;        // area of a directional field
+        myMath::Vector2D direction;         // push of a directional field
+        float reach;                        // half the field's depth along the push
+        uint8_t affects;                    // ForceFieldAffects flags of the bodies pushed
+    };
+
+    // Place the enabled force fields in the field grid and wake the bodies
+    // they push that are sleeping inside them
+    void gatherForceFields();
+
+    // A field was added, removed, moved or changed since the last gather
+    bool fieldsChanged() const;
+
+    // ForceFieldAffects flag of the kind of body the entity is
+    static uint8_t getFieldKind(Entity body);
+
+    // Push a body gets from every field its collider reaches
+    void applyForceFields(SolverBody& body, float dt, WorkerScratch& scratch);
+
+    static myMath::Vector2D sampleForceField(const FieldState& field, const myMath::Vector2D& point, float bodyRadius);
+
+    // Forces and integration of one body against its closest platform
+    void integrateBody(SolverBody& body, float dt, WorkerScratch& scratch);
+
+    // Integration of a body steered towards its desired velocity instead of
+    // driven by the player controls. The steering force is worked out every step
+    static void integrateSteeredBody(SolverBody& body, float dt);
+
+    // Stop the body at the first platform it swept through during this step
+    void sweepBody(SolverBody& body, WorkerScratch& scratch);
+
+    // Pair up the overlapping bodies of one solver island
+    void detectBodyContacts(size_t job, WorkerScratch& scratch);
+
+    // Resolve every contact of one island with warm-started impulses
+    void solveIsland(size_t job);
+
+    static float fixedDeltaTime;
+    static int maxSubsteps;
+    static bool deterministic;
+    static float ccdMotionThreshold;
+    static float sleepVelocityThreshold;
+    static int sleepStepCount;
+    static int solverIterations;
+    static float baumgarte;
+    static float penetrationSlop;
+    static float contactFriction;   // Coulomb friction of the contact solver, 0 keeps sliding as before
+    static float steeringResponse;  // how quickly steered bodies close the gap to their desired velocity, per second
+    std::unordered_map<uint64_t, ContactManifold> contactCache;
+    std::vector<SolverBody> solverBodies;
+    std::vector<std::vector<size_t>> solverIslands;
+    std::unordered_map<uint64_t, BodyContact> bodyContactCache;
+    std::vector<std::vector<BodyContactPoint>> islandContactPoints;     // per solver island, filled by the workers
+    std::vector<std::vector<BodyContact*>> islandContacts;              // per solver island
+    std::vector<ContactPair> contactPairs;
+    std::vector<WorkerScratch> workerScratch;
+    static int workerThreads;
+    WorkerPool workerPool;
+    SpatialGrid islandGrid;
+    std::vector<FieldState> fieldStates;
+    SpatialGrid fieldGrid;
+    StepStats stepStats;
+    std::unordered_set<uint64_t> triggerOverlaps;
+    std::vector<uint64_t> triggerOrder;             // overlaps in the order their events went out
+    std::vector<VolumeSnapshot> triggerSnapshots;
+    std::vector<VolumeSnapshot> fieldSnapshots;
+    unsigned long long triggerStep;                 // movedSteps when the triggers were last tested
+    unsigned long long triggerListsVersion;         // body lists the triggers were last tested with
+    std::vector<Entity> physicsBodies;              // every entity with physics, platforms included
+    std::vector<Entity> dynamicBodies;
+    std::vector<Entity> triggerBodies;              // dynamic bodies that are not triggers themselves
+    std::vector<Entity> forceFieldEntities;
+    std::vector<Entity> triggerEntities;
+    std::vector<Entity> screenEntities;
+    bool bodyListsDirty;
+    unsigned long long bodyListsVersion;            // bumped on every rebuild of the lists
+    static float broadphaseCellSize;
+    SpatialGrid broadphase;
+    SpatialGrid screenBroadphase;
+    unsigned long long broadphaseFrame;
+    unsigned long long broadphaseStep;      // movedSteps when the broadphase was last refreshed
+    bool broadphaseDirty;                   // entities changed or were edited, rebuild the whole grid
+    unsigned long long movedSteps;          // steps that integrated bodies, never reset
+    StaticCollisionWorld staticWorld;
+    std::string staticCachePath;
+    bool staticCollisionDirty;
+    size_t staticEntityCount;       // entity count when the platforms were last compared
+    std::vector<Entity> tilemapEntities;            // tilemaps found by the last compare
+    std::vector<SpatialGrid::Bounds> surfaceTiles;  // scratch for findClosestSurface
+    std::vector<std::vector<Entity>> islands;
+    std::unordered_map<Entity, size_t> islandOfBody;
+    std::unordered_map<Entity, SleepSnapshot> sleepSnapshots;
+    size_t awakeBodyCount;          // bodies left awake by the last updateSleepState
+    unsigned long long islandListsVersion;  // body lists the islands were built from
+    bool islandsDirty;              // a body was woken since the islands were built
+    bool islandsIdle;               // this step found every body asleep and undisturbed
+    float accumulator;
+    float interpolationAlpha;
+    bool interpolationSettled;      // previous and current states match while every body sleeps
+    std::unordered_map<Entity, InterpolationState> interpolationStates;
+
     static float friction;
     static float threshold;
     static bool alrJumped;
@@ -0,0 +1,458 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   PhysicsBenchmark.cpp
+@brief:  This source file contains the implementation of the PhysicsBenchmark
+         class, the synthetic level generators and the JSON report.
+         Lee Jing Wen (jingwen.lee): Defined the PhysicsBenchmark class
+                                     100%
+*//*____________________________________________________________________________-*/
+
+#include "PhysicsBenchmark.h"
+#include "GlobalCoordinator.h"
+#include "PhyColliSystemECS.h"
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+    const unsigned int levelSeed = 12345u;
+    const float tileSize = 100.f;
+    const float bodyRadius = 25.f;
+
+    // The large grid is sized so its tiles and bodies fit in the ECS
+    const int largeGridPlatforms = 4000;
+    const int largeGridBodies = 16;
+    static_assert(largeGridPlatforms + largeGridBodies <= static_cast<int>(MAX_ENTITIES), "platform_grid_large needs more than MAX_ENTITIES entities");
+
+    // The worker scaling level, its ledges and bodies have to fit the same way
+    const int scatteredLedges = 1000;
+    const int scatteredBodies = 3500;
+    static_assert(scatteredLedges + scatteredBodies <= static_cast<int>(MAX_ENTITIES), "scattered_bodies needs more than MAX_ENTITIES entities");
+}
+
+std::vector<PhysicsBenchmark::Config> PhysicsBenchmark::getDefaultSuite()
+{
+    return {
+        { "platform_grid_small", Scenario::PLATFORM_GRID, 500, 1, 1200, 0 },
+        { "platform_grid_large", Scenario::PLATFORM_GRID, largeGridPlatforms, largeGridBodies, 600, 0 },
+        { "random_obbs", Scenario::RANDOM_OBBS, 1000, 16, 600, 0 },
+        { "dense_cluster", Scenario::DENSE_CLUSTER, 300, 64, 600, 0 },
+        { "body_crowd", Scenario::BODY_CROWD, 200, 256, 300, 0 },
+        { "force_fields", Scenario::FORCE_FIELDS, 200, 512, 300, 0, 100 },
+
+        // Same level on more and more workers
+        { "scattered_bodies", Scenario::SCATTERED_BODIES, scatteredLedges, scatteredBodies, 120, 1 },
+        { "scattered_bodies", Scenario::SCATTERED_BODIES, scatteredLedges, scatteredBodies, 120, 2 },
+        { "scattered_bodies", Scenario::SCATTERED_BODIES, scatteredLedges, scatteredBodies, 120, 4 },
+        { "scattered_bodies", Scenario::SCATTERED_BODIES, scatteredLedges, scatteredBodies, 120, 8 },
+        { "scattered_bodies", Scenario::SCATTERED_BODIES, scatteredLedges, scatteredBodies, 120, 16 }
+    };
+}
+
+void PhysicsBenchmark::createPlatform(float x, float y, float width, float height, float rotation)
+{
+    Entity entity = ecsCoordinator.createEntity();
+
+    TransformComponent transform{};
+    transform.position = myMath::Vector2D(x, y);
+    transform.scale = myMath::Vector2D(width, height);
+    transform.orientation = myMath::Vector2D(rotation, 0.f);
+    ecsCoordinator.addComponent(entity, transform);
+
+    ClosestPlatform platform{};
+    platform.isClosest = false;
+    ecsCoordinator.addComponent(entity, platform);
+}
+
+// Directional fields cover a tile wide column above their position, radial
+// and vortex fields a circle of their radius
+void PhysicsBenchmark::createField(float x, float y, const ForceFieldComponent& field)
+{
+    Entity entity = ecsCoordinator.createEntity();
+
+    TransformComponent transform{};
+    transform.position = myMath::Vector2D(x, y);
+    transform.scale = myMath::Vector2D(tileSize, tileSize * 4.f);
+    transform.orientation = myMath::Vector2D(0.f, 0.f);
+    ecsCoordinator.addComponent(entity, transform);
+
+    ecsCoordinator.addComponent(entity, field);
+}
+
+void PhysicsBenchmark::createBody(float x, float y, float radius)
+{
+    Entity entity = ecsCoordinator.createEntity();
+
+    TransformComponent transform{};
+    transform.position = myMath::Vector2D(x, y);
+    transform.scale = myMath::Vector2D(radius * 2.f, radius * 2.f);
+    transform.orientation = myMath::Vector2D(0.f, 0.f);
+    ecsCoordinator.addComponent(entity, transform);
+
+    PhysicsComponent physics{};
+    physics.gravityScale = myMath::Vector2D(0.f, -100.f);
+    physics.mass = 1.f;
+    physics.dampening = 0.9f;
+    physics.maxVelocity = 1000.f;
+    physics.maxAccumulatedForce = 1000.f;
+    ecsCoordinator.addComponent(entity, physics);
+
+    PlayerComponent player{};
+    player.isPlayer = true;
+    ecsCoordinator.addComponent(entity, player);
+}
+
+void PhysicsBenchmark::generateLevel(const Config& config)
+{
+    std::mt19937 rng(levelSeed);
+    auto random = [&rng](float min, float max)
+    {
+        return std::uniform_real_distribution<float>(min, max)(rng);
+    };
+
+    switch (config.scenario)
+    {
+    case Scenario::PLATFORM_GRID:
+    {
+        // Floors of 50 tiles stacked 4 tiles apart, bodies dropped over them
+        int tilesPerFloor = std::min(config.platformCount, 50);
+        int floors = (config.platformCount + tilesPerFloor - 1) / tilesPerFloor;
+
+        for (int i = 0; i < config.platformCount; i++)
+        {
+            createPlatform((i % tilesPerFloor) * tileSize, (i / tilesPerFloor) * tileSize * 4.f, tileSize, tileSize, 0.f);
+        }
+        for (int i = 0; i < config.bodyCount; i++)
+        {
+            float floorY = static_cast<float>(i % floors) * tileSize * 4.f;
+            createBody(random(0.f, tilesPerFloor * tileSize), floorY + tileSize * 2.f, bodyRadius);
+        }
+        break;
+    }
+    case Scenario::RANDOM_OBBS:
+    {
+        float side = std::sqrt(static_cast<float>(config.platformCount)) * 300.f;
+
+        for (int i = 0; i < config.platformCount; i++)
+        {
+            createPlatform(random(0.f, side), random(0.f, side), random(80.f, 300.f), random(30.f, 80.f), random(0.f, 360.f));
+        }
+        for (int i = 0; i < config.bodyCount; i++)
+        {
+            createBody(random(0.f, side), random(0.f, side), bodyRadius);
+        }
+        break;
+    }
+    case Scenario::DENSE_CLUSTER:
+    {
+        float side = std::sqrt(static_cast<float>(config.platformCount)) * 60.f;
+
+        for (int i = 0; i < config.platformCount; i++)
+        {
+            createPlatform(random(0.f, side), random(0.f, side), random(50.f, 100.f), random(50.f, 100.f), random(0.f, 360.f));
+        }
+        for (int i = 0; i < config.bodyCount; i++)
+        {
+            createBody(random(0.f, side), random(0.f, side), bodyRadius);
+        }
+        break;
+    }
+    case Scenario::BODY_CROWD:
+    {
+        // One floor with the bodies in rows just above it, touching their neighbours
+        for (int i = 0; i < config.platformCount; i++)
+        {
+            createPlatform(i * tileSize, 0.f, tileSize, tileSize, 0.f);
+        }
+
+        int bodiesPerRow = std::max(1, static_cast<int>(config.platformCount * tileSize / (bodyRadius * 2.f)));
+        for (int i = 0; i < config.bodyCount; i++)
+        {
+            createBody((i % bodiesPerRow) * bodyRadius * 2.f, tileSize + (i / bodiesPerRow) * bodyRadius * 2.f, bodyRadius);
+        }
+        break;
+    }
+    case Scenario::SCATTERED_BODIES:
+    {
+        // Ledges 4 tiles apart on a square grid, the bodies dropped onto them
+        // in small piles so every ledge is its own island
+        int ledgesPerRow = std::max(1, static_cast<int>(std::sqrt(static_cast<float>(config.platformCount))));
+
+        for (int i = 0; i < config.platformCount; i++)
+        {
+            createPlatform((i % ledgesPerRow) * tileSize * 4.f, (i / ledgesPerRow) * tileSize * 4.f, tileSize * 2.f, tileSize * 0.5f, random(-20.f, 20.f));
+        }
+        for (int i = 0; i < config.bodyCount; i++)
+        {
+            int ledge = i % config.platformCount;
+            float x = (ledge % ledgesPerRow) * tileSize * 4.f + random(-tileSize, tileSize);
+            float y = (ledge / ledgesPerRow) * tileSize * 4.f + tileSize * 0.5f + (i / config.platformCount) * bodyRadius * 2.f;
+            createBody(x, y, bodyRadius);
+        }
+        break;
+    }
+    case Scenario::FORCE_FIELDS:
+    {
+        // The body crowd's floor and bodies, with updrafts, pulls and
+        // whirlpools spread along it, overlapping their neighbours
+        for (int i = 0; i < config.platformCount; i++)
+        {
+            createPlatform(i * tileSize, 0.f, tileSize, tileSize, 0.f);
+        }
+
+        int bodiesPerRow = std::max(1, static_cast<int>(config.platformCount * tileSize / (bodyRadius * 2.f)));
+        for (int i = 0; i < config.bodyCount; i++)
+        {
+            createBody((i % bodiesPerRow) * bodyRadius * 2.f, tileSize + (i / bodiesPerRow) * bodyRadius * 2.f, bodyRadius);
+        }
+
+        float spacing = config.platformCount * tileSize / std::max(config.fieldCount, 1);
+        for (int i = 0; i < config.fieldCount; i++)
+        {
+            float x = i * spacing + random(0.f, spacing);
+            float y = tileSize * 2.f + random(0.f, tileSize * 2.f);
+
+            ForceFieldComponent field{};
+            if (i % 3 == 0)
+            {
+                field = ForceFieldComponent::Directional(random(100.f, 400.f), myMath::Vector2D(0.f, 1.f));
+            }
+            else if (i % 3 == 1)
+            {
+                field = ForceFieldComponent::Radial(random(-300.f, -100.f), random(tileSize, tileSize * 3.f));
+            }
+            else
+            {
+                field = ForceFieldComponent::Vortex(random(100.f, 300.f), random(tileSize, tileSize * 3.f));
+            }
+            field.falloff = static_cast<ForceFieldFalloff>(i % 3);
+
+            createField(x, y, field);
+        }
+        break;
+    }
+    }
+}
+
+void PhysicsBenchmark::clearLevel()
+{
+    for (auto entity : ecsCoordinator.getAllLiveEntities())
+    {
+        ecsCoordinator.destroyEntity(entity);
+    }
+    ecsCoordinator.getSpecificSystem<PhysicsSystemECS>()->ResetSimulation();
+}
+
+bool PhysicsBenchmark::fitsEntityLimit(const Config& config)
+{
+    return config.platformCount + config.bodyCount + config.fieldCount <= static_cast<int>(MAX_ENTITIES);
+}
+
+// The first update bakes the static collision and is left out of the timing
+PhysicsBenchmark::Result PhysicsBenchmark::run(const Config& config)
+{
+    if (!fitsEntityLimit(config))
+    {
+        std::cout << "Error: " << config.name << " needs more than " << MAX_ENTITIES << " entities, skipped" << std::endl;
+
+        Result skipped{};
+        skipped.name = config.name;
+        return skipped;
+    }
+
+    auto physicsSystem = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
+    float dt = PhysicsSystemECS::GetFixedDeltaTime();
+
+    bool wasDeterministic = PhysicsSystemECS::IsDeterministic();
+    PhysicsSystemECS::SetDeterministic(true);
+
+    int configuredWorkers = PhysicsSystemECS::GetWorkerThreads();
+    if (config.workers > 0)
+    {
+        physicsSystem->SetWorkerThreads(config.workers);
+    }
+
+    clearLevel();
+    generateLevel(config);
+
+    GLFWFunctions::frameNumber++;
+    physicsSystem->update(dt);
+    physicsSystem->ResetStepStats();
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < config.steps; i++)
+    {
+        GLFWFunctions::frameNumber++;
+        physicsSystem->update(dt);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    const PhysicsSystemECS::StepStats& stats = physicsSystem->GetStepStats();
+    double steps = static_cast<double>(std::max<size_t>(stats.steps, 1));
+
+    Result result{};
+    result.name = config.name;
+    result.platformCount = config.platformCount;
+    result.bodyCount = config.bodyCount;
+    result.fieldCount = config.fieldCount;
+    result.steps = config.steps;
+    result.staticShapes = physicsSystem->getStaticWorld().getShapeCount();
+    result.nsPerStep = std::chrono::duration<double, std::nano>(end - start).count() / steps;
+    result.broadphasePairsPerStep = stats.broadphasePairs / steps;
+    result.narrowphaseTestsPerStep = stats.narrowphaseTests / steps;
+    result.contactsPerStep = stats.contacts / steps;
+    result.workers = physicsSystem->GetWorkerCount();
+    result.parallelNsPerStep = stats.parallelNs / steps;
+    result.stateHash = physicsSystem->ComputeStateHash();
+
+    clearLevel();
+    physicsSystem->SetWorkerThreads(configuredWorkers);
+    PhysicsSystemECS::SetDeterministic(wasDeterministic);
+
+    return result;
+}
+
+// Both passes push the same bodies through the same forces, only the way the
+// components are reached differs
+PhysicsBenchmark::ForceResult PhysicsBenchmark::runForces(int bodyCount, int iterations)
+{
+    clearLevel();
+    for (int i = 0; i < bodyCount; i++)
+    {
+        createBody(static_cast<float>(i % 100) * tileSize, static_cast<float>(i / 100) * tileSize, bodyRadius);
+    }
+
+    std::vector<Entity> bodies;
+    for (auto entity : ecsCoordinator.getAllLiveEntities())
+    {
+        bodies.push_back(entity);
+    }
+
+    float dt = PhysicsSystemECS::GetFixedDeltaTime();
+    myMath::Vector2D gravity(0.f, -100.f);
+    myMath::Vector2D direction(0.f, 1.f);
+
+    ForceManager forceManager;
+    auto entityStart = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++)
+    {
+        for (auto& entity : bodies)
+        {
+            forceManager.AddForce(entity, gravity * dt);
+            forceManager.ApplyForce(entity, direction, 10.f, dt);
+        }
+    }
+    auto entityEnd = std::chrono::steady_clock::now();
+
+    std::vector<std::pair<PhysicsComponent*, TransformComponent*>> resolved;
+    for (auto& entity : bodies)
+    {
+        resolved.emplace_back(&ecsCoordinator.getComponent<PhysicsComponent>(entity), &ecsCoordinator.getComponent<TransformComponent>(entity));
+    }
+
+    auto resolvedStart = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; iteration++)
+    {
+        for (auto& [physics, transform] : resolved)
+        {
+            ForceManager::AddForce(*physics, gravity * dt);
+            ForceManager::ApplyForce(*physics, *transform, direction, 10.f, dt);
+        }
+    }
+    auto resolvedEnd = std::chrono::steady_clock::now();
+
+    clearLevel();
+
+    double bodyIterations = static_cast<double>(std::max(bodyCount * iterations, 1));
+
+    ForceResult result{};
+    result.bodyCount = bodyCount;
+    result.iterations = iterations;
+    result.entityNsPerBody = std::chrono::duration<double, std::nano>(entityEnd - entityStart).count() / bodyIterations;
+    result.resolvedNsPerBody = std::chrono::duration<double, std::nano>(resolvedEnd - resolvedStart).count() / bodyIterations;
+    return result;
+}
+
+bool PhysicsBenchmark::runSuite(const std::vector<Config>& suite, std::string const& outputPath)
+{
+    nlohmann::json results = nlohmann::json::array();
+
+    // First run of each scenario, the one later runs are compared against
+    std::unordered_map<std::string, Result> baselines;
+
+    for (auto const& config : suite)
+    {
+        // A skipped level has no timings, and must not become the baseline
+        if (!fitsEntityLimit(config))
+        {
+            std::cout << "Error: " << config.name << " needs more than " << MAX_ENTITIES << " entities, skipped" << std::endl;
+            continue;
+        }
+
+        Result result = run(config);
+        const Result& baseline = baselines.emplace(result.name, result).first->second;
+
+        // Worker count must never change the outcome of a deterministic run
+        double speedup = baseline.parallelNsPerStep / std::max(result.parallelNsPerStep, 1.0);
+        bool sameState = baseline.stateHash == result.stateHash;
+
+        std::cout << result.name << " (" << result.workers << " workers): " << result.nsPerStep << " ns/step, "
+                  << result.parallelNsPerStep << " ns/step in contact phases (x" << speedup << "), "
+                  << result.broadphasePairsPerStep << " broadphase pairs, "
+                  << result.narrowphaseTestsPerStep << " narrowphase tests, "
+                  << result.contactsPerStep << " contacts per step ("
+                  << result.platformCount << " platforms baked into " << result.staticShapes << " shapes, "
+                  << result.bodyCount << " bodies)" << std::endl;
+
+        if (!sameState)
+        {
+            std::cout << "Error: " << result.name << " ended in a different state with " << result.workers
+                      << " workers than with " << baseline.workers << std::endl;
+        }
+
+        results.push_back({
+            { "name", result.name },
+            { "platforms", result.platformCount },
+            { "bodies", result.bodyCount },
+            { "fields", result.fieldCount },
+            { "steps", result.steps },
+            { "staticShapes", result.staticShapes },
+            { "nsPerStep", result.nsPerStep },
+            { "broadphasePairsPerStep", result.broadphasePairsPerStep },
+            { "narrowphaseTestsPerStep", result.narrowphaseTestsPerStep },
+            { "contactsPerStep", result.contactsPerStep },
+            { "workers", result.workers },
+            { "parallelNsPerStep", result.parallelNsPerStep },
+            { "contactPhaseSpeedup", speedup },
+            { "matchesBaselineState", sameState } });
+    }
+
+    ForceResult forces = runForces(4000, 200);
+    std::cout << "force application (" << forces.bodyCount << " bodies): " << forces.entityNsPerBody
+              << " ns/body through entities, " << forces.resolvedNsPerBody << " ns/body on resolved components" << std::endl;
+
+    nlohmann::json jsonObj;
+    jsonObj["benchmark"]["fixedDeltaTime"] = PhysicsSystemECS::GetFixedDeltaTime();
+    jsonObj["benchmark"]["results"] = results;
+    jsonObj["benchmark"]["forceApplication"] = {
+        { "bodies", forces.bodyCount },
+        { "iterations", forces.iterations },
+        { "entityNsPerBody", forces.entityNsPerBody },
+        { "resolvedNsPerBody", forces.resolvedNsPerBody } };
+
+    std::ofstream outputFile(outputPath);
+    if (!outputFile.is_open())
+    {
+        std::cout << "Error: could not save to file " << outputPath << std::endl;
+        return false;
+    }
+
+    outputFile << jsonObj.dump(2);
+    return true;
+}
@@ -0,0 +1,92 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   PhysicsBenchmark.h
+@brief:  This header file contains the declaration of the PhysicsBenchmark class.
+         It fills the ECS with generated levels (platform grids, random OBBs,
+         dense clusters, crowds of dynamic circles) and times the physics
+         system on each of them without a window, graphics or audio. The same
+         level can be run with different worker thread counts to measure how
+         the contact phases scale.
+         Lee Jing Wen (jingwen.lee): Declared the PhysicsBenchmark class
+                                     100%
+*//*____________________________________________________________________________-*/
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ForceFieldComponent;
+
+class PhysicsBenchmark
+{
+public:
+    enum class Scenario {
+        PLATFORM_GRID,  // floors of touching axis aligned tiles
+        RANDOM_OBBS,    // platforms scattered at random angles
+        DENSE_CLUSTER,  // platforms and bodies packed into a small area
+        BODY_CROWD,     // one long floor under many dynamic circles
+        SCATTERED_BODIES, // small ledges, each with a few bodies of its own
+        FORCE_FIELDS    // a body crowd under a row of pumps and whirlpools
+    };
+
+    struct Config {
+        std::string name;
+        Scenario scenario;
+        int platformCount;
+        int bodyCount;
+        int steps;
+        int workers;    // worker threads for the run, 0 keeps the configured count
+        int fieldCount;
+    };
+
+    struct Result {
+        std::string name;
+        int platformCount;
+        int bodyCount;
+        int fieldCount;
+        int steps;
+        size_t staticShapes;
+        double nsPerStep;
+        double broadphasePairsPerStep;
+        double narrowphaseTestsPerStep;
+        double contactsPerStep;
+        size_t workers;
+        double parallelNsPerStep;
+        uint64_t stateHash;
+    };
+
+    // Force accumulation and integration of every body, once through the
+    // entity API that looks components up per call and once over component
+    // references resolved up front
+    struct ForceResult {
+        int bodyCount;
+        int iterations;
+        double entityNsPerBody;
+        double resolvedNsPerBody;
+    };
+
+    // The scenarios run by default
+    static std::vector<Config> getDefaultSuite();
+
+    // Run every scenario on an ECS set up with ECSCoordinator::initialiseHeadless
+    // and write the results as JSON. Returns false if the file could not be written
+    static bool runSuite(const std::vector<Config>& suite, std::string const& outputPath);
+
+    // Levels needing more than MAX_ENTITIES entities are skipped
+    static bool fitsEntityLimit(const Config& config);
+
+    static Result run(const Config& config);
+    static ForceResult runForces(int bodyCount, int iterations);
+
+private:
+    // Entities are placed with a fixed seed so every run builds the same level
+    static void generateLevel(const Config& config);
+    static void clearLevel();
+
+    static void createPlatform(float x, float y, float width, float height, float rotation);
+    static void createBody(float x, float y, float radius);
+    static void createField(float x, float y, const ForceFieldComponent& field);
+};
@@ -22,11 +22,9 @@ All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserve
 void PlayerBehaviour::update(Entity entity) {
 	auto PhysicsSystemRef = ecsCoordinator.getSpecificSystem<PhysicsSystemECS>();
 
-	Force playerForce = ecsCoordinator.getComponent<PhysicsComponent>(entity).force;
-	ForceManager forceManager = ecsCoordinator.getComponent<PhysicsComponent>(entity).forceManager;
-	myMath::Vector2D gravityScale = ecsCoordinator.getComponent<PhysicsComponent>(entity).gravityScale;
+	auto& physics = ecsCoordinator.getComponent<PhysicsComponent>(entity);
 	myMath::Vector2D& rotation = ecsCoordinator.getComponent<TransformComponent>(entity).orientation;
-	float mag = playerForce.GetMagnitude();
+	float mag = physics.force.GetMagnitude();
 
 
 	if ((*GLFWFunctions::keyState)[Key::D]) {
@@ -40,7 +38,7 @@ void PlayerBehaviour::update(Entity entity) {
 	if (PhysicsSystemRef->getIsColliding() && PhysicsSystemRef->GetAlrJumped()) {
 		if ((*GLFWFunctions::keyState)[Key::SPACE]) {
 			PhysicsSystemRef->SetAlrJumped(false);  // Set jump state to prevent multiple jumps
-			forceManager.AddForce(entity, myMath::Vector2D(-mag, -mag));
+			physics.forceManager.AddForce(entity, myMath::Vector2D(-mag, -mag));
 		}
 	}
 
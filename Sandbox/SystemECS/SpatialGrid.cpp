@@ -0,0 +1,280 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   SpatialGrid.cpp
+@brief:  This source file contains the implementation of the SpatialGrid class,
+         the hashed uniform grid broadphase used by the physics system for
+         region, segment and nearest neighbour lookups.
+         Lee Jing Wen (jingwen.lee): Defined the SpatialGrid class
+                                     100%
+*//*____________________________________________________________________________-*/
+
+#include "SpatialGrid.h"
+#include <unordered_set>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+SpatialGrid::SpatialGrid(float cellSize) : cellSize(cellSize > 0.f ? cellSize : 200.f), extent{ 0, 0, 0, 0 }, hasExtent(false)
+{
+}
+
+void SpatialGrid::setCellSize(float size)
+{
+    if (size <= 0.f || size == cellSize)
+    {
+        return;
+    }
+
+    cellSize = size;
+    clear();
+}
+
+void SpatialGrid::clear()
+{
+    cells.clear();
+    entries.clear();
+    hasExtent = false;
+}
+
+int SpatialGrid::cellCoord(float value) const
+{
+    return static_cast<int>(std::floor(value / cellSize));
+}
+
+SpatialGrid::CellRange SpatialGrid::getCellRange(const Bounds& bounds) const
+{
+    return { cellCoord(bounds.min.GetX()), cellCoord(bounds.min.GetY()),
+             cellCoord(bounds.max.GetX()), cellCoord(bounds.max.GetY()) };
+}
+
+long long SpatialGrid::makeKey(int x, int y)
+{
+    return (static_cast<long long>(x) << 32) ^ static_cast<long long>(static_cast<unsigned int>(y));
+}
+
+void SpatialGrid::addToCells(Entity entity, const CellRange& range)
+{
+    for (int y = range.minY; y <= range.maxY; y++)
+    {
+        for (int x = range.minX; x <= range.maxX; x++)
+        {
+            cells[makeKey(x, y)].push_back(entity);
+        }
+    }
+
+    if (!hasExtent)
+    {
+        extent = range;
+        hasExtent = true;
+    }
+    else
+    {
+        extent.minX = std::min(extent.minX, range.minX);
+        extent.minY = std::min(extent.minY, range.minY);
+        extent.maxX = std::max(extent.maxX, range.maxX);
+        extent.maxY = std::max(extent.maxY, range.maxY);
+    }
+}
+
+void SpatialGrid::removeFromCells(Entity entity, const CellRange& range)
+{
+    for (int y = range.minY; y <= range.maxY; y++)
+    {
+        for (int x = range.minX; x <= range.maxX; x++)
+        {
+            auto cell = cells.find(makeKey(x, y));
+            if (cell == cells.end())
+            {
+                continue;
+            }
+
+            auto& list = cell->second;
+            auto it = std::find(list.begin(), list.end(), entity);
+            if (it != list.end())
+            {
+                *it = list.back();
+                list.pop_back();
+            }
+
+            if (list.empty())
+            {
+                cells.erase(cell);
+            }
+        }
+    }
+}
+
+void SpatialGrid::update(Entity entity, const Bounds& bounds)
+{
+    CellRange range = getCellRange(bounds);
+    auto it = entries.find(entity);
+
+    if (it == entries.end())
+    {
+        entries[entity] = { bounds, range };
+        addToCells(entity, range);
+        return;
+    }
+
+    Entry& entry = it->second;
+    entry.bounds = bounds;
+
+    if (entry.range.minX != range.minX || entry.range.minY != range.minY ||
+        entry.range.maxX != range.maxX || entry.range.maxY != range.maxY)
+    {
+        removeFromCells(entity, entry.range);
+        addToCells(entity, range);
+        entry.range = range;
+    }
+}
+
+void SpatialGrid::remove(Entity entity)
+{
+    auto it = entries.find(entity);
+    if (it == entries.end())
+    {
+        return;
+    }
+
+    removeFromCells(entity, it->second.range);
+    entries.erase(it);
+}
+
+void SpatialGrid::getEntities(std::vector<Entity>& results) const
+{
+    results.reserve(results.size() + entries.size());
+    for (auto const& entry : entries)
+    {
+        results.push_back(entry.first);
+    }
+}
+
+void SpatialGrid::queryRegion(const Bounds& region, std::vector<Entity>& results) const
+{
+    CellRange range = getCellRange(region);
+    std::unordered_set<Entity> seen;
+
+    for (int y = range.minY; y <= range.maxY; y++)
+    {
+        for (int x = range.minX; x <= range.maxX; x++)
+        {
+            auto cell = cells.find(makeKey(x, y));
+            if (cell == cells.end())
+            {
+                continue;
+            }
+
+            for (auto entity : cell->second)
+            {
+                const Bounds& bounds = entries.at(entity).bounds;
+                bool overlaps = bounds.min.GetX() <= region.max.GetX() && bounds.max.GetX() >= region.min.GetX() &&
+                                bounds.min.GetY() <= region.max.GetY() && bounds.max.GetY() >= region.min.GetY();
+
+                if (overlaps && seen.insert(entity).second)
+                {
+                    results.push_back(entity);
+                }
+            }
+        }
+    }
+}
+
+// Walks the cells under the segment one at a time (Amanatides & Woo), always
+// stepping across whichever cell boundary the segment reaches first
+void SpatialGrid::querySegment(const myMath::Vector2D& start, const myMath::Vector2D& end, std::vector<Entity>& results) const
+{
+    std::unordered_set<Entity> seen;
+    float const infinity = std::numeric_limits<float>::infinity();
+
+    int x = cellCoord(start.GetX());
+    int y = cellCoord(start.GetY());
+    int endX = cellCoord(end.GetX());
+    int endY = cellCoord(end.GetY());
+
+    float dx = end.GetX() - start.GetX();
+    float dy = end.GetY() - start.GetY();
+    int stepX = dx > 0.f ? 1 : -1;
+    int stepY = dy > 0.f ? 1 : -1;
+
+    float tMaxX = dx != 0.f ? ((x + (stepX > 0 ? 1 : 0)) * cellSize - start.GetX()) / dx : infinity;
+    float tMaxY = dy != 0.f ? ((y + (stepY > 0 ? 1 : 0)) * cellSize - start.GetY()) / dy : infinity;
+    float tDeltaX = dx != 0.f ? cellSize / std::fabs(dx) : infinity;
+    float tDeltaY = dy != 0.f ? cellSize / std::fabs(dy) : infinity;
+
+    int remaining = std::abs(endX - x) + std::abs(endY - y) + 1;
+    while (remaining-- > 0)
+    {
+        auto cell = cells.find(makeKey(x, y));
+        if (cell != cells.end())
+        {
+            for (auto entity : cell->second)
+            {
+                if (seen.insert(entity).second)
+                {
+                    results.push_back(entity);
+                }
+            }
+        }
+
+        if (tMaxX < tMaxY)
+        {
+            x += stepX;
+            tMaxX += tDeltaX;
+        }
+        else
+        {
+            y += stepY;
+            tMaxY += tDeltaY;
+        }
+    }
+}
+
+void SpatialGrid::queryRing(const myMath::Vector2D& point, int ring, std::vector<Entity>& results) const
+{
+    int centerX = cellCoord(point.GetX());
+    int centerY = cellCoord(point.GetY());
+
+    auto visit = [&](int x, int y)
+    {
+        auto cell = cells.find(makeKey(x, y));
+        if (cell != cells.end())
+        {
+            results.insert(results.end(), cell->second.begin(), cell->second.end());
+        }
+    };
+
+    if (ring == 0)
+    {
+        visit(centerX, centerY);
+        return;
+    }
+
+    // Top and bottom rows, then the left and right columns without the corners
+    for (int x = centerX - ring; x <= centerX + ring; x++)
+    {
+        visit(x, centerY - ring);
+        visit(x, centerY + ring);
+    }
+    for (int y = centerY - ring + 1; y <= centerY + ring - 1; y++)
+    {
+        visit(centerX - ring, y);
+        visit(centerX + ring, y);
+    }
+}
+
+int SpatialGrid::getRingLimit(const myMath::Vector2D& point) const
+{
+    if (!hasExtent)
+    {
+        return -1;
+    }
+
+    int centerX = cellCoord(point.GetX());
+    int centerY = cellCoord(point.GetY());
+
+    return std::max({ std::abs(centerX - extent.minX), std::abs(centerX - extent.maxX),
+                      std::abs(centerY - extent.minY), std::abs(centerY - extent.maxY) });
+}
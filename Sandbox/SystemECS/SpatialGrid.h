@@ -0,0 +1,87 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   SpatialGrid.h
+@brief:  This header file contains the declaration of the SpatialGrid class, the
+         broadphase used by the physics system. Entities are stored by their
+         axis aligned bounds in a hashed uniform grid so spatial queries only
+         look at entities in nearby cells instead of every live entity.
+         Lee Jing Wen (jingwen.lee): Declared the SpatialGrid class
+                                     100%
+*//*____________________________________________________________________________-*/
+#pragma once
+#include "ECSDefinitions.h"
+#include "vector2D.h"
+#include <unordered_map>
+#include <vector>
+
+class SpatialGrid
+{
+public:
+    struct Bounds {
+        myMath::Vector2D min;
+        myMath::Vector2D max;
+    };
+
+    explicit SpatialGrid(float cellSize = 200.f);
+
+    // Changing the cell size empties the grid
+    void setCellSize(float size);
+    float getCellSize() const { return cellSize; }
+
+    void clear();
+
+    // Insert, move or remove an entity. Moving only touches cells when the
+    // entity crosses into different cells
+    void update(Entity entity, const Bounds& bounds);
+    void remove(Entity entity);
+
+    bool contains(Entity entity) const { return entries.find(entity) != entries.end(); }
+
+    // Entities currently in the grid
+    void getEntities(std::vector<Entity>& results) const;
+
+    // Entities whose bounds overlap the region, each reported once
+    void queryRegion(const Bounds& region, std::vector<Entity>& results) const;
+
+    // Entities in the cells the segment passes through, each reported once,
+    // in the order the cells are visited
+    void querySegment(const myMath::Vector2D& start, const myMath::Vector2D& end, std::vector<Entity>& results) const;
+
+    // Entities in the square ring of cells 'ring' cells away from the cell
+    // holding the point (ring 0 is that cell)
+    void queryRing(const myMath::Vector2D& point, int ring, std::vector<Entity>& results) const;
+
+    // Number of rings needed around the point to cover every occupied cell
+    int getRingLimit(const myMath::Vector2D& point) const;
+
+    size_t getEntityCount() const { return entries.size(); }
+    size_t getCellCount() const { return cells.size(); }
+
+private:
+    struct CellRange {
+        int minX, minY, maxX, maxY;
+    };
+
+    int cellCoord(float value) const;
+    CellRange getCellRange(const Bounds& bounds) const;
+    static long long makeKey(int x, int y);
+
+    void addToCells(Entity entity, const CellRange& range);
+    void removeFromCells(Entity entity, const CellRange& range);
+
+    struct Entry {
+        Bounds bounds;
+        CellRange range;
+    };
+
+    float cellSize;
+    std::unordered_map<long long, std::vector<Entity>> cells;
+    std::unordered_map<Entity, Entry> entries;
+
+    // Occupied cell extent, only ever grows until the grid is cleared
+    CellRange extent;
+    bool hasExtent;
+};
@@ -0,0 +1,358 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   StaticCollisionWorld.cpp
+@brief:  This source file contains the implementation of the StaticCollisionWorld
+         class, merging level tiles into collision boxes and caching the result
+         next to the scene file.
+         Lee Jing Wen (jingwen.lee): Defined the StaticCollisionWorld class
+                                     100%
+*//*____________________________________________________________________________-*/
+
+#include "StaticCollisionWorld.h"
+#include "../Nlohmann/json.hpp"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+namespace
+{
+    // Tile edges closer than this are treated as touching
+    const float mergeTolerance = 0.01f;
+
+    const float degToRad = 3.14159265358979323846f / 180.f;
+
+    // Reads { "x": .., "y": .. } under key, false when it is missing or not numbers
+    bool readVector(nlohmann::json const& parent, char const* key, myMath::Vector2D& vector)
+    {
+        if (!parent.contains(key))
+        {
+            return false;
+        }
+
+        nlohmann::json const& data = parent[key];
+        if (!data.is_object() || !data.contains("x") || !data.contains("y") || !data["x"].is_number() || !data["y"].is_number())
+        {
+            return false;
+        }
+
+        vector = myMath::Vector2D(data["x"].get<float>(), data["y"].get<float>());
+        return true;
+    }
+
+    // Axis aligned box being merged, index 0 is x and 1 is y. Sources are
+    // indices into the baked sources
+    struct MergeBox {
+        float min[2];
+        float max[2];
+        std::vector<size_t> sources;
+    };
+
+    // Merge boxes that share the same extent across the other axis and touch
+    // or overlap along runAxis into single boxes
+    void mergeRuns(std::vector<MergeBox>& boxes, int runAxis)
+    {
+        int otherAxis = 1 - runAxis;
+
+        std::sort(boxes.begin(), boxes.end(), [runAxis, otherAxis](const MergeBox& a, const MergeBox& b)
+            {
+                if (a.min[otherAxis] != b.min[otherAxis]) return a.min[otherAxis] < b.min[otherAxis];
+                if (a.max[otherAxis] != b.max[otherAxis]) return a.max[otherAxis] < b.max[otherAxis];
+                return a.min[runAxis] < b.min[runAxis];
+            });
+
+        std::vector<MergeBox> merged;
+        for (auto& box : boxes)
+        {
+            if (!merged.empty())
+            {
+                MergeBox& current = merged.back();
+                bool sameBand = std::fabs(current.min[otherAxis] - box.min[otherAxis]) <= mergeTolerance &&
+                                std::fabs(current.max[otherAxis] - box.max[otherAxis]) <= mergeTolerance;
+
+                if (sameBand && box.min[runAxis] <= current.max[runAxis] + mergeTolerance)
+                {
+                    current.max[runAxis] = std::max(current.max[runAxis], box.max[runAxis]);
+                    current.sources.insert(current.sources.end(), box.sources.begin(), box.sources.end());
+                    continue;
+                }
+            }
+
+            merged.push_back(std::move(box));
+        }
+
+        boxes.swap(merged);
+    }
+
+    // Tiles of one tilemap all come from the same entity, it is only listed once
+    void addSource(StaticCollisionWorld::Shape& shape, const StaticCollisionWorld::Source& source)
+    {
+        if (std::find(shape.sources.begin(), shape.sources.end(), source.entity) == shape.sources.end())
+        {
+            shape.sources.push_back(source.entity);
+            shape.sourceIds.push_back(source.id);
+        }
+    }
+
+    std::string fingerprintToString(uint64_t fingerprint)
+    {
+        std::ostringstream stream;
+        stream << std::hex << std::setw(16) << std::setfill('0') << fingerprint;
+        return stream.str();
+    }
+}
+
+StaticCollisionWorld::StaticCollisionWorld() : fingerprint(0), baked(false)
+{
+}
+
+uint64_t StaticCollisionWorld::mixFingerprint(uint64_t fingerprint, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        fingerprint ^= bytes[i];
+        fingerprint *= 1099511628211ull;
+    }
+    return fingerprint;
+}
+
+uint64_t StaticCollisionWorld::computeFingerprint(const std::vector<Source>& sources)
+{
+    uint64_t hash = 14695981039346656037ull;
+
+    for (auto const& source : sources)
+    {
+        float values[5] = { source.position.GetX(), source.position.GetY(),
+                            source.scale.GetX(), source.scale.GetY(), source.rotation };
+        uint64_t idLength = source.id.size();
+        hash = mixFingerprint(hash, &idLength, sizeof(idLength));
+        hash = mixFingerprint(hash, source.id.data(), source.id.size());
+        hash = mixFingerprint(hash, values, sizeof(values));
+    }
+
+    return hash;
+}
+
+void StaticCollisionWorld::clear()
+{
+    shapes.clear();
+    shapeOfSource.clear();
+    grid.clear();
+    fingerprint = 0;
+    baked = false;
+}
+
+// Tiles at quarter turns become axis aligned boxes and are merged into
+// horizontal strips first, then strips with matching ends are stacked into
+// rectangles. Anything at another angle is kept as its own box.
+void StaticCollisionWorld::bake(const std::vector<Source>& sources, uint64_t sourceFingerprint)
+{
+    clear();
+
+    std::vector<MergeBox> boxes;
+    for (size_t i = 0; i < sources.size(); i++)
+    {
+        const Source& source = sources[i];
+        float halfX = std::fabs(source.scale.GetX()) * 0.5f;
+        float halfY = std::fabs(source.scale.GetY()) * 0.5f;
+
+        float quarterTurns = source.rotation / 90.f;
+        float nearestTurn = std::round(quarterTurns);
+
+        if (std::fabs(quarterTurns - nearestTurn) * 90.f > mergeTolerance)
+        {
+            Shape shape{ source.position, myMath::Vector2D(halfX, halfY), source.rotation * degToRad };
+            addSource(shape, source);
+            shapes.push_back(std::move(shape));
+            continue;
+        }
+
+        if (static_cast<long long>(nearestTurn) % 2 != 0)
+        {
+            std::swap(halfX, halfY);
+        }
+
+        MergeBox box{};
+        box.min[0] = source.position.GetX() - halfX;
+        box.min[1] = source.position.GetY() - halfY;
+        box.max[0] = source.position.GetX() + halfX;
+        box.max[1] = source.position.GetY() + halfY;
+        box.sources.push_back(i);
+        boxes.push_back(std::move(box));
+    }
+
+    mergeRuns(boxes, 0);
+    mergeRuns(boxes, 1);
+
+    for (auto& box : boxes)
+    {
+        myMath::Vector2D center((box.min[0] + box.max[0]) * 0.5f, (box.min[1] + box.max[1]) * 0.5f);
+        myMath::Vector2D halfExtents((box.max[0] - box.min[0]) * 0.5f, (box.max[1] - box.min[1]) * 0.5f);
+        Shape shape{ center, halfExtents, 0.f };
+        for (auto index : box.sources)
+        {
+            addSource(shape, sources[index]);
+        }
+        shapes.push_back(std::move(shape));
+    }
+
+    fingerprint = sourceFingerprint;
+    baked = true;
+    index();
+}
+
+void StaticCollisionWorld::index()
+{
+    shapeOfSource.clear();
+    grid.clear();
+
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        for (auto entity : shapes[i].sources)
+        {
+            shapeOfSource[entity] = static_cast<int>(i);
+        }
+        grid.update(static_cast<Entity>(i), getShapeBounds(shapes[i]));
+    }
+}
+
+SpatialGrid::Bounds StaticCollisionWorld::getShapeBounds(const Shape& shape)
+{
+    float cosValue = std::fabs(std::cos(shape.rotation));
+    float sinValue = std::fabs(std::sin(shape.rotation));
+    float halfX = shape.halfExtents.GetX();
+    float halfY = shape.halfExtents.GetY();
+
+    myMath::Vector2D extent(cosValue * halfX + sinValue * halfY, sinValue * halfX + cosValue * halfY);
+    return { shape.center - extent, shape.center + extent };
+}
+
+void StaticCollisionWorld::queryRegion(const SpatialGrid::Bounds& region, std::vector<Entity>& results) const
+{
+    grid.queryRegion(region, results);
+}
+
+int StaticCollisionWorld::getShapeOf(Entity entity) const
+{
+    auto it = shapeOfSource.find(entity);
+    return it != shapeOfSource.end() ? it->second : -1;
+}
+
+std::string StaticCollisionWorld::getCachePath(std::string const& scenePath)
+{
+    std::filesystem::path path(scenePath);
+    path.replace_extension(".collision.json");
+    return path.string();
+}
+
+// The cache is only a shortcut, so anything unexpected in it (hand edits, a
+// write cut short, an older format) fails the load and the caller rebakes
+bool StaticCollisionWorld::load(std::string const& filename, uint64_t expectedFingerprint, const std::vector<Source>& sources)
+{
+    // Entities are found again by id. An id two entities share could mean
+    // either, so such a scene is always baked
+    std::unordered_map<std::string, Entity> entityOfId;
+    for (auto const& source : sources)
+    {
+        auto [it, inserted] = entityOfId.emplace(source.id, source.entity);
+        if (!inserted && it->second != source.entity)
+        {
+            return false;
+        }
+    }
+
+    std::ifstream inputFile(filename);
+    if (!inputFile.is_open())
+    {
+        return false;
+    }
+
+    nlohmann::json jsonObj = nlohmann::json::parse(inputFile, nullptr, false);
+    if (jsonObj.is_discarded() || !jsonObj.is_object() || !jsonObj.contains("collision"))
+    {
+        return false;
+    }
+
+    nlohmann::json const& collision = jsonObj["collision"];
+    if (!collision.is_object() || !collision.contains("fingerprint") || !collision["fingerprint"].is_string() ||
+        collision["fingerprint"].get<std::string>() != fingerprintToString(expectedFingerprint))
+    {
+        return false;
+    }
+
+    if (!collision.contains("shapes") || !collision["shapes"].is_array())
+    {
+        return false;
+    }
+
+    std::vector<Shape> loaded;
+    for (auto const& shapeData : collision["shapes"])
+    {
+        Shape shape{};
+        if (!shapeData.is_object() ||
+            !readVector(shapeData, "center", shape.center) ||
+            !readVector(shapeData, "halfExtents", shape.halfExtents) ||
+            !shapeData.contains("rotation") || !shapeData["rotation"].is_number() ||
+            !shapeData.contains("sources") || !shapeData["sources"].is_array())
+        {
+            return false;
+        }
+        shape.rotation = shapeData["rotation"].get<float>();
+
+        for (auto const& source : shapeData["sources"])
+        {
+            if (!source.is_string())
+            {
+                return false;
+            }
+
+            auto entity = entityOfId.find(source.get<std::string>());
+            if (entity == entityOfId.end())
+            {
+                return false;
+            }
+            shape.sources.push_back(entity->second);
+            shape.sourceIds.push_back(entity->first);
+        }
+        loaded.push_back(std::move(shape));
+    }
+
+    clear();
+    shapes = std::move(loaded);
+    fingerprint = expectedFingerprint;
+    baked = true;
+    index();
+    return true;
+}
+
+bool StaticCollisionWorld::save(std::string const& filename) const
+{
+    nlohmann::json shapeArray = nlohmann::json::array();
+    for (auto const& shape : shapes)
+    {
+        shapeArray.push_back({
+            { "center", { { "x", shape.center.GetX() }, { "y", shape.center.GetY() } } },
+            { "halfExtents", { { "x", shape.halfExtents.GetX() }, { "y", shape.halfExtents.GetY() } } },
+            { "rotation", shape.rotation },
+            { "sources", shape.sourceIds } });
+    }
+
+    nlohmann::json jsonObj;
+    jsonObj["collision"]["fingerprint"] = fingerprintToString(fingerprint);
+    jsonObj["collision"]["shapes"] = shapeArray;
+
+    std::ofstream outputFile(filename);
+    if (!outputFile.is_open())
+    {
+        return false;
+    }
+
+    outputFile << jsonObj.dump(2);
+    return true;
+}
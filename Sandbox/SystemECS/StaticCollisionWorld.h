@@ -0,0 +1,93 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   StaticCollisionWorld.h
+@brief:  This header file contains the declaration of the StaticCollisionWorld
+         class. Level platforms are baked into it when a scene loads: rows and
+         columns of touching axis aligned tiles are merged into single boxes,
+         and the boxes are kept in their own grid outside the ECS for the
+         physics system to collide dynamic bodies against.
+         Lee Jing Wen (jingwen.lee): Declared the StaticCollisionWorld class
+                                     100%
+*//*____________________________________________________________________________-*/
+#pragma once
+#include "ECSDefinitions.h"
+#include "vector2D.h"
+#include "SpatialGrid.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+class StaticCollisionWorld
+{
+public:
+    // A platform as it is in the scene, rotation in degrees. The id is the
+    // one the entity is saved with; entities get different numbers every time
+    // a scene loads, so only the id is fingerprinted and cached
+    struct Source {
+        Entity entity;
+        myMath::Vector2D position;
+        myMath::Vector2D scale;
+        float rotation;
+        std::string id;
+    };
+
+    // A baked collision box, rotation in radians. Merged boxes are always
+    // axis aligned; rotated platforms are kept as they are. Each platform
+    // that went into it is listed once
+    struct Shape {
+        myMath::Vector2D center;
+        myMath::Vector2D halfExtents;
+        float rotation;
+        std::vector<Entity> sources;
+        std::vector<std::string> sourceIds;
+    };
+
+    StaticCollisionWorld();
+
+    // Identifies a set of sources, a bake only needs redoing when it changes
+    static uint64_t computeFingerprint(const std::vector<Source>& sources);
+
+    // Fold more data into a fingerprint, for static geometry that is not a source
+    static uint64_t mixFingerprint(uint64_t fingerprint, const void* data, size_t size);
+
+    void bake(const std::vector<Source>& sources, uint64_t fingerprint);
+    void clear();
+
+    // Baked data cached on disk. Loading fails when the cache is missing or
+    // was baked from different sources. The cached ids are matched back to the
+    // entities of the given sources, and the load fails when an id is unknown
+    // or shared by two entities
+    bool load(std::string const& filename, uint64_t fingerprint, const std::vector<Source>& sources);
+    bool save(std::string const& filename) const;
+
+    // Cache file kept next to a scene file
+    static std::string getCachePath(std::string const& scenePath);
+
+    uint64_t getFingerprint() const { return fingerprint; }
+    bool isBaked() const { return baked; }
+
+    // Indices of the shapes whose bounds overlap the region
+    void queryRegion(const SpatialGrid::Bounds& region, std::vector<Entity>& results) const;
+
+    const Shape& getShape(size_t index) const { return shapes[index]; }
+    size_t getShapeCount() const { return shapes.size(); }
+    size_t getSourceCount() const { return shapeOfSource.size(); }
+
+    // Shape a platform was baked into, or -1
+    int getShapeOf(Entity entity) const;
+
+private:
+    // Rebuild the grid and the source lookup from the shapes
+    void index();
+
+    static SpatialGrid::Bounds getShapeBounds(const Shape& shape);
+
+    std::vector<Shape> shapes;
+    std::unordered_map<Entity, int> shapeOfSource;
+    SpatialGrid grid;
+    uint64_t fingerprint;
+    bool baked;
+};
@@ -0,0 +1,277 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   Tilemap.cpp
+@brief:  This source file contains the implementation of the Tilemap class,
+         chunked tile storage, grid collision queries and chunk mesh building.
+         Lee Jing Wen (jingwen.lee): Defined the Tilemap class
+                                     100%
+*//*____________________________________________________________________________-*/
+
+#include "Tilemap.h"
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+uint64_t Tilemap::nextRevision = 1;
+
+namespace
+{
+    // Division rounding towards negative infinity, so tile -1 is in chunk -1
+    int floorDiv(int value, int divisor)
+    {
+        int quotient = value / divisor;
+        if ((value % divisor != 0) && ((value < 0) != (divisor < 0)))
+        {
+            quotient--;
+        }
+        return quotient;
+    }
+
+    int getTileSlot(int x, int y, int chunkX, int chunkY)
+    {
+        return (y - chunkY * TILEMAP_CHUNK_SIZE) * TILEMAP_CHUNK_SIZE + (x - chunkX * TILEMAP_CHUNK_SIZE);
+    }
+}
+
+uint64_t Tilemap::getChunkKey(int chunkX, int chunkY)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkX)) << 32) | static_cast<uint32_t>(chunkY);
+}
+
+TileChunk* Tilemap::FindChunk(TilemapComponent& tilemap, int chunkX, int chunkY)
+{
+    auto it = tilemap.chunkIndex.find(getChunkKey(chunkX, chunkY));
+    return it != tilemap.chunkIndex.end() ? &tilemap.chunks[it->second] : nullptr;
+}
+
+const TileChunk* Tilemap::FindChunk(const TilemapComponent& tilemap, int chunkX, int chunkY)
+{
+    auto it = tilemap.chunkIndex.find(getChunkKey(chunkX, chunkY));
+    return it != tilemap.chunkIndex.end() ? &tilemap.chunks[it->second] : nullptr;
+}
+
+TileChunk& Tilemap::GetOrCreateChunk(TilemapComponent& tilemap, int chunkX, int chunkY)
+{
+    auto inserted = tilemap.chunkIndex.emplace(getChunkKey(chunkX, chunkY), tilemap.chunks.size());
+    if (inserted.second)
+    {
+        TileChunk chunk{};
+        chunk.chunkX = chunkX;
+        chunk.chunkY = chunkY;
+        chunk.revision = nextRevision++;
+        tilemap.chunks.push_back(chunk);
+    }
+
+    return tilemap.chunks[inserted.first->second];
+}
+
+void Tilemap::SetTile(TilemapComponent& tilemap, int x, int y, uint16_t tile, uint8_t flags)
+{
+    int chunkX = floorDiv(x, TILEMAP_CHUNK_SIZE);
+    int chunkY = floorDiv(y, TILEMAP_CHUNK_SIZE);
+
+    TileChunk* chunk = FindChunk(tilemap, chunkX, chunkY);
+    if (!chunk)
+    {
+        if (tile == 0 && flags == 0)
+        {
+            return;
+        }
+        chunk = &GetOrCreateChunk(tilemap, chunkX, chunkY);
+    }
+
+    int slot = getTileSlot(x, y, chunkX, chunkY);
+    if (chunk->tiles[slot] == tile && chunk->flags[slot] == flags)
+    {
+        return;
+    }
+
+    if ((chunk->flags[slot] & TILE_SOLID) != (flags & TILE_SOLID))
+    {
+        tilemap.collisionHashValid = false;
+    }
+
+    chunk->tiles[slot] = tile;
+    chunk->flags[slot] = flags;
+    chunk->revision = nextRevision++;
+}
+
+uint16_t Tilemap::GetTile(const TilemapComponent& tilemap, int x, int y)
+{
+    int chunkX = floorDiv(x, TILEMAP_CHUNK_SIZE);
+    int chunkY = floorDiv(y, TILEMAP_CHUNK_SIZE);
+
+    const TileChunk* chunk = FindChunk(tilemap, chunkX, chunkY);
+    return chunk ? chunk->tiles[getTileSlot(x, y, chunkX, chunkY)] : 0;
+}
+
+uint8_t Tilemap::GetFlags(const TilemapComponent& tilemap, int x, int y)
+{
+    int chunkX = floorDiv(x, TILEMAP_CHUNK_SIZE);
+    int chunkY = floorDiv(y, TILEMAP_CHUNK_SIZE);
+
+    const TileChunk* chunk = FindChunk(tilemap, chunkX, chunkY);
+    return chunk ? chunk->flags[getTileSlot(x, y, chunkX, chunkY)] : 0;
+}
+
+bool Tilemap::IsSolid(const TilemapComponent& tilemap, int x, int y)
+{
+    return (GetFlags(tilemap, x, y) & TILE_SOLID) != 0;
+}
+
+void Tilemap::WorldToTile(const TilemapComponent& tilemap, const myMath::Vector2D& origin, const myMath::Vector2D& point, int& x, int& y)
+{
+    x = static_cast<int>(std::floor((point.GetX() - origin.GetX()) / tilemap.tileSize));
+    y = static_cast<int>(std::floor((point.GetY() - origin.GetY()) / tilemap.tileSize));
+}
+
+SpatialGrid::Bounds Tilemap::GetTileBounds(const TilemapComponent& tilemap, const myMath::Vector2D& origin, int x, int y)
+{
+    myMath::Vector2D min(origin.GetX() + x * tilemap.tileSize, origin.GetY() + y * tilemap.tileSize);
+    return { min, min + myMath::Vector2D(tilemap.tileSize, tilemap.tileSize) };
+}
+
+SpatialGrid::Bounds Tilemap::GetChunkBounds(const TilemapComponent& tilemap, const myMath::Vector2D& origin, int chunkX, int chunkY)
+{
+    float chunkWidth = TILEMAP_CHUNK_SIZE * tilemap.tileSize;
+    myMath::Vector2D min(origin.GetX() + chunkX * chunkWidth, origin.GetY() + chunkY * chunkWidth);
+    return { min, min + myMath::Vector2D(chunkWidth, chunkWidth) };
+}
+
+bool Tilemap::IsSolidAt(const TilemapComponent& tilemap, const myMath::Vector2D& origin, const myMath::Vector2D& point)
+{
+    int x{}, y{};
+    WorldToTile(tilemap, origin, point, x, y);
+    return IsSolid(tilemap, x, y);
+}
+
+// Walks the covered tiles a chunk at a time so a missing chunk is skipped
+// with one lookup
+void Tilemap::QuerySolidTiles(const TilemapComponent& tilemap, const myMath::Vector2D& origin, const SpatialGrid::Bounds& region, std::vector<SpatialGrid::Bounds>& results)
+{
+    int minX{}, minY{}, maxX{}, maxY{};
+    WorldToTile(tilemap, origin, region.min, minX, minY);
+    WorldToTile(tilemap, origin, region.max, maxX, maxY);
+
+    for (int chunkY = floorDiv(minY, TILEMAP_CHUNK_SIZE); chunkY <= floorDiv(maxY, TILEMAP_CHUNK_SIZE); chunkY++)
+    {
+        for (int chunkX = floorDiv(minX, TILEMAP_CHUNK_SIZE); chunkX <= floorDiv(maxX, TILEMAP_CHUNK_SIZE); chunkX++)
+        {
+            const TileChunk* chunk = FindChunk(tilemap, chunkX, chunkY);
+            if (!chunk)
+            {
+                continue;
+            }
+
+            int startX = std::max(minX, chunkX * TILEMAP_CHUNK_SIZE);
+            int endX = std::min(maxX, chunkX * TILEMAP_CHUNK_SIZE + TILEMAP_CHUNK_SIZE - 1);
+            int startY = std::max(minY, chunkY * TILEMAP_CHUNK_SIZE);
+            int endY = std::min(maxY, chunkY * TILEMAP_CHUNK_SIZE + TILEMAP_CHUNK_SIZE - 1);
+
+            for (int y = startY; y <= endY; y++)
+            {
+                for (int x = startX; x <= endX; x++)
+                {
+                    if (chunk->flags[getTileSlot(x, y, chunkX, chunkY)] & TILE_SOLID)
+                    {
+                        results.push_back(GetTileBounds(tilemap, origin, x, y));
+                    }
+                }
+            }
+        }
+    }
+}
+
+void Tilemap::AppendCollisionSources(const TilemapComponent& tilemap, Entity entity, std::string const& id, const myMath::Vector2D& origin, std::vector<StaticCollisionWorld::Source>& sources)
+{
+    myMath::Vector2D tileScale(tilemap.tileSize, tilemap.tileSize);
+
+    for (auto const& chunk : tilemap.chunks)
+    {
+        for (int slot = 0; slot < TILEMAP_CHUNK_TILES; slot++)
+        {
+            if (!(chunk.flags[slot] & TILE_SOLID))
+            {
+                continue;
+            }
+
+            int x = chunk.chunkX * TILEMAP_CHUNK_SIZE + slot % TILEMAP_CHUNK_SIZE;
+            int y = chunk.chunkY * TILEMAP_CHUNK_SIZE + slot / TILEMAP_CHUNK_SIZE;
+            SpatialGrid::Bounds bounds = GetTileBounds(tilemap, origin, x, y);
+            sources.push_back({ entity, (bounds.min + bounds.max) * 0.5f, tileScale, 0.f, id });
+        }
+    }
+}
+
+uint64_t Tilemap::GetCollisionHash(TilemapComponent& tilemap)
+{
+    if (tilemap.collisionHashValid)
+    {
+        return tilemap.collisionHash;
+    }
+
+    // Same hash as the static collision fingerprint the result is folded into
+    uint64_t hash = StaticCollisionWorld::computeFingerprint({});
+    uint8_t solid[TILEMAP_CHUNK_TILES];
+
+    for (auto const& chunk : tilemap.chunks)
+    {
+        for (int slot = 0; slot < TILEMAP_CHUNK_TILES; slot++)
+        {
+            solid[slot] = chunk.flags[slot] & TILE_SOLID;
+        }
+
+        hash = StaticCollisionWorld::mixFingerprint(hash, &chunk.chunkX, sizeof(chunk.chunkX));
+        hash = StaticCollisionWorld::mixFingerprint(hash, &chunk.chunkY, sizeof(chunk.chunkY));
+        hash = StaticCollisionWorld::mixFingerprint(hash, solid, sizeof(solid));
+    }
+
+    tilemap.collisionHash = hash;
+    tilemap.collisionHashValid = true;
+    return hash;
+}
+
+// Tileset cells are counted from the top left of the texture
+void Tilemap::BuildChunkMesh(const TilemapComponent& tilemap, const TileChunk& chunk, ChunkMesh& mesh)
+{
+    mesh.positions.clear();
+    mesh.uvs.clear();
+    mesh.indices.clear();
+
+    int columns = std::max(tilemap.tilesetColumns, 1);
+    int rows = std::max(tilemap.tilesetRows, 1);
+
+    for (int slot = 0; slot < TILEMAP_CHUNK_TILES; slot++)
+    {
+        uint16_t tile = chunk.tiles[slot];
+        if (tile == 0)
+        {
+            continue;
+        }
+
+        float left = (chunk.chunkX * TILEMAP_CHUNK_SIZE + slot % TILEMAP_CHUNK_SIZE) * tilemap.tileSize;
+        float bottom = (chunk.chunkY * TILEMAP_CHUNK_SIZE + slot / TILEMAP_CHUNK_SIZE) * tilemap.tileSize;
+        float right = left + tilemap.tileSize;
+        float top = bottom + tilemap.tileSize;
+
+        int cell = tile - 1;
+        float u0 = static_cast<float>(cell % columns) / columns;
+        float u1 = static_cast<float>(cell % columns + 1) / columns;
+        float v1 = 1.f - static_cast<float>(cell / columns) / rows;
+        float v0 = 1.f - static_cast<float>(cell / columns + 1) / rows;
+
+        unsigned int first = static_cast<unsigned int>(mesh.positions.size() / 3);
+
+        // Same corner order and winding as the sprite quad
+        float positions[] = { right, top, 1.f,  right, bottom, 1.f,  left, bottom, 1.f,  left, top, 1.f };
+        float uvs[] = { u1, v1,  u1, v0,  u0, v0,  u0, v1 };
+        unsigned int indices[] = { first, first + 1, first + 3, first + 1, first + 2, first + 3 };
+
+        mesh.positions.insert(mesh.positions.end(), std::begin(positions), std::end(positions));
+        mesh.uvs.insert(mesh.uvs.end(), std::begin(uvs), std::end(uvs));
+        mesh.indices.insert(mesh.indices.end(), std::begin(indices), std::end(indices));
+    }
+}
@@ -0,0 +1,66 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   Tilemap.h
+@brief:  This header file contains the declaration of the Tilemap class, the
+         functions used to read and edit a TilemapComponent. Tiles are looked
+         up by grid coordinates, so collision queries only visit the tiles
+         under the region asked about, and solid tiles are handed to the
+         physics system's static collision bake instead of existing as
+         platform entities.
+         Lee Jing Wen (jingwen.lee): Declared the Tilemap class
+                                     100%
+*//*____________________________________________________________________________-*/
+#pragma once
+#include "ECSDefinitions.h"
+#include "TilemapComponent.h"
+#include "StaticCollisionWorld.h"
+#include "SpatialGrid.h"
+#include "vector2D.h"
+#include <vector>
+
+class Tilemap
+{
+public:
+    // Vertex data for one chunk, positions relative to the tilemap origin
+    struct ChunkMesh {
+        std::vector<float> positions;   // x, y, 1 per vertex
+        std::vector<float> uvs;
+        std::vector<unsigned int> indices;
+    };
+
+    static uint64_t getChunkKey(int chunkX, int chunkY);
+
+    static TileChunk* FindChunk(TilemapComponent& tilemap, int chunkX, int chunkY);
+    static const TileChunk* FindChunk(const TilemapComponent& tilemap, int chunkX, int chunkY);
+    static TileChunk& GetOrCreateChunk(TilemapComponent& tilemap, int chunkX, int chunkY);
+
+    // Setting an empty tile in a missing chunk does not create the chunk
+    static void SetTile(TilemapComponent& tilemap, int x, int y, uint16_t tile, uint8_t flags);
+    static uint16_t GetTile(const TilemapComponent& tilemap, int x, int y);
+    static uint8_t GetFlags(const TilemapComponent& tilemap, int x, int y);
+    static bool IsSolid(const TilemapComponent& tilemap, int x, int y);
+
+    // Tile holding a world point
+    static void WorldToTile(const TilemapComponent& tilemap, const myMath::Vector2D& origin, const myMath::Vector2D& point, int& x, int& y);
+    static SpatialGrid::Bounds GetTileBounds(const TilemapComponent& tilemap, const myMath::Vector2D& origin, int x, int y);
+    static SpatialGrid::Bounds GetChunkBounds(const TilemapComponent& tilemap, const myMath::Vector2D& origin, int chunkX, int chunkY);
+
+    static bool IsSolidAt(const TilemapComponent& tilemap, const myMath::Vector2D& origin, const myMath::Vector2D& point);
+
+    // Bounds of every solid tile overlapping the region
+    static void QuerySolidTiles(const TilemapComponent& tilemap, const myMath::Vector2D& origin, const SpatialGrid::Bounds& region, std::vector<SpatialGrid::Bounds>& results);
+
+    // One source per solid tile, for StaticCollisionWorld to merge. id is the
+    // tilemap entity's saved id
+    static void AppendCollisionSources(const TilemapComponent& tilemap, Entity entity, std::string const& id, const myMath::Vector2D& origin, std::vector<StaticCollisionWorld::Source>& sources);
+
+    static uint64_t GetCollisionHash(TilemapComponent& tilemap);
+
+    static void BuildChunkMesh(const TilemapComponent& tilemap, const TileChunk& chunk, ChunkMesh& mesh);
+
+private:
+    static uint64_t nextRevision;
+};
@@ -0,0 +1,133 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   WorkerPool.cpp
+@brief:  This source file contains the implementation of the WorkerPool class.
+         Lee Jing Wen (jingwen.lee): Defined the WorkerPool class
+                                     100%
+*//*____________________________________________________________________________-*/
+
+#include "WorkerPool.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(size_t workerCount) : currentJob(nullptr), jobCount(0), chunkSize(1), nextItem(0),
+    pendingWorkers(0), generation(0), stopping(false)
+{
+    resize(workerCount);
+}
+
+WorkerPool::~WorkerPool()
+{
+    stopThreads();
+}
+
+void WorkerPool::resize(size_t workerCount)
+{
+    if (workerCount == 0)
+    {
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    if (workerCount == getWorkerCount())
+    {
+        return;
+    }
+
+    stopThreads();
+
+    stopping = false;
+    for (size_t worker = 1; worker < workerCount; worker++)
+    {
+        threads.emplace_back(&WorkerPool::workerLoop, this, worker, generation);
+    }
+}
+
+void WorkerPool::stopThreads()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wakeCondition.notify_all();
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    threads.clear();
+}
+
+// Chunks are handed out from a shared counter, so a worker that finishes
+// early keeps taking work instead of waiting on a fixed share
+void WorkerPool::parallelFor(size_t count, size_t minChunk, const Job& job)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    minChunk = std::max<size_t>(minChunk, 1);
+    if (threads.empty() || count <= minChunk)
+    {
+        job(0, count, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentJob = &job;
+        jobCount = count;
+        chunkSize = std::max(minChunk, (count + getWorkerCount() * 4 - 1) / (getWorkerCount() * 4));
+        nextItem = 0;
+        pendingWorkers = threads.size();
+        generation++;
+    }
+    wakeCondition.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    doneCondition.wait(lock, [this] { return pendingWorkers == 0; });
+    currentJob = nullptr;
+}
+
+void WorkerPool::runChunks(size_t worker)
+{
+    for (;;)
+    {
+        size_t begin = nextItem.fetch_add(chunkSize);
+        if (begin >= jobCount)
+        {
+            return;
+        }
+        (*currentJob)(begin, std::min(begin + chunkSize, jobCount), worker);
+    }
+}
+
+// A worker starts out having seen the current generation, so it only picks up
+// jobs posted after it was created
+void WorkerPool::workerLoop(size_t worker, uint64_t seenGeneration)
+{
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wakeCondition.wait(lock, [this, seenGeneration] { return stopping || generation != seenGeneration; });
+            if (stopping)
+            {
+                return;
+            }
+            seenGeneration = generation;
+        }
+
+        runChunks(worker);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pendingWorkers == 0)
+        {
+            doneCondition.notify_one();
+        }
+    }
+}
@@ -0,0 +1,63 @@
+/*!
+All content @ 2024 DigiPen Institute of Technology Singapore, all rights reserved.
+@author: Lee Jing Wen (jingwen.lee)
+@team:   MonkeHood
+@course: CSD2401
+@file:   WorkerPool.h
+@brief:  This header file contains the declaration of the WorkerPool class, a
+         fixed set of worker threads that the physics system splits its
+         narrowphase and island solving across. The threads are kept alive
+         between steps and sleep on a condition variable while idle.
+         Lee Jing Wen (jingwen.lee): Declared the WorkerPool class
+                                     100%
+*//*____________________________________________________________________________-*/
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkerPool
+{
+public:
+    // Work on the items [begin, end), worker is 0 for the calling thread and
+    // 1 to getWorkerCount() - 1 for the pool threads
+    using Job = std::function<void(size_t begin, size_t end, size_t worker)>;
+
+    explicit WorkerPool(size_t workerCount = 1);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Workers including the calling thread, 0 picks one per hardware thread
+    void resize(size_t workerCount);
+    size_t getWorkerCount() const { return threads.size() + 1; }
+
+    // Split [0, count) into chunks of at least minChunk items and run them on
+    // every worker, the calling thread included. Returns once all are done.
+    // Which worker gets which chunk is not fixed, so jobs must only write to
+    // per-item or per-worker memory
+    void parallelFor(size_t count, size_t minChunk, const Job& job);
+
+private:
+    void workerLoop(size_t worker, uint64_t seenGeneration);
+    void runChunks(size_t worker);
+    void stopThreads();
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wakeCondition;
+    std::condition_variable doneCondition;
+
+    const Job* currentJob;
+    size_t jobCount;
+    size_t chunkSize;
+    std::atomic<size_t> nextItem;
+    size_t pendingWorkers;
+    uint64_t generation;
+    bool stopping;
+};